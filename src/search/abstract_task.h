@@ -100,6 +100,14 @@ public:
     */
     virtual void convert_ancestor_state_values(
         std::vector<int> &values, const AbstractTask *ancestor_task) const = 0;
+    /*
+      Return false if convert_ancestor_state_values leaves all state values
+      from the given ancestor task unchanged. In this case, states of the
+      ancestor task can be used in this task without unpacking or copying
+      their data.
+    */
+    virtual bool does_convert_ancestor_state_values(
+        const AbstractTask *ancestor_task) const = 0;
 };
 
 #endif
@@ -59,6 +59,10 @@ public:
         return (buffer[bin_index] & read_mask) >> shift;
     }
 
+    VariableLocation get_location() const {
+        return {bin_index, shift, read_mask};
+    }
+
     void set(Bin *buffer, int value) const {
         assert(value >= 0 && value < range);
         Bin &bin = buffer[bin_index];
@@ -81,6 +85,10 @@ void IntPacker::set(Bin *buffer, int var, int value) const {
     var_infos[var].set(buffer, value);
 }
 
+IntPacker::VariableLocation IntPacker::get_location(int var) const {
+    return var_infos[var].get_location();
+}
+
 void IntPacker::pack_bins(const vector<int> &ranges) {
     assert(var_infos.empty());
 
@@ -31,6 +31,17 @@ class IntPacker {
 public:
     typedef unsigned int Bin;
 
+    /*
+      Location of a variable in the packed data: the value of the variable
+      is (buffer[bin_index] & read_mask) >> shift. This allows code that
+      reads many values in a hot loop to inline the accesses.
+    */
+    struct VariableLocation {
+        int bin_index;
+        int shift;
+        Bin read_mask;
+    };
+
     /*
       The constructor takes the range for each variable. The domain of
       variable i is {0, ..., ranges[i] - 1}. Because we are using signed
@@ -43,6 +54,8 @@ public:
     int get(const Bin *buffer, int var) const;
     void set(Bin *buffer, int var, int value) const;
 
+    VariableLocation get_location(int var) const;
+
     int get_num_bins() const {
         return num_bins;
     }
@@ -0,0 +1,91 @@
+#ifndef ALGORITHMS_MPSC_QUEUE_H
+#define ALGORITHMS_MPSC_QUEUE_H
+
+#include <atomic>
+#include <cassert>
+#include <utility>
+
+/*
+  MPSCQueue is an unbounded lock-free FIFO queue that supports any number of
+  concurrent producers but only a single consumer. Producers never block each
+  other: a push is a single atomic exchange plus a store. Only the thread that
+  owns the queue may call pop() and empty().
+
+  The implementation follows the non-intrusive queue by Dmitry Vyukov. The
+  queue always contains a "stub" node whose value has already been consumed.
+  Popping moves the value out of the successor of the stub and turns this
+  successor into the new stub. Hence, T has to be default-constructible and
+  movable.
+
+  Each push allocates one node, so producers should prefer pushing batches
+  of data over pushing many small entries.
+*/
+
+namespace mpsc_queue {
+template<typename T>
+class MPSCQueue {
+    struct Node {
+        std::atomic<Node *> next;
+        T value;
+
+        Node() : next(nullptr) {
+        }
+
+        explicit Node(T &&value) : next(nullptr), value(std::move(value)) {
+        }
+    };
+
+    // Producers append at the head...
+    std::atomic<Node *> head;
+    // ...and the consumer removes from the tail (which is the stub node).
+    Node *tail;
+
+public:
+    MPSCQueue() {
+        Node *stub = new Node();
+        head.store(stub, std::memory_order_relaxed);
+        tail = stub;
+    }
+
+    MPSCQueue(const MPSCQueue &) = delete;
+    MPSCQueue &operator=(const MPSCQueue &) = delete;
+
+    ~MPSCQueue() {
+        T value;
+        while (pop(value)) {
+        }
+        delete tail;
+    }
+
+    // May be called concurrently from any number of threads.
+    void push(T &&value) {
+        Node *node = new Node(std::move(value));
+        Node *prev = head.exchange(node, std::memory_order_acq_rel);
+        /*
+          Between the exchange and the following store, the queue is
+          temporarily disconnected. The consumer then sees the queue as
+          empty until the store becomes visible, which is harmless.
+        */
+        prev->next.store(node, std::memory_order_release);
+    }
+
+    // Must only be called by the consumer thread.
+    bool pop(T &value) {
+        Node *next = tail->next.load(std::memory_order_acquire);
+        if (!next) {
+            return false;
+        }
+        value = std::move(next->value);
+        delete tail;
+        tail = next;
+        return true;
+    }
+
+    // Must only be called by the consumer thread.
+    bool empty() const {
+        return tail->next.load(std::memory_order_acquire) == nullptr;
+    }
+};
+}
+
+#endif
@@ -0,0 +1,50 @@
+#include "priority_queues.h"
+
+#include "../utils/system.h"
+
+#include <atomic>
+#include <fstream>
+#include <mutex>
+
+using namespace std;
+
+namespace priority_queues {
+LargeKeyQueueType g_large_key_queue_type = LargeKeyQueueType::HEAP;
+
+static ofstream trace_file;
+static mutex trace_file_mutex;
+static atomic<bool> recording(false);
+static atomic<int> next_queue_id(0);
+
+QueueTraceRecorder::QueueTraceRecorder() : queue_id(next_queue_id++) {
+}
+
+QueueTraceRecorder::~QueueTraceRecorder() {
+    flush();
+}
+
+void QueueTraceRecorder::flush() {
+    if (operations.empty())
+        return;
+    lock_guard<mutex> lock(trace_file_mutex);
+    trace_file << queue_id << " " << operations.size();
+    for (int operation : operations)
+        trace_file << " " << operation;
+    trace_file << "\n";
+    operations.clear();
+}
+
+void QueueTraceRecorder::start_recording(const string &filename) {
+    lock_guard<mutex> lock(trace_file_mutex);
+    trace_file.open(filename);
+    if (!trace_file) {
+        cerr << "Could not open queue trace file " << filename << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
+    }
+    recording = true;
+}
+
+bool QueueTraceRecorder::is_recording() {
+    return recording;
+}
+}
@@ -2,24 +2,34 @@
 #define ALGORITHMS_PRIORITY_QUEUES_H
 
 #include "../utils/collections.h"
+#include "../utils/language.h"
 #include "../utils/logging.h"
 
+#include <algorithm>
+#include <bit>
 #include <cassert>
 #include <iostream>
 #include <limits>
+#include <memory>
 #include <queue>
+#include <string>
 #include <utility>
 #include <vector>
 
 /*
-  We define three priority queue classes here: HeapQueue (heap-based),
-  BucketQueue (bucket-based), and AdaptiveQueue (starts out bucket-based,
-  transforms into heap-based if that seems to make sense).
+  We define four priority queue classes here: HeapQueue (heap-based),
+  BucketQueue (bucket-based), RadixHeapQueue (radix heap for monotone
+  keys) and AdaptiveQueue (starts out bucket-based, transforms into
+  heap-based or radix-heap-based if that seems to make sense).
 
   More precisely, an AdaptiveQueue is converted from a BucketQueue to
   a HeapQueue when the number of required buckets exceeds both
   BucketQueue::MIN_BUCKETS_BEFORE_SWITCH and the total number of
   pushes to the queue since it was last clear()ed or constructed.
+  If g_large_key_queue_type is RADIX_HEAP, it is converted to a
+  RadixHeapQueue instead. A RadixHeapQueue is in turn converted to a
+  HeapQueue as soon as a key is pushed that is smaller than the last
+  popped key.
 
   Note: AdaptiveQueue does not derive from AbstractQueue since this is
   currently not necessary, and by not deriving we can save virtual
@@ -28,6 +38,49 @@
   different implementations in and out.
  */
 namespace priority_queues {
+enum class LargeKeyQueueType {
+    HEAP,
+    RADIX_HEAP
+};
+
+// Queue type to which AdaptiveQueues convert by default.
+extern LargeKeyQueueType g_large_key_queue_type;
+
+/*
+  Records the operations on an AdaptiveQueue to the trace file set with
+  start_recording, so that they can be replayed with different queue
+  implementations (see priority_queue_benchmark). Operations are buffered
+  and written in chunks, each prefixed by the ID of the queue, so that
+  recording works with queues of several threads.
+
+  Recording is only compiled in with the CMake option RECORD_QUEUE_TRACES,
+  so that the queues of other builds do not pay for it.
+*/
+class QueueTraceRecorder {
+    const int queue_id;
+    std::vector<int> operations;
+
+    void flush();
+public:
+    // Operations with non-negative codes push the respective key.
+    static const int POP = -1;
+    static const int CLEAR = -2;
+    // The next operation is the number of virtual pushes.
+    static const int ADD_VIRTUAL_PUSHES = -3;
+
+    QueueTraceRecorder();
+    ~QueueTraceRecorder();
+
+    void record(int operation) {
+        operations.push_back(operation);
+        if (operations.size() >= 65536)
+            flush();
+    }
+
+    static void start_recording(const std::string &filename);
+    static bool is_recording();
+};
+
 template<typename Value>
 class AbstractQueue {
 public:
@@ -128,6 +181,143 @@ public:
         return result;
     }
 
+    static HeapQueue<Value> *create_from_entries_destructively(
+        std::vector<Entry> &entries) {
+        // Like above, but the entries may be in any order.
+        HeapQueue<Value> *result = new HeapQueue<Value>;
+        result->heap.c.swap(entries);
+        std::make_heap(
+            result->heap.c.begin(), result->heap.c.end(), compare_func());
+        return result;
+    }
+
+    virtual void add_virtual_pushes(int /*num_extra_pushes*/) {
+    }
+};
+
+/*
+  Radix heap (Ahuja et al., "Faster Algorithms for the Shortest Path
+  Problem", JACM 1990) for monotone keys, i.e., keys that are never smaller
+  than the last popped key. In contrast to BucketQueue, the memory does not
+  depend on the size of the keys, and in contrast to HeapQueue, every entry
+  is moved at most once per bit of the key range instead of being sifted
+  on every operation.
+
+  bucket[0] contains the entries whose key equals last_key. For i > 0,
+  bucket[i] contains the entries whose key first differs from last_key in
+  bit i - 1, counted from the least significant bit. When bucket[0] is
+  empty, pop() finds the first non-empty bucket, sets last_key to its
+  minimum key and distributes its entries among the lower buckets.
+
+  Pushing a key that is smaller than last_key is not allowed. The queue
+  converts itself into a HeapQueue in that case (see convert_if_necessary).
+*/
+template<typename Value>
+class RadixHeapQueue : public AbstractQueue<Value> {
+    typedef typename AbstractQueue<Value>::Entry Entry;
+    static const int NUM_BUCKETS = std::numeric_limits<int>::digits + 1;
+
+    std::vector<std::vector<Entry>> buckets;
+    int last_key;
+    int num_entries;
+
+    bool is_valid_key(int key) const {
+        int infinity = std::numeric_limits<int>::max();
+        return key >= 0 && key != infinity;
+    }
+
+    int get_bucket_index(int key) const {
+        assert(key >= last_key);
+        return std::bit_width(static_cast<unsigned int>(key ^ last_key));
+    }
+
+    void extract_entries(std::vector<Entry> &result) {
+        // Remove all entries from this queue and append them to result.
+        result.reserve(result.size() + num_entries);
+        for (std::vector<Entry> &bucket : buckets) {
+            result.insert(result.end(), bucket.begin(), bucket.end());
+            utils::release_vector_memory(bucket);
+        }
+        num_entries = 0;
+    }
+public:
+    RadixHeapQueue() : buckets(NUM_BUCKETS), last_key(0), num_entries(0) {
+    }
+
+    virtual ~RadixHeapQueue() {
+    }
+
+    virtual void push(int key, const Value &value) {
+        assert(is_valid_key(key));
+        if (num_entries == 0)
+            last_key = key;
+        ++num_entries;
+        buckets[get_bucket_index(key)].emplace_back(key, value);
+    }
+
+    virtual Entry pop() {
+        assert(num_entries > 0);
+        --num_entries;
+        if (buckets[0].empty()) {
+            int bucket_no = 1;
+            while (buckets[bucket_no].empty())
+                ++bucket_no;
+            std::vector<Entry> &bucket = buckets[bucket_no];
+            last_key = std::min_element(
+                           bucket.begin(), bucket.end(),
+                           [](const Entry &lhs, const Entry &rhs) {
+                               return lhs.first < rhs.first;
+                           })
+                           ->first;
+            for (const Entry &entry : bucket) {
+                assert(get_bucket_index(entry.first) < bucket_no);
+                buckets[get_bucket_index(entry.first)].push_back(entry);
+            }
+            bucket.clear();
+        }
+        Entry result = buckets[0].back();
+        buckets[0].pop_back();
+        return result;
+    }
+
+    virtual bool empty() const {
+        return num_entries == 0;
+    }
+
+    virtual void clear() {
+        for (std::vector<Entry> &bucket : buckets)
+            bucket.clear();
+        last_key = 0;
+        num_entries = 0;
+    }
+
+    static RadixHeapQueue<Value> *create_from_entries_destructively(
+        std::vector<Entry> &entries, int min_key) {
+        // Create a new radix heap from the entries, whose keys must all be
+        // at least min_key. The passed-in vector is cleared as a side effect.
+        RadixHeapQueue<Value> *result = new RadixHeapQueue<Value>;
+        result->last_key = min_key;
+        for (const Entry &entry : entries) {
+            assert(entry.first >= min_key);
+            result->buckets[result->get_bucket_index(entry.first)].push_back(
+                entry);
+        }
+        result->num_entries = entries.size();
+        utils::release_vector_memory(entries);
+        return result;
+    }
+
+    virtual AbstractQueue<Value> *convert_if_necessary(int key) {
+        assert(is_valid_key(key));
+        if (key < last_key && num_entries != 0) {
+            std::vector<Entry> entries;
+            extract_entries(entries);
+            return HeapQueue<Value>::create_from_entries_destructively(
+                entries);
+        }
+        return this;
+    }
+
     virtual void add_virtual_pushes(int /*num_extra_pushes*/) {
     }
 };
@@ -144,6 +334,7 @@ class BucketQueue : public AbstractQueue<Value> {
     mutable int current_bucket_no;
     int num_entries;
     int num_pushes;
+    LargeKeyQueueType large_key_queue_type;
 
     bool is_valid_key(int key) const {
         int infinity = std::numeric_limits<int>::max();
@@ -173,7 +364,12 @@ class BucketQueue : public AbstractQueue<Value> {
         current_bucket_no = 0;
     }
 public:
-    BucketQueue() : current_bucket_no(0), num_entries(0), num_pushes(0) {
+    explicit BucketQueue(
+        LargeKeyQueueType large_key_queue_type = LargeKeyQueueType::HEAP)
+        : current_bucket_no(0),
+          num_entries(0),
+          num_pushes(0),
+          large_key_queue_type(large_key_queue_type) {
     }
 
     virtual ~BucketQueue() {
@@ -223,12 +419,23 @@ public:
         assert(is_valid_key(key));
         if (key >= MIN_BUCKETS_BEFORE_SWITCH && key > num_pushes) {
             if (DEBUG) {
-                utils::g_log << "Switch from bucket-based to heap-based queue "
-                             << "at key = " << key
+                utils::g_log << "Switch from bucket-based to "
+                             << (large_key_queue_type ==
+                                         LargeKeyQueueType::HEAP
+                                     ? "heap-based"
+                                     : "radix-heap-based")
+                             << " queue at key = " << key
                              << ", num_pushes = " << num_pushes << std::endl;
             }
             std::vector<Entry> entries;
             extract_sorted_entries(entries);
+            if (large_key_queue_type == LargeKeyQueueType::RADIX_HEAP) {
+                int min_key = entries.empty()
+                                  ? key
+                                  : std::min(entries.front().first, key);
+                return RadixHeapQueue<Value>::create_from_entries_destructively(
+                    entries, min_key);
+            }
             return HeapQueue<Value>::create_from_sorted_entries_destructively(
                 entries);
         }
@@ -243,13 +450,31 @@ public:
 template<typename Value>
 class AdaptiveQueue {
     AbstractQueue<Value> *wrapped_queue;
+#ifdef RECORD_QUEUE_TRACES
+    std::unique_ptr<QueueTraceRecorder> recorder;
+#endif
     // Forbid assigning or copying -- would need to implement them properly.
     AdaptiveQueue &operator=(const AdaptiveQueue<Value> &);
     AdaptiveQueue(const AdaptiveQueue<Value> &);
+
+    void record(int operation) {
+#ifdef RECORD_QUEUE_TRACES
+        if (recorder)
+            recorder->record(operation);
+#else
+        utils::unused_variable(operation);
+#endif
+    }
 public:
     typedef std::pair<int, Value> Entry;
 
-    AdaptiveQueue() : wrapped_queue(new BucketQueue<Value>) {
+    explicit AdaptiveQueue(
+        LargeKeyQueueType large_key_queue_type = g_large_key_queue_type)
+        : wrapped_queue(new BucketQueue<Value>(large_key_queue_type)) {
+#ifdef RECORD_QUEUE_TRACES
+        if (QueueTraceRecorder::is_recording())
+            recorder = std::make_unique<QueueTraceRecorder>();
+#endif
     }
 
     ~AdaptiveQueue() {
@@ -257,6 +482,7 @@ public:
     }
 
     void push(int key, const Value &value) {
+        record(key);
         AbstractQueue<Value> *q = wrapped_queue->convert_if_necessary(key);
         if (q != wrapped_queue) {
             delete wrapped_queue;
@@ -266,6 +492,7 @@ public:
     }
 
     Entry pop() {
+        record(QueueTraceRecorder::POP);
         return wrapped_queue->pop();
     }
 
@@ -274,10 +501,13 @@ public:
     }
 
     void clear() {
+        record(QueueTraceRecorder::CLEAR);
         wrapped_queue->clear();
     }
 
     void add_virtual_pushes(int num_extra_pushes) {
+        record(QueueTraceRecorder::ADD_VIRTUAL_PUSHES);
+        record(num_extra_pushes);
         wrapped_queue->add_virtual_pushes(num_extra_pushes);
     }
 };
@@ -20,7 +20,8 @@ SplitSelector::SplitSelector(
     if (pick == PickSplit::MIN_HADD || pick == PickSplit::MAX_HADD) {
         additive_heuristic = make_unique<additive_heuristic::AdditiveHeuristic>(
             task, tasks::AxiomHandlingType::APPROXIMATE_NEGATIVE, false,
-            "h^add within CEGAR abstractions", utils::Verbosity::SILENT);
+            false, false, "h^add within CEGAR abstractions",
+            utils::Verbosity::SILENT);
         additive_heuristic->compute_heuristic_for_cegar(
             task_proxy.get_initial_state());
     }
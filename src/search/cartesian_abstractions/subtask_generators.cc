@@ -36,7 +36,8 @@ public:
         const shared_ptr<AbstractTask> &task)
         : hadd(make_unique<additive_heuristic::AdditiveHeuristic>(
               task, tasks::AxiomHandlingType::APPROXIMATE_NEGATIVE, false,
-              "h^add within CEGAR abstractions", utils::Verbosity::SILENT)) {
+              false, false, "h^add within CEGAR abstractions",
+              utils::Verbosity::SILENT)) {
         TaskProxy task_proxy(*task);
         hadd->compute_heuristic_for_cegar(task_proxy.get_initial_state());
     }
@@ -27,6 +27,14 @@ option USE_LP to false."
             "not supported when an LP solver is used. See issue982 for details.")
     endif()
 
+    option(
+        RECORD_QUEUE_TRACES
+        "Compile support for recording the operations on adaptive priority \
+queues (option --record-queue-trace) for the priority queue benchmark. \
+This costs time on every queue operation, so only enable it in builds \
+that record traces."
+        FALSE)
+
     option(
         DISABLE_LIBRARIES_BY_DEFAULT
         "If set to YES only libraries that are specifically enabled will be compiled"
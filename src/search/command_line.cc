@@ -4,15 +4,21 @@
 #include "plan_manager.h"
 #include "search_algorithm.h"
 
+#include "algorithms/priority_queues.h"
+
 #include "parser/lexical_analyzer.h"
 #include "parser/syntax_analyzer.h"
 #include "plugins/any.h"
 #include "plugins/doc_printer.h"
 #include "plugins/plugin.h"
+#include "task_utils/successor_generator.h"
+#include "utils/disk_cache.h"
 #include "utils/logging.h"
+#include "utils/parallel.h"
 #include "utils/strings.h"
 
 #include <algorithm>
+#include <filesystem>
 #include <sstream>
 #include <vector>
 
@@ -144,6 +150,76 @@ static ParsedSearchOptions parse_cmd_line_aux(const vector<string> &args) {
             }
             cout << "Help output finished." << endl;
             exit(0);
+        } else if (arg == "--successor-generator") {
+            if (is_last)
+                input_error("missing argument after --successor-generator");
+            ++i;
+            const string &type = args[i];
+            if (type == "tree") {
+                successor_generator::g_successor_generator_type =
+                    successor_generator::SuccessorGeneratorType::TREE;
+            } else if (type == "flat") {
+                successor_generator::g_successor_generator_type =
+                    successor_generator::SuccessorGeneratorType::FLAT;
+            } else if (type == "bitset") {
+                successor_generator::g_successor_generator_type =
+                    successor_generator::SuccessorGeneratorType::BITSET;
+            } else {
+                input_error("unknown successor generator type " + type);
+            }
+        } else if (arg == "--large-key-queue") {
+            if (is_last)
+                input_error("missing argument after --large-key-queue");
+            ++i;
+            const string &type = args[i];
+            if (type == "heap") {
+                priority_queues::g_large_key_queue_type =
+                    priority_queues::LargeKeyQueueType::HEAP;
+            } else if (type == "radix_heap") {
+                priority_queues::g_large_key_queue_type =
+                    priority_queues::LargeKeyQueueType::RADIX_HEAP;
+            } else {
+                input_error("unknown queue type " + type);
+            }
+        } else if (arg == "--preprocessing-threads") {
+            if (is_last)
+                input_error("missing argument after --preprocessing-threads");
+            ++i;
+            int num_threads = parse_int_arg(arg, args[i]);
+            if (num_threads < 1)
+                input_error("argument for " + arg + " must be positive");
+            utils::g_num_preprocessing_threads = num_threads;
+        } else if (arg == "--parallel-pdb-distances") {
+            utils::g_parallel_pdb_distances = true;
+        } else if (arg == "--cache-directory") {
+            if (is_last)
+                input_error("missing argument after --cache-directory");
+            ++i;
+            error_code error;
+            filesystem::create_directories(args[i], error);
+            if (error)
+                input_error(
+                    "cannot create cache directory " + args[i] + ": " +
+                    error.message());
+            utils::g_cache_directory = args[i];
+        } else if (arg == "--cache-size-limit") {
+            if (is_last)
+                input_error("missing argument after --cache-size-limit");
+            ++i;
+            int limit_in_mib = parse_int_arg(arg, args[i]);
+            if (limit_in_mib < 0)
+                input_error("argument for " + arg + " must be non-negative");
+            utils::g_cache_size_limit = int64_t(limit_in_mib) << 20;
+        } else if (arg == "--record-queue-trace") {
+            if (is_last)
+                input_error("missing argument after --record-queue-trace");
+            ++i;
+#ifndef RECORD_QUEUE_TRACES
+            input_error(
+                "--record-queue-trace requires a build with the CMake "
+                "option RECORD_QUEUE_TRACES");
+#endif
+            priority_queues::QueueTraceRecorder::start_recording(args[i]);
         } else if (arg == "--internal-plan-file") {
             if (is_last)
                 input_error("missing argument after --internal-plan-file");
@@ -201,6 +277,39 @@ string get_usage(const string &progname) {
            "--help [NAME]\n"
            "    Print help for all heuristics, open lists, etc. called NAME.\n"
            "    Without parameter: print help for everything available\n"
+           "--successor-generator {tree,flat,bitset}\n"
+           "    Representation of the successor generator (default: flat).\n"
+           "    flat compiles the decision tree into compact byte code,\n"
+           "    bitset matches preconditions of all operators bit-parallel.\n"
+           "--large-key-queue {heap,radix_heap}\n"
+           "    Queue to which the adaptive priority queues of heuristics and\n"
+           "    abstractions switch when the keys become too large for a\n"
+           "    bucket queue (default: heap). Both pop entries with equal\n"
+           "    keys in different orders.\n"
+           "--preprocessing-threads N\n"
+           "    Number of threads for precomputations of heuristics, e.g.,\n"
+           "    for computing several pattern databases (default: 1).\n"
+           "    The results do not depend on the number of threads.\n"
+           "--parallel-pdb-distances\n"
+           "    Also compute the distances of each large pattern database\n"
+           "    with all preprocessing threads. This is experimental and off\n"
+           "    by default because it has not been shown to be faster than\n"
+           "    the sequential computation.\n"
+           "--cache-directory DIR\n"
+           "    Directory for data that is cached between planner runs, e.g.,\n"
+           "    pattern databases with at least 100000 abstract states\n"
+           "    (default: no caching). It is created if it does not exist and\n"
+           "    can be shared by concurrent runs. Cached files are never\n"
+           "    deleted by the planner. To clean the cache, delete the\n"
+           "    directory or the files in it. This is safe even while\n"
+           "    planners use it: files in use are only removed once closed.\n"
+           "--cache-size-limit MIB\n"
+           "    Do not add files to the cache directory once its files take\n"
+           "    more than MIB mebibytes (default: 4096).\n"
+           "--record-queue-trace FILENAME\n"
+           "    Write the operations on all adaptive priority queues to\n"
+           "    FILENAME for priority_queue_benchmark(). Only available in\n"
+           "    builds with the CMake option RECORD_QUEUE_TRACES.\n"
            "--internal-git-revision\n"
            "    Print the revision of the code used to build this binary.\n"
            "--internal-plan-file FILENAME\n"
@@ -42,18 +42,42 @@ EvaluationContext::EvaluationContext(
           calculate_preferred) {
 }
 
+void EvaluationContext::store_result(
+    Evaluator *evaluator, EvaluationResult &&result) {
+    if (statistics && evaluator->is_used_for_counting_evaluations() &&
+        result.get_count_evaluation()) {
+        statistics->inc_evaluations();
+    }
+    cache[evaluator] = move(result);
+}
+
 const EvaluationResult &EvaluationContext::get_result(Evaluator *evaluator) {
     EvaluationResult &result = cache[evaluator];
     if (result.is_uninitialized()) {
-        result = evaluator->compute_result(*this);
-        if (statistics && evaluator->is_used_for_counting_evaluations() &&
-            result.get_count_evaluation()) {
-            statistics->inc_evaluations();
-        }
+        store_result(evaluator, evaluator->compute_result(*this));
     }
     return result;
 }
 
+void EvaluationContext::evaluate_batch(
+    Evaluator *evaluator, const vector<EvaluationContext *> &eval_contexts) {
+    vector<EvaluationContext *> pending;
+    pending.reserve(eval_contexts.size());
+    for (EvaluationContext *eval_context : eval_contexts) {
+        if (eval_context->cache[evaluator].is_uninitialized())
+            pending.push_back(eval_context);
+    }
+    if (pending.empty())
+        return;
+
+    vector<EvaluationResult> results;
+    evaluator->compute_results(pending, results);
+    assert(results.size() == pending.size());
+    for (size_t i = 0; i < pending.size(); ++i) {
+        pending[i]->store_result(evaluator, move(results[i]));
+    }
+}
+
 const EvaluatorCache &EvaluationContext::get_cache() const {
     return cache;
 }
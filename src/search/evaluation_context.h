@@ -7,6 +7,7 @@
 #include "task_proxy.h"
 
 #include <unordered_map>
+#include <vector>
 
 class Evaluator;
 class SearchStatistics;
@@ -54,6 +55,8 @@ class EvaluationContext {
         const EvaluatorCache &cache, const State &state, int g_value,
         bool is_preferred, SearchStatistics *statistics,
         bool calculate_preferred);
+
+    void store_result(Evaluator *eval, EvaluationResult &&result);
 public:
     /*
       Copy existing heuristic cache and use it to look up heuristic values.
@@ -88,6 +91,15 @@ public:
         bool calculate_preferred = false);
 
     const EvaluationResult &get_result(Evaluator *eval);
+
+    /*
+      Compute the results of the given evaluator for all contexts that do
+      not cache a result for it yet with a single call to
+      Evaluator::compute_results and cache them. Afterwards, get_result
+      and the methods based on it can be used as usual.
+    */
+    static void evaluate_batch(
+        Evaluator *eval, const std::vector<EvaluationContext *> &eval_contexts);
     const EvaluatorCache &get_cache() const;
     const State &get_state() const;
     int get_g_value() const;
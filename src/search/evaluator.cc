@@ -24,6 +24,22 @@ bool Evaluator::is_safe() const {
     return true;
 }
 
+void Evaluator::compute_results(
+    const vector<EvaluationContext *> &eval_contexts,
+    vector<EvaluationResult> &results) {
+    results.clear();
+    results.reserve(eval_contexts.size());
+    for (EvaluationContext *eval_context : eval_contexts)
+        results.push_back(compute_result(*eval_context));
+}
+
+void Evaluator::get_evaluators(set<Evaluator *> &evals) {
+    evals.insert(this);
+}
+
+void Evaluator::print_statistics() const {
+}
+
 void Evaluator::report_value_for_initial_state(
     const EvaluationResult &result) const {
     if (log.is_at_least_normal()) {
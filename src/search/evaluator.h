@@ -7,6 +7,7 @@
 #include "utils/logging.h"
 
 #include <set>
+#include <vector>
 
 class EvaluationContext;
 class State;
@@ -50,6 +51,21 @@ public:
     virtual void get_path_dependent_evaluators(
         std::set<Evaluator *> &evals) = 0;
 
+    /*
+      get_evaluators should insert this evaluator and all evaluators
+      that it directly or indirectly depends on into the result set.
+      It is used to call print_statistics exactly once per evaluator.
+    */
+    virtual void get_evaluators(std::set<Evaluator *> &evals);
+
+    /*
+      Print statistics gathered during the search. Search algorithms
+      call this at the end of the search (see
+      print_evaluator_statistics). The default implementation prints
+      nothing.
+    */
+    virtual void print_statistics() const;
+
     virtual void notify_initial_state(const State & /*initial_state*/) {
     }
 
@@ -81,6 +97,21 @@ public:
     virtual EvaluationResult compute_result(
         EvaluationContext &eval_context) = 0;
 
+    /*
+      compute_results computes the results for a batch of evaluation
+      contexts at once and stores the result for eval_contexts[i] in
+      results[i]. Evaluators can override this method to share work and
+      scratch data between the states of a batch.
+
+      The default implementation calls compute_result for each context.
+      As for compute_result, the results should not be added to the
+      evaluation contexts, and the method should only be called by
+      EvaluationContext (see EvaluationContext::evaluate_batch).
+    */
+    virtual void compute_results(
+        const std::vector<EvaluationContext *> &eval_contexts,
+        std::vector<EvaluationResult> &results);
+
     void report_value_for_initial_state(const EvaluationResult &result) const;
     void report_new_minimum_value(const EvaluationResult &result) const;
 
@@ -50,11 +50,27 @@ EvaluationResult CombiningEvaluator::compute_result(
     return result;
 }
 
+void CombiningEvaluator::compute_results(
+    const vector<EvaluationContext *> &eval_contexts,
+    vector<EvaluationResult> &results) {
+    // Evaluate the subevaluators batch-wise first, then combine per state.
+    for (const shared_ptr<Evaluator> &subevaluator : subevaluators)
+        EvaluationContext::evaluate_batch(subevaluator.get(), eval_contexts);
+    Evaluator::compute_results(eval_contexts, results);
+}
+
 void CombiningEvaluator::get_path_dependent_evaluators(
     set<Evaluator *> &evals) {
     for (auto &subevaluator : subevaluators)
         subevaluator->get_path_dependent_evaluators(evals);
 }
+
+void CombiningEvaluator::get_evaluators(set<Evaluator *> &evals) {
+    evals.insert(this);
+    for (auto &subevaluator : subevaluators)
+        subevaluator->get_evaluators(evals);
+}
+
 void add_combining_evaluator_options_to_feature(
     plugins::Feature &feature, const string &description) {
     feature.add_list_option<shared_ptr<TaskIndependentEvaluator>>(
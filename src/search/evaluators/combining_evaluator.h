@@ -39,9 +39,13 @@ public:
     virtual bool is_safe() const override;
     virtual EvaluationResult compute_result(
         EvaluationContext &eval_context) override;
+    virtual void compute_results(
+        const std::vector<EvaluationContext *> &eval_contexts,
+        std::vector<EvaluationResult> &results) override;
 
     virtual void get_path_dependent_evaluators(
         std::set<Evaluator *> &evals) override;
+    virtual void get_evaluators(std::set<Evaluator *> &evals) override;
 };
 
 extern void add_combining_evaluator_options_to_feature(
@@ -19,6 +19,11 @@ void ModifyCostsEvaluator::get_path_dependent_evaluators(
     nested->get_path_dependent_evaluators(evals);
 }
 
+void ModifyCostsEvaluator::get_evaluators(set<Evaluator *> &evals) {
+    evals.insert(this);
+    nested->get_evaluators(evals);
+}
+
 void ModifyCostsEvaluator::notify_initial_state(const State &initial_state) {
     /*
       TODO issue1208: Once we remove the task transformation code from
@@ -42,6 +47,13 @@ EvaluationResult ModifyCostsEvaluator::compute_result(
     return nested->compute_result(eval_context);
 }
 
+void ModifyCostsEvaluator::compute_results(
+    const vector<EvaluationContext *> &eval_contexts,
+    vector<EvaluationResult> &results) {
+    // TODO issue1208: see above
+    nested->compute_results(eval_contexts, results);
+}
+
 bool ModifyCostsEvaluator::does_cache_estimates() const {
     return nested->does_cache_estimates();
 }
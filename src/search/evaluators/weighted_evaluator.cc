@@ -44,10 +44,22 @@ EvaluationResult WeightedEvaluator::compute_result(
     return result;
 }
 
+void WeightedEvaluator::compute_results(
+    const vector<EvaluationContext *> &eval_contexts,
+    vector<EvaluationResult> &results) {
+    EvaluationContext::evaluate_batch(evaluator.get(), eval_contexts);
+    Evaluator::compute_results(eval_contexts, results);
+}
+
 void WeightedEvaluator::get_path_dependent_evaluators(set<Evaluator *> &evals) {
     evaluator->get_path_dependent_evaluators(evals);
 }
 
+void WeightedEvaluator::get_evaluators(set<Evaluator *> &evals) {
+    evals.insert(this);
+    evaluator->get_evaluators(evals);
+}
+
 class WeightedEvaluatorFeature
     : public plugins::TypedFeature<TaskIndependentEvaluator> {
 public:
@@ -7,6 +7,7 @@
 #include "task_utils/task_properties.h"
 #include "tasks/cost_adapted_task.h"
 #include "tasks/root_task.h"
+#include "utils/language.h"
 
 #include <cassert>
 #include <cstdlib>
@@ -45,27 +46,10 @@ tuple<bool, string, utils::Verbosity> get_heuristic_arguments_from_options(
         get_evaluator_arguments_from_options(opts));
 }
 
-EvaluationResult Heuristic::compute_result(EvaluationContext &eval_context) {
+EvaluationResult Heuristic::create_result(
+    const State &state, int heuristic, bool count_evaluation) {
     EvaluationResult result;
-
-    assert(preferred_operators.empty());
-
-    const State &state = eval_context.get_state();
-    bool calculate_preferred = eval_context.get_calculate_preferred();
-
-    int heuristic = NO_VALUE;
-
-    if (!calculate_preferred && cache_evaluator_values &&
-        heuristic_cache[state].h != NO_VALUE && !heuristic_cache[state].dirty) {
-        heuristic = heuristic_cache[state].h;
-        result.set_count_evaluation(false);
-    } else {
-        heuristic = compute_heuristic(state);
-        if (cache_evaluator_values) {
-            heuristic_cache[state] = HEntry(heuristic, false);
-        }
-        result.set_count_evaluation(true);
-    }
+    result.set_count_evaluation(count_evaluation);
 
     assert(heuristic == DEAD_END || heuristic >= 0);
 
@@ -90,6 +74,7 @@ EvaluationResult Heuristic::compute_result(EvaluationContext &eval_context) {
                 task_properties::is_applicable(global_operators[op_id], state));
     }
 #endif
+    utils::unused_variable(state);
 
     result.set_evaluator_value(heuristic);
     result.set_preferred_operators(preferred_operators.pop_as_vector());
@@ -98,6 +83,72 @@ EvaluationResult Heuristic::compute_result(EvaluationContext &eval_context) {
     return result;
 }
 
+void Heuristic::compute_heuristics(
+    const vector<State> &ancestor_states, vector<int> &values) {
+    values.clear();
+    values.reserve(ancestor_states.size());
+    for (const State &ancestor_state : ancestor_states) {
+        values.push_back(compute_heuristic(ancestor_state));
+        preferred_operators.clear();
+    }
+}
+
+EvaluationResult Heuristic::compute_result(EvaluationContext &eval_context) {
+    assert(preferred_operators.empty());
+
+    const State &state = eval_context.get_state();
+    bool calculate_preferred = eval_context.get_calculate_preferred();
+
+    if (!calculate_preferred && cache_evaluator_values &&
+        heuristic_cache[state].h != NO_VALUE && !heuristic_cache[state].dirty) {
+        return create_result(state, heuristic_cache[state].h, false);
+    }
+
+    int heuristic = compute_heuristic(state);
+    if (cache_evaluator_values) {
+        heuristic_cache[state] = HEntry(heuristic, false);
+    }
+    return create_result(state, heuristic, true);
+}
+
+void Heuristic::compute_results(
+    const vector<EvaluationContext *> &eval_contexts,
+    vector<EvaluationResult> &results) {
+    assert(preferred_operators.empty());
+    results.clear();
+    results.resize(eval_contexts.size());
+
+    // Collect the states that need to be evaluated and their positions.
+    vector<State> states;
+    vector<int> positions;
+    for (size_t i = 0; i < eval_contexts.size(); ++i) {
+        EvaluationContext &eval_context = *eval_contexts[i];
+        const State &state = eval_context.get_state();
+        if (eval_context.get_calculate_preferred()) {
+            results[i] = compute_result(eval_context);
+        } else if (
+            cache_evaluator_values && heuristic_cache[state].h != NO_VALUE &&
+            !heuristic_cache[state].dirty) {
+            results[i] = create_result(state, heuristic_cache[state].h, false);
+        } else {
+            states.push_back(state);
+            positions.push_back(i);
+        }
+    }
+    if (states.empty())
+        return;
+
+    vector<int> values;
+    compute_heuristics(states, values);
+    assert(values.size() == states.size());
+    for (size_t i = 0; i < states.size(); ++i) {
+        if (cache_evaluator_values) {
+            heuristic_cache[states[i]] = HEntry(values[i], false);
+        }
+        results[positions[i]] = create_result(states[i], values[i], true);
+    }
+}
+
 bool Heuristic::does_cache_estimates() const {
     return cache_evaluator_values;
 }
@@ -9,6 +9,7 @@
 #include "algorithms/ordered_set.h"
 
 #include <memory>
+#include <vector>
 
 class TaskProxy;
 
@@ -42,6 +43,9 @@ class Heuristic : public Evaluator {
     */
     ordered_set::OrderedSet<OperatorID> preferred_operators;
 
+    EvaluationResult create_result(
+        const State &state, int heuristic, bool count_evaluation);
+
 protected:
     /*
       Cache for saving h values
@@ -59,6 +63,19 @@ protected:
 
     virtual int compute_heuristic(const State &ancestor_state) = 0;
 
+    /*
+      Compute the heuristic values of a batch of states and store the value
+      for ancestor_states[i] in values[i]. This is used for batches of
+      states for which no preferred operators are requested, so preferred
+      operators marked while computing these values are discarded.
+
+      Heuristics can override this to keep scratch data and hot parts of
+      their data structures in cache across the states of a batch. The
+      default implementation calls compute_heuristic for each state.
+    */
+    virtual void compute_heuristics(
+        const std::vector<State> &ancestor_states, std::vector<int> &values);
+
     /*
       Usage note: Marking the same operator as preferred multiple times
       is OK -- it will only appear once in the list of preferred
@@ -79,6 +96,9 @@ public:
 
     virtual EvaluationResult compute_result(
         EvaluationContext &eval_context) override;
+    virtual void compute_results(
+        const std::vector<EvaluationContext *> &eval_contexts,
+        std::vector<EvaluationResult> &results) override;
 
     virtual bool does_cache_estimates() const override;
     virtual bool is_estimate_cached(const State &state) const override;
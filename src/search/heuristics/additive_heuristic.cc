@@ -14,9 +14,11 @@ const int AdditiveHeuristic::MAX_COST_VALUE;
 
 AdditiveHeuristic::AdditiveHeuristic(
     const shared_ptr<AbstractTask> &task, tasks::AxiomHandlingType axioms,
-    bool cache_estimates, const string &description, utils::Verbosity verbosity)
+    bool incremental, bool share_exploration, bool cache_estimates,
+    const string &description, utils::Verbosity verbosity)
     : RelaxationHeuristic(
-          task, axioms, cache_estimates, description, verbosity),
+          task, axioms, incremental, share_exploration, cache_estimates,
+          description, verbosity),
       did_write_overflow_warning(false) {
     if (log.is_at_least_normal()) {
         log << "Initializing additive heuristic..." << endl;
@@ -38,57 +40,58 @@ void AdditiveHeuristic::write_overflow_warning() {
 }
 
 // heuristic computation
-void AdditiveHeuristic::setup_exploration_queue() {
-    queue.clear();
-
-    for (Proposition &prop : propositions) {
-        prop.cost = -1;
-        prop.marked = false;
-    }
-
-    // Deal with operators and axioms without preconditions.
-    for (UnaryOperator &op : unary_operators) {
-        op.unsatisfied_preconditions = op.num_preconditions;
-        op.cost = op.base_cost; // will be increased by precondition costs
-
-        if (op.unsatisfied_preconditions == 0)
-            enqueue_if_necessary(op.effect, op.base_cost, get_op_id(op));
-    }
-}
-
-void AdditiveHeuristic::setup_exploration_queue_state(const State &state) {
-    for (FactProxy fact : state) {
-        PropID init_prop = get_prop_id(fact);
-        enqueue_if_necessary(init_prop, 0, NO_OP);
-    }
-}
-
 void AdditiveHeuristic::relaxed_exploration() {
     int unsolved_goals = goal_propositions.size();
     while (!queue.empty()) {
         pair<int, PropID> top_pair = queue.pop();
         int distance = top_pair.first;
         PropID prop_id = top_pair.second;
-        Proposition *prop = get_proposition(prop_id);
-        int prop_cost = prop->cost;
+        int prop_cost = proposition_costs[prop_id];
         assert(prop_cost >= 0);
         assert(prop_cost <= distance);
         if (prop_cost < distance)
             continue;
-        if (prop->is_goal && --unsolved_goals == 0)
+        // Incremental explorations need the complete fixpoint.
+        if (get_proposition(prop_id)->is_goal && --unsolved_goals == 0 &&
+            !incremental)
             return;
-        for (OpID op_id : precondition_of_pool.get_slice(
-                 prop->precondition_of, prop->num_precondition_occurences)) {
-            UnaryOperator *unary_op = get_operator(op_id);
-            increase_cost(unary_op->cost, prop_cost);
-            --unary_op->unsatisfied_preconditions;
-            assert(unary_op->unsatisfied_preconditions >= 0);
-            if (unary_op->unsatisfied_preconditions == 0)
-                enqueue_if_necessary(unary_op->effect, unary_op->cost, op_id);
+        for (OpID op_id : get_precondition_of(prop_id)) {
+            increase_cost(operator_costs[op_id], prop_cost);
+            int &unsatisfied = unsatisfied_preconditions[op_id];
+            --unsatisfied;
+            assert(unsatisfied >= 0);
+            if (unsatisfied == 0) {
+                enqueue_if_necessary(
+                    get_operator(op_id)->effect, operator_costs[op_id], op_id);
+            }
         }
     }
 }
 
+int AdditiveHeuristic::compute_unary_operator_cost(OpID op_id) {
+    int cost = operator_base_costs[op_id];
+    for (PropID precond : get_preconditions(op_id)) {
+        int precond_cost = proposition_costs[precond];
+        if (precond_cost == -1)
+            return -1;
+        increase_cost(cost, precond_cost);
+    }
+    return cost;
+}
+
+void AdditiveHeuristic::update_exploration_incrementally(const State &state) {
+    bool repaired = RelaxationHeuristic::update_exploration_incrementally(
+        state, [this](OpID op_id) {
+            return compute_unary_operator_cost(op_id);
+        });
+    if (!repaired) {
+        setup_exploration_queue();
+        setup_exploration_queue_state(state);
+        relaxed_exploration();
+        set_explored_state(&state, true);
+    }
+}
+
 void AdditiveHeuristic::mark_preferred_operators(
     const State &state, PropID goal_id) {
     Proposition *goal = get_proposition(goal_id);
@@ -116,14 +119,23 @@ void AdditiveHeuristic::mark_preferred_operators(
 }
 
 int AdditiveHeuristic::compute_add_and_ff(const State &state) {
-    setup_exploration_queue();
-    setup_exploration_queue_state(state);
-    relaxed_exploration();
+    // A heuristic sharing the exploration might have explored the state.
+    if (!is_explored(state)) {
+        if (incremental) {
+            update_exploration_incrementally(state);
+        } else {
+            setup_exploration_queue();
+            setup_exploration_queue_state(state);
+            relaxed_exploration();
+            set_explored_state(&state, false);
+        }
+    }
+    for (Proposition &prop : propositions)
+        prop.marked = false;
 
     int total_cost = 0;
     for (PropID goal_id : goal_propositions) {
-        const Proposition *goal = get_proposition(goal_id);
-        int goal_cost = goal->cost;
+        int goal_cost = proposition_costs[goal_id];
         if (goal_cost == -1)
             return DEAD_END;
         increase_cost(total_cost, goal_cost);
@@ -145,14 +157,39 @@ void AdditiveHeuristic::compute_heuristic_for_cegar(const State &state) {
     compute_heuristic(state);
 }
 
+void add_additive_heuristic_options_to_feature(
+    plugins::Feature &feature, const string &description) {
+    relaxation_heuristic::add_relaxation_heuristic_options_to_feature(
+        feature, description);
+    feature.add_option<bool>(
+        "share_exploration",
+        "Share the relaxed task and the exploration with all other h^add "
+        "and h^FF heuristics with this option and the same task and axiom "
+        "handling. The relaxed task is then only built once, and if "
+        "several of these heuristics evaluate the same state one after "
+        "another, only the first one explores. Relaxed plans and preferred "
+        "operators can change if heuristics with different values for "
+        "the incremental option share the exploration.",
+        "true");
+}
+
+tuple<tasks::AxiomHandlingType, bool, bool, bool, string, utils::Verbosity>
+get_additive_heuristic_arguments_from_options(const plugins::Options &opts) {
+    return tuple_cat(
+        tasks::get_axioms_arguments_from_options(opts),
+        make_tuple(
+            opts.get<bool>("incremental"),
+            opts.get<bool>("share_exploration")),
+        get_heuristic_arguments_from_options(opts));
+}
+
 class AdditiveHeuristicFeature
     : public plugins::TypedFeature<TaskIndependentEvaluator> {
 public:
     AdditiveHeuristicFeature() : TypedFeature("add") {
         document_title("Additive heuristic");
 
-        relaxation_heuristic::add_relaxation_heuristic_options_to_feature(
-            *this, "add");
+        add_additive_heuristic_options_to_feature(*this, "add");
 
         document_language_support("action costs", "supported");
         document_language_support("conditional effects", "supported");
@@ -168,8 +205,7 @@ public:
         const plugins::Options &opts) const override {
         return components::make_auto_task_independent_component<
             AdditiveHeuristic, Evaluator>(
-            relaxation_heuristic::
-                get_relaxation_heuristic_arguments_from_options(opts));
+            get_additive_heuristic_arguments_from_options(opts));
     }
 };
 
@@ -3,10 +3,12 @@
 
 #include "relaxation_heuristic.h"
 
-#include "../algorithms/priority_queues.h"
 #include "../utils/collections.h"
 
 #include <cassert>
+#include <string>
+#include <tuple>
+#include <vector>
 
 class State;
 
@@ -29,25 +31,14 @@ class AdditiveHeuristic : public relaxation_heuristic::RelaxationHeuristic {
      */
     static const int MAX_COST_VALUE = 100000000;
 
-    priority_queues::AdaptiveQueue<PropID> queue;
     bool did_write_overflow_warning;
 
-    void setup_exploration_queue();
-    void setup_exploration_queue_state(const State &state);
     void relaxed_exploration();
+    void update_exploration_incrementally(const State &state);
+    // Return -1 if a precondition is unreached.
+    int compute_unary_operator_cost(OpID op_id);
     void mark_preferred_operators(const State &state, PropID goal_id);
 
-    void enqueue_if_necessary(PropID prop_id, int cost, OpID op_id) {
-        assert(cost >= 0);
-        Proposition *prop = get_proposition(prop_id);
-        if (prop->cost == -1 || prop->cost > cost) {
-            prop->cost = cost;
-            prop->reached_by = op_id;
-            queue.push(cost, prop_id);
-        }
-        assert(prop->cost != -1 && prop->cost <= cost);
-    }
-
     void increase_cost(int &cost, int amount) {
         assert(cost >= 0);
         assert(amount >= 0);
@@ -67,7 +58,8 @@ protected:
 public:
     AdditiveHeuristic(
         const std::shared_ptr<AbstractTask> &task,
-        tasks::AxiomHandlingType axioms, bool cache_estimates,
+        tasks::AxiomHandlingType axioms, bool incremental,
+        bool share_exploration, bool cache_estimates,
         const std::string &description, utils::Verbosity verbosity);
 
     /*
@@ -79,9 +71,16 @@ public:
     void compute_heuristic_for_cegar(const State &state);
 
     int get_cost_for_cegar(int var, int value) const {
-        return get_proposition(var, value)->cost;
+        return proposition_costs[get_prop_id(var, value)];
     }
 };
+
+extern void add_additive_heuristic_options_to_feature(
+    plugins::Feature &feature, const std::string &description);
+extern std::tuple<
+    tasks::AxiomHandlingType, bool, bool, bool, std::string,
+    utils::Verbosity>
+get_additive_heuristic_arguments_from_options(const plugins::Options &opts);
 }
 
 #endif
@@ -6,6 +6,7 @@
 #include "../task_utils/task_properties.h"
 #include "../utils/logging.h"
 
+#include <algorithm>
 #include <cassert>
 #include <limits>
 #include <vector>
@@ -107,11 +108,23 @@ struct LocalProblemNode {
 };
 
 struct LocalProblem {
+    int var;
+    int start_value;
     int base_priority;
     vector<LocalProblemNode> nodes;
     vector<int> *context_variables;
+
+    // Evaluation in which the problem was last set up.
+    int evaluation;
+    // True if the node costs were taken from the memo in this evaluation.
+    bool is_memoized;
 public:
-    LocalProblem() : base_priority(-1) {
+    LocalProblem(int var, int start_value)
+        : var(var),
+          start_value(start_value),
+          base_priority(-1),
+          evaluation(-1),
+          is_memoized(false) {
     }
 
     ~LocalProblem() {
@@ -122,15 +135,15 @@ LocalProblem *ContextEnhancedAdditiveHeuristic::get_local_problem(
     int var_no, int value) {
     LocalProblem *&table_entry = local_problem_index[var_no][value];
     if (!table_entry) {
-        table_entry = build_problem_for_variable(var_no);
+        table_entry = build_problem_for_variable(var_no, value);
         local_problems.push_back(table_entry);
     }
     return table_entry;
 }
 
 LocalProblem *ContextEnhancedAdditiveHeuristic::build_problem_for_variable(
-    int var_no) const {
-    LocalProblem *problem = new LocalProblem;
+    int var_no, int start_value) const {
+    LocalProblem *problem = new LocalProblem(var_no, start_value);
 
     DomainTransitionGraph *dtg = transition_graphs[var_no].get();
 
@@ -163,7 +176,7 @@ LocalProblem *ContextEnhancedAdditiveHeuristic::build_problem_for_variable(
 }
 
 LocalProblem *ContextEnhancedAdditiveHeuristic::build_problem_for_goal() const {
-    LocalProblem *problem = new LocalProblem;
+    LocalProblem *problem = new LocalProblem(-1, 0);
 
     GoalsProxy goals_proxy = task_proxy.get_goals();
 
@@ -210,14 +223,18 @@ inline void ContextEnhancedAdditiveHeuristic::add_to_heap(
 
 bool ContextEnhancedAdditiveHeuristic::is_local_problem_set_up(
     const LocalProblem *problem) const {
-    return problem->base_priority != -1;
+    return problem->evaluation == current_evaluation;
 }
 
 void ContextEnhancedAdditiveHeuristic::set_up_local_problem(
     LocalProblem *problem, int base_priority, int start_value,
     const State &state) {
-    assert(problem->base_priority == -1);
+    assert(!is_local_problem_set_up(problem) || problem->is_memoized);
     problem->base_priority = base_priority;
+    problem->evaluation = current_evaluation;
+    problem->is_memoized = false;
+    if (max_memo_entries > 0 && problem != goal_problem)
+        solved_problems.push_back(problem);
 
     for (auto &to_node : problem->nodes) {
         to_node.expanded = false;
@@ -234,6 +251,107 @@ void ContextEnhancedAdditiveHeuristic::set_up_local_problem(
     add_to_heap(start);
 }
 
+void ContextEnhancedAdditiveHeuristic::compute_memo_variables() {
+    // Collect the ancestors of each variable with a depth-first search.
+    int num_vars = transition_graphs.size();
+    memo_variables.resize(num_vars);
+    vector<bool> reached(num_vars);
+    vector<int> stack;
+    for (int var = 0; var < num_vars; ++var) {
+        fill(reached.begin(), reached.end(), false);
+        stack.push_back(var);
+        while (!stack.empty()) {
+            int current = stack.back();
+            stack.pop_back();
+            const vector<int> &parents =
+                transition_graphs[current]->local_to_global_child;
+            for (int parent : parents) {
+                if (!reached[parent]) {
+                    reached[parent] = true;
+                    memo_variables[var].push_back(parent);
+                    stack.push_back(parent);
+                }
+            }
+        }
+        sort(memo_variables[var].begin(), memo_variables[var].end());
+    }
+}
+
+void ContextEnhancedAdditiveHeuristic::compute_memo_key(
+    const LocalProblem *problem, const State &state) {
+    memo_key.clear();
+    memo_key.push_back(problem->var);
+    memo_key.push_back(problem->start_value);
+    for (int var : memo_variables[problem->var])
+        memo_key.push_back(state[var].get_value());
+}
+
+bool ContextEnhancedAdditiveHeuristic::set_up_local_problem_from_memo(
+    LocalProblem *problem, const State &state) {
+    /*
+      Memoized nodes are marked as expanded, and all other nodes are left
+      unreached. The problem is not explored further unless one of these
+      other nodes is needed, in which case it is set up normally.
+    */
+    if (max_memo_entries == 0)
+        return false;
+    compute_memo_key(problem, state);
+    auto it = memo.find(memo_key);
+    if (it == memo.end()) {
+        ++num_memo_misses;
+        return false;
+    }
+    ++num_memo_hits;
+    problem->evaluation = current_evaluation;
+    problem->is_memoized = true;
+    const vector<MemoizedNode> &memoized_nodes = it->second;
+    for (size_t value = 0; value < problem->nodes.size(); ++value) {
+        LocalProblemNode &node = problem->nodes[value];
+        const MemoizedNode &memoized_node = memoized_nodes[value];
+        node.waiting_list.clear();
+        node.expanded = (memoized_node.cost != -1);
+        if (node.expanded) {
+            node.cost = memoized_node.cost;
+            node.reached_by = memoized_node.reached_by;
+            // The problem is not explored, so target_cost is unused.
+            if (node.reached_by)
+                node.reached_by->target_cost = memoized_node.reached_by_cost;
+        } else {
+            node.cost = numeric_limits<int>::max();
+            node.reached_by = nullptr;
+        }
+    }
+    return true;
+}
+
+void ContextEnhancedAdditiveHeuristic::memoize_solved_problems(
+    const State &state) {
+    for (LocalProblem *problem : solved_problems) {
+        compute_memo_key(problem, state);
+        auto it = memo.find(memo_key);
+        if (it == memo.end()) {
+            if (static_cast<int>(memo.size()) >= max_memo_entries)
+                memo.clear();
+            it = memo.emplace(
+                memo_key,
+                vector<MemoizedNode>(
+                    problem->nodes.size(), MemoizedNode{-1, nullptr, 0}))
+                     .first;
+        }
+        vector<MemoizedNode> &memoized_nodes = it->second;
+        for (size_t value = 0; value < problem->nodes.size(); ++value) {
+            const LocalProblemNode &node = problem->nodes[value];
+            if (node.expanded) {
+                LocalTransition *first = node.reached_by;
+                memoized_nodes[value] =
+                    MemoizedNode{node.cost, first,
+                                 first ? first->target_cost : 0};
+            }
+        }
+    }
+    solved_problems.clear();
+}
+
 void ContextEnhancedAdditiveHeuristic::try_to_fire_transition(
     LocalTransition *trans) {
     if (!trans->unreached_conditions) {
@@ -314,12 +432,18 @@ void ContextEnhancedAdditiveHeuristic::expand_transition(
         LocalProblem *subproblem =
             get_local_problem(precond_var_no, current_val);
 
-        if (!is_local_problem_set_up(subproblem)) {
+        if (!is_local_problem_set_up(subproblem) &&
+            !set_up_local_problem_from_memo(subproblem, state)) {
             set_up_local_problem(
                 subproblem, get_priority(trans->source), current_val, state);
         }
 
         LocalProblemNode *cond_node = &subproblem->nodes[precond_value];
+        if (subproblem->is_memoized && !cond_node->expanded) {
+            // The node was not reached when the result was memoized.
+            set_up_local_problem(
+                subproblem, get_priority(trans->source), current_val, state);
+        }
         if (cond_node->expanded) {
             trans->target_cost += cond_node->cost;
             if (trans->target->cost <= trans->target_cost) {
@@ -385,7 +509,17 @@ void ContextEnhancedAdditiveHeuristic::mark_helpful_transitions(
                     continue;
                 LocalProblem *subproblem = get_local_problem(
                     precond_var_no, state[precond_var_no].get_value());
+                /*
+                  If the path comes from the memo, the subproblem may not
+                  have been needed so far. Skip it if its result has been
+                  removed from the memo in the meantime.
+                */
+                if (!is_local_problem_set_up(subproblem) &&
+                    !set_up_local_problem_from_memo(subproblem, state))
+                    continue;
                 LocalProblemNode *subnode = &subproblem->nodes[precond_value];
+                if (!subnode->expanded)
+                    continue;
                 mark_helpful_transitions(subproblem, subnode, state);
             }
         }
@@ -396,13 +530,15 @@ int ContextEnhancedAdditiveHeuristic::compute_heuristic(
     const State &ancestor_state) {
     State state = convert_ancestor_state(ancestor_state);
     initialize_heap();
-    goal_problem->base_priority = -1;
-    for (LocalProblem *problem : local_problems)
-        problem->base_priority = -1;
+    ++current_evaluation;
 
     set_up_local_problem(goal_problem, 0, 0, state);
 
     int heuristic = compute_costs(state);
+    if (max_memo_entries > 0) {
+        // Must happen before mark_helpful_transitions clears reached_by.
+        memoize_solved_problems(state);
+    }
 
     if (heuristic != DEAD_END && heuristic != 0)
         mark_helpful_transitions(goal_problem, goal_node, state);
@@ -411,19 +547,26 @@ int ContextEnhancedAdditiveHeuristic::compute_heuristic(
 }
 
 ContextEnhancedAdditiveHeuristic::ContextEnhancedAdditiveHeuristic(
-    const shared_ptr<AbstractTask> &task, tasks::AxiomHandlingType axioms,
-    bool cache_estimates, const string &description, utils::Verbosity verbosity)
+    const shared_ptr<AbstractTask> &task, int max_memo_entries,
+    tasks::AxiomHandlingType axioms, bool cache_estimates,
+    const string &description, utils::Verbosity verbosity)
     : Heuristic(
           // issue1208 move this transformation to task-independent level?
           tasks::get_default_value_axioms_task_if_needed(task, axioms),
           cache_estimates, description, verbosity),
-      min_action_cost(task_properties::get_min_operator_cost(task_proxy)) {
+      min_action_cost(task_properties::get_min_operator_cost(task_proxy)),
+      current_evaluation(0),
+      max_memo_entries(max_memo_entries),
+      num_memo_hits(0),
+      num_memo_misses(0) {
     if (log.is_at_least_normal()) {
         log << "Initializing context-enhanced additive heuristic..." << endl;
     }
 
     DTGFactory factory(task_proxy, true, [](int, int) { return false; });
     transition_graphs = factory.build_dtgs();
+    if (max_memo_entries > 0)
+        compute_memo_variables();
 
     goal_problem = build_problem_for_goal();
     goal_node = &goal_problem->nodes[1];
@@ -446,6 +589,14 @@ ContextEnhancedAdditiveHeuristic::~ContextEnhancedAdditiveHeuristic() {
         delete problem;
 }
 
+void ContextEnhancedAdditiveHeuristic::print_statistics() const {
+    if (max_memo_entries > 0 && log.is_at_least_normal()) {
+        log << "CEA memo hits: " << num_memo_hits << endl;
+        log << "CEA memo misses: " << num_memo_misses << endl;
+        log << "CEA memo entries: " << memo.size() << endl;
+    }
+}
+
 bool ContextEnhancedAdditiveHeuristic::is_safe() const {
     return false;
 }
@@ -456,6 +607,11 @@ public:
     ContextEnhancedAdditiveHeuristicFeature() : TypedFeature("cea") {
         document_title("Context-enhanced additive heuristic");
 
+        add_option<int>(
+            "max_memo_entries",
+            "maximum number of memoized local problem results. The memo is "
+            "cleared when it is full (set to 0 to disable memoization)",
+            "100000", plugins::Bounds("0", "infinity"));
         tasks::add_axioms_option_to_feature(*this);
         add_heuristic_options_to_feature(*this, "cea");
 
@@ -473,6 +629,7 @@ public:
         const plugins::Options &opts) const override {
         return components::make_auto_task_independent_component<
             ContextEnhancedAdditiveHeuristic, Evaluator>(
+            opts.get<int>("max_memo_entries"),
             tasks::get_axioms_arguments_from_options(opts),
             get_heuristic_arguments_from_options(opts));
     }
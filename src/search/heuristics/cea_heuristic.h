@@ -7,7 +7,9 @@
 
 #include "../algorithms/priority_queues.h"
 #include "../tasks/default_value_axioms_task.h"
+#include "../utils/hash.h"
 
+#include <cstdint>
 #include <vector>
 
 class State;
@@ -18,6 +20,13 @@ struct LocalProblemNode;
 struct LocalTransition;
 
 class ContextEnhancedAdditiveHeuristic : public Heuristic {
+    // Final cost and first transition of a node in a solved local problem.
+    struct MemoizedNode {
+        int cost;
+        LocalTransition *reached_by;
+        int reached_by_cost;
+    };
+
     std::vector<std::unique_ptr<domain_transition_graph::DomainTransitionGraph>>
         transition_graphs;
     std::vector<LocalProblem *> local_problems;
@@ -25,11 +34,31 @@ class ContextEnhancedAdditiveHeuristic : public Heuristic {
     LocalProblem *goal_problem;
     LocalProblemNode *goal_node;
     int min_action_cost;
+    // Local problems are only valid in the evaluation they were set up in.
+    int current_evaluation;
+
+    /*
+      The costs of a local problem for variable v only depend on its start
+      value and the state values of the variables in memo_variables[v],
+      the ancestors of v in the causal graph. The memo stores the nodes
+      that were expanded in earlier evaluations under this key, so that
+      local problems whose result is already known need not be solved.
+      When the memo has max_memo_entries entries, it is cleared.
+    */
+    const int max_memo_entries;
+    std::vector<std::vector<int>> memo_variables;
+    utils::HashMap<std::vector<int>, std::vector<MemoizedNode>> memo;
+    // Local problems that were solved by search in the current evaluation.
+    std::vector<LocalProblem *> solved_problems;
+    std::vector<int> memo_key;
+    int64_t num_memo_hits;
+    int64_t num_memo_misses;
 
     priority_queues::AdaptiveQueue<LocalProblemNode *> node_queue;
 
     LocalProblem *get_local_problem(int var_no, int value);
-    LocalProblem *build_problem_for_variable(int var_no) const;
+    LocalProblem *build_problem_for_variable(
+        int var_no, int start_value) const;
     LocalProblem *build_problem_for_goal() const;
 
     int get_priority(LocalProblemNode *node) const;
@@ -40,6 +69,11 @@ class ContextEnhancedAdditiveHeuristic : public Heuristic {
     void set_up_local_problem(
         LocalProblem *problem, int base_priority, int start_value,
         const State &state);
+    void compute_memo_variables();
+    void compute_memo_key(const LocalProblem *problem, const State &state);
+    bool set_up_local_problem_from_memo(
+        LocalProblem *problem, const State &state);
+    void memoize_solved_problems(const State &state);
 
     void try_to_fire_transition(LocalTransition *trans);
     void expand_node(LocalProblemNode *node);
@@ -54,12 +88,13 @@ protected:
     virtual int compute_heuristic(const State &ancestor_state) override;
 public:
     ContextEnhancedAdditiveHeuristic(
-        const std::shared_ptr<AbstractTask> &task,
+        const std::shared_ptr<AbstractTask> &task, int max_memo_entries,
         tasks::AxiomHandlingType axioms, bool cache_estimates,
         const std::string &description, utils::Verbosity verbosity);
 
     virtual ~ContextEnhancedAdditiveHeuristic() override;
     virtual bool is_safe() const override;
+    virtual void print_statistics() const override;
 };
 }
 
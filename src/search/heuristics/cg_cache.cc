@@ -4,22 +4,31 @@
 
 #include "../task_utils/causal_graph.h"
 #include "../utils/collections.h"
+#include "../utils/hash.h"
 #include "../utils/logging.h"
 #include "../utils/math.h"
 
 #include <algorithm>
 #include <cassert>
 #include <iostream>
+#include <limits>
 #include <vector>
 
 using namespace std;
+using domain_transition_graph::ValueTransitionLabel;
 
 namespace cg_heuristic {
 const int CGCache::NOT_COMPUTED;
 
 CGCache::CGCache(
-    const TaskProxy &task_proxy, int max_cache_size, utils::LogProxy &log)
-    : task_proxy(task_proxy) {
+    const TaskProxy &task_proxy, int max_cache_size, int max_sparse_cache_size,
+    utils::LogProxy &log)
+    : task_proxy(task_proxy),
+      max_sparse_cache_size(max_sparse_cache_size),
+      clock_hand(0),
+      num_hits(0),
+      num_misses(0),
+      num_evictions(0) {
     /*
       Get the causal graph first because this can trigger output
       that we don't want to have in the middle of the output of this function.
@@ -63,18 +72,39 @@ CGCache::CGCache(
 
     cache.resize(var_count);
     helpful_transition_cache.resize(var_count);
+    is_sparse.resize(var_count, false);
 
+    int num_dense = 0;
+    int num_sparse = 0;
     for (int var = 0; var < var_count; ++var) {
         int required_cache_size =
             compute_required_cache_size(var, depends_on[var], max_cache_size);
         if (required_cache_size != -1) {
             cache[var].resize(required_cache_size, NOT_COMPUTED);
             helpful_transition_cache[var].resize(required_cache_size, nullptr);
+            ++num_dense;
+        } else if (
+            max_sparse_cache_size > 0 && is_sparse_key_within_limit(var)) {
+            is_sparse[var] = true;
+            ++num_sparse;
         }
     }
 
+    if (num_sparse > 0) {
+        // Keep the load factor of the hash table at most 1/2.
+        int num_buckets = 1;
+        while (num_buckets < 2 * max_sparse_cache_size)
+            num_buckets *= 2;
+        sparse_buckets.resize(num_buckets, -1);
+        sparse_entries.reserve(max_sparse_cache_size);
+    }
+
     if (log.is_at_least_normal()) {
         log << "done!" << endl;
+        log << "Variables with dense cache: " << num_dense << endl;
+        log << "Variables with bounded cache: " << num_sparse << endl;
+        log << "Variables without cache: " << var_count - num_dense - num_sparse
+            << endl;
     }
 }
 
@@ -135,4 +165,176 @@ int CGCache::get_index(
     assert(utils::in_bounds(index, cache[var]));
     return index;
 }
+bool CGCache::is_sparse_key_within_limit(int var_id) const {
+    /*
+      Check that the keys of all contexts of the variable fit into 64 bits
+      (see get_sparse_key).
+    */
+    VariablesProxy variables = task_proxy.get_variables();
+    uint64_t limit = numeric_limits<uint64_t>::max() / variables.size();
+    int var_domain = variables[var_id].get_domain_size();
+    uint64_t size = static_cast<uint64_t>(var_domain) * var_domain;
+    for (int depend_var_id : depends_on[var_id]) {
+        uint64_t depend_var_domain =
+            variables[depend_var_id].get_domain_size();
+        if (size > limit / depend_var_domain)
+            return false;
+        size *= depend_var_domain;
+    }
+    return size <= limit;
+}
+
+uint64_t CGCache::get_sparse_key(
+    int var, const State &state, int from_val, int to_val) const {
+    assert(is_sparse[var]);
+    VariablesProxy variables = task_proxy.get_variables();
+    uint64_t domain_size = variables[var].get_domain_size();
+    uint64_t key = from_val + to_val * domain_size;
+    uint64_t multiplier = domain_size * domain_size;
+    for (int dep_var : depends_on[var]) {
+        key += state[dep_var].get_value() * multiplier;
+        multiplier *= variables[dep_var].get_domain_size();
+    }
+    return key * variables.size() + var;
+}
+
+int CGCache::get_bucket(uint64_t key) const {
+    return utils::get_hash32(key) & (sparse_buckets.size() - 1);
+}
+
+int CGCache::find_sparse_bucket(uint64_t key) const {
+    // Return the bucket containing the key or the empty bucket ending the
+    // probe sequence for the key.
+    int mask = sparse_buckets.size() - 1;
+    int bucket = get_bucket(key);
+    while (sparse_buckets[bucket] != -1 &&
+           sparse_entries[sparse_buckets[bucket]].key != key) {
+        bucket = (bucket + 1) & mask;
+    }
+    return bucket;
+}
+
+void CGCache::erase_sparse_bucket(int bucket) {
+    /*
+      Deletion without tombstones for linear probing: move later entries
+      of the same probe sequence into the hole.
+    */
+    int mask = sparse_buckets.size() - 1;
+    int next = bucket;
+    while (true) {
+        sparse_buckets[bucket] = -1;
+        int home;
+        do {
+            next = (next + 1) & mask;
+            if (sparse_buckets[next] == -1)
+                return;
+            home = get_bucket(sparse_entries[sparse_buckets[next]].key);
+            // Stop if home is cyclically outside of (bucket, next].
+        } while (bucket <= next ? (bucket < home && home <= next)
+                                : (bucket < home || home <= next));
+        sparse_buckets[bucket] = sparse_buckets[next];
+        bucket = next;
+    }
+}
+
+int CGCache::allocate_sparse_entry() {
+    int num_entries = sparse_entries.size();
+    if (num_entries < max_sparse_cache_size) {
+        sparse_entries.emplace_back();
+        return num_entries;
+    }
+    // CLOCK eviction: give referenced entries a second chance.
+    while (sparse_entries[clock_hand].referenced) {
+        sparse_entries[clock_hand].referenced = false;
+        clock_hand = (clock_hand + 1) % num_entries;
+    }
+    int entry_id = clock_hand;
+    clock_hand = (clock_hand + 1) % num_entries;
+    erase_sparse_bucket(find_sparse_bucket(sparse_entries[entry_id].key));
+    ++num_evictions;
+    return entry_id;
+}
+
+CGCache::SparseEntry *CGCache::lookup_sparse(
+    int var, const State &state, int from_val, int to_val) {
+    int entry_id = sparse_buckets[find_sparse_bucket(
+        get_sparse_key(var, state, from_val, to_val))];
+    if (entry_id == -1)
+        return nullptr;
+    return &sparse_entries[entry_id];
+}
+
+void CGCache::store_sparse(
+    int var, const State &state, int from_val, int to_val, int cost,
+    ValueTransitionLabel *helpful_transition) {
+    uint64_t key = get_sparse_key(var, state, from_val, to_val);
+    int bucket = find_sparse_bucket(key);
+    int entry_id = sparse_buckets[bucket];
+    if (entry_id == -1) {
+        entry_id = allocate_sparse_entry();
+        // Eviction may have moved entries, including the empty bucket.
+        bucket = find_sparse_bucket(key);
+        sparse_buckets[bucket] = entry_id;
+        sparse_entries[entry_id].key = key;
+        sparse_entries[entry_id].referenced = false;
+    }
+    SparseEntry &entry = sparse_entries[entry_id];
+    entry.cost = cost;
+    entry.helpful_transition = helpful_transition;
+}
+
+int CGCache::lookup(int var, const State &state, int from_val, int to_val) {
+    int cost;
+    if (is_sparse[var]) {
+        SparseEntry *entry = lookup_sparse(var, state, from_val, to_val);
+        if (entry) {
+            entry->referenced = true;
+            cost = entry->cost;
+        } else {
+            cost = NOT_COMPUTED;
+        }
+    } else {
+        cost = cache[var][get_index(var, state, from_val, to_val)];
+    }
+    if (cost == NOT_COMPUTED)
+        ++num_misses;
+    else
+        ++num_hits;
+    return cost;
+}
+
+void CGCache::store(
+    int var, const State &state, int from_val, int to_val, int cost,
+    ValueTransitionLabel *helpful_transition) {
+    if (is_sparse[var]) {
+        store_sparse(var, state, from_val, to_val, cost, helpful_transition);
+    } else {
+        int index = get_index(var, state, from_val, to_val);
+        cache[var][index] = cost;
+        helpful_transition_cache[var][index] = helpful_transition;
+    }
+}
+
+ValueTransitionLabel *CGCache::lookup_helpful_transition(
+    int var, const State &state, int from_val, int to_val, int &cost) {
+    if (is_sparse[var]) {
+        SparseEntry *entry = lookup_sparse(var, state, from_val, to_val);
+        if (!entry)
+            return nullptr;
+        cost = entry->cost;
+        return entry->helpful_transition;
+    } else {
+        int index = get_index(var, state, from_val, to_val);
+        cost = cache[var][index];
+        return helpful_transition_cache[var][index];
+    }
+}
+
+void CGCache::print_statistics(utils::LogProxy &log) const {
+    if (log.is_at_least_normal()) {
+        log << "CG cache hits: " << num_hits << endl;
+        log << "CG cache misses: " << num_misses << endl;
+        log << "CG cache evictions: " << num_evictions << endl;
+    }
+}
 }
@@ -3,6 +3,7 @@
 
 #include "../task_proxy.h"
 
+#include <cstdint>
 #include <vector>
 
 namespace domain_transition_graph {
@@ -14,48 +15,92 @@ class LogProxy;
 }
 
 namespace cg_heuristic {
+/*
+  Cache for the transition costs computed by the CG heuristic. The cost of
+  a transition of a variable only depends on the values of its ancestors in
+  the (reduced) causal graph, so the cache is indexed by these values.
+
+  Variables whose table of all possible contexts has at most
+  max_cache_size entries get a dense table of that size. For all other
+  variables, the transition costs are stored in a single shared table with
+  at most max_sparse_cache_size entries. It is an open addressing hash
+  table with linear probing, and when it is full, it evicts entries with
+  the CLOCK algorithm, which approximates least-recently-used eviction:
+  entries are visited in a circular order, and an entry is evicted unless
+  it was used since the last visit.
+*/
 class CGCache {
+    struct SparseEntry {
+        uint64_t key;
+        domain_transition_graph::ValueTransitionLabel *helpful_transition;
+        int cost;
+        bool referenced;
+    };
+
     TaskProxy task_proxy;
     std::vector<std::vector<int>> cache;
     std::vector<std::vector<domain_transition_graph::ValueTransitionLabel *>>
         helpful_transition_cache;
     std::vector<std::vector<int>> depends_on;
 
+    std::vector<bool> is_sparse;
+    const int max_sparse_cache_size;
+    std::vector<SparseEntry> sparse_entries;
+    // Indices into sparse_entries (-1 for empty buckets).
+    std::vector<int> sparse_buckets;
+    int clock_hand;
+
+    int64_t num_hits;
+    int64_t num_misses;
+    int64_t num_evictions;
+
     int get_index(int var, const State &state, int from_val, int to_val) const;
+    uint64_t get_sparse_key(
+        int var, const State &state, int from_val, int to_val) const;
     int compute_required_cache_size(
         int var_id, const std::vector<int> &depends_on,
         int max_cache_size) const;
+    bool is_sparse_key_within_limit(int var_id) const;
+
+    int get_bucket(uint64_t key) const;
+    int find_sparse_bucket(uint64_t key) const;
+    void erase_sparse_bucket(int bucket);
+    int allocate_sparse_entry();
+    SparseEntry *lookup_sparse(
+        int var, const State &state, int from_val, int to_val);
+    void store_sparse(
+        int var, const State &state, int from_val, int to_val, int cost,
+        domain_transition_graph::ValueTransitionLabel *helpful_transition);
 public:
     static const int NOT_COMPUTED = -2;
 
     CGCache(
-        const TaskProxy &task_proxy, int max_cache_size, utils::LogProxy &log);
+        const TaskProxy &task_proxy, int max_cache_size,
+        int max_sparse_cache_size, utils::LogProxy &log);
 
     bool is_cached(int var) const {
-        return !cache[var].empty();
+        return !cache[var].empty() || is_sparse[var];
     }
 
-    int lookup(int var, const State &state, int from_val, int to_val) const {
-        return cache[var][get_index(var, state, from_val, to_val)];
-    }
+    /*
+      Return the cached cost or NOT_COMPUTED. For variables with a sparse
+      cache, an entry might have been evicted since it was stored.
+    */
+    int lookup(int var, const State &state, int from_val, int to_val);
 
     void store(
-        int var, const State &state, int from_val, int to_val, int cost) {
-        cache[var][get_index(var, state, from_val, to_val)] = cost;
-    }
+        int var, const State &state, int from_val, int to_val, int cost,
+        domain_transition_graph::ValueTransitionLabel *helpful_transition);
 
+    /*
+      Return the helpful transition stored with the cost and set cost to
+      the cached cost. Return nullptr if no finite cost is cached. This is
+      not counted in the statistics.
+    */
     domain_transition_graph::ValueTransitionLabel *lookup_helpful_transition(
-        int var, const State &state, int from_val, int to_val) const {
-        int index = get_index(var, state, from_val, to_val);
-        return helpful_transition_cache[var][index];
-    }
+        int var, const State &state, int from_val, int to_val, int &cost);
 
-    void store_helpful_transition(
-        int var, const State &state, int from_val, int to_val,
-        domain_transition_graph::ValueTransitionLabel *helpful_transition) {
-        int index = get_index(var, state, from_val, to_val);
-        helpful_transition_cache[var][index] = helpful_transition;
-    }
+    void print_statistics(utils::LogProxy &log) const;
 };
 }
 
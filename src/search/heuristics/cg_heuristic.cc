@@ -18,8 +18,9 @@ using namespace domain_transition_graph;
 namespace cg_heuristic {
 CGHeuristic::CGHeuristic(
     const shared_ptr<AbstractTask> &task, int max_cache_size,
-    tasks::AxiomHandlingType axioms, bool cache_estimates,
-    const string &description, utils::Verbosity verbosity)
+    int max_sparse_cache_size, tasks::AxiomHandlingType axioms,
+    bool cache_estimates, const string &description,
+    utils::Verbosity verbosity)
     : Heuristic(
           // issue1208 move this transformation to task-independent level?
           tasks::get_default_value_axioms_task_if_needed(task, axioms),
@@ -31,7 +32,8 @@ CGHeuristic::CGHeuristic(
     }
 
     if (max_cache_size > 0)
-        cache = make_unique<CGCache>(task_proxy, max_cache_size, log);
+        cache = make_unique<CGCache>(
+            task_proxy, max_cache_size, max_sparse_cache_size, log);
 
     unsigned int num_vars = task_proxy.get_variables().size();
     prio_queues.reserve(num_vars);
@@ -45,6 +47,11 @@ CGHeuristic::CGHeuristic(
     transition_graphs = factory.build_dtgs();
 }
 
+void CGHeuristic::print_statistics() const {
+    if (cache)
+        cache->print_statistics(log);
+}
+
 bool CGHeuristic::is_safe() const {
     return false;
 }
@@ -212,9 +219,7 @@ int CGHeuristic::get_transition_cost(
             ValueTransitionLabel *helpful = start->helpful_transitions[val];
             // We should have a helpful transition iff distance is infinite.
             assert((distance == numeric_limits<int>::max()) == !helpful);
-            cache->store(var_no, state, start_val, val, distance);
-            cache->store_helpful_transition(
-                var_no, state, start_val, val, helpful);
+            cache->store(var_no, state, start_val, val, distance, helpful);
         }
     }
 
@@ -252,19 +257,27 @@ void CGHeuristic::mark_helpful_transitions(
     dtg->last_helpful_transition_extraction_time =
         helpful_transition_extraction_counter;
 
-    ValueTransitionLabel *helpful;
-    int cost;
+    ValueTransitionLabel *helpful = nullptr;
+    int cost = 0;
     // Check cache.
     if (cache && cache->is_cached(var_no)) {
-        helpful = cache->lookup_helpful_transition(var_no, state, from, to);
-        cost = cache->lookup(var_no, state, from, to);
-        assert(helpful);
-    } else {
+        helpful =
+            cache->lookup_helpful_transition(var_no, state, from, to, cost);
+    }
+    if (!helpful) {
+        /*
+          The transition is not cached, or it was evicted from the bounded
+          cache after its cost was computed. In the latter case, the cost
+          might have been looked up in the cache, so we recompute it.
+        */
         ValueNode *start_node = &dtg->nodes[from];
+        if (start_node->helpful_transitions.empty())
+            get_transition_cost(state, dtg, from, to);
         assert(!start_node->helpful_transitions.empty());
         helpful = start_node->helpful_transitions[to];
         cost = start_node->distances[to];
     }
+    assert(helpful);
 
     OperatorProxy op = helpful->is_axiom
                            ? task_proxy.get_axioms()[helpful->op_id]
@@ -296,6 +309,13 @@ public:
             "max_cache_size",
             "maximum number of cached entries per variable (set to 0 to disable cache)",
             "1000000", plugins::Bounds("0", "infinity"));
+        add_option<int>(
+            "max_sparse_cache_size",
+            "maximum total number of cached entries for variables that need "
+            "more than max_cache_size entries. These entries are stored in "
+            "a hash table that evicts entries when it is full, using about "
+            "32 bytes per entry (set to 0 to not cache these variables)",
+            "1000000", plugins::Bounds("0", "100000000"));
         tasks::add_axioms_option_to_feature(*this);
         add_heuristic_options_to_feature(*this, "cg");
 
@@ -314,6 +334,7 @@ public:
         return components::make_auto_task_independent_component<
             CGHeuristic, Evaluator>(
             opts.get<int>("max_cache_size"),
+            opts.get<int>("max_sparse_cache_size"),
             tasks::get_axioms_arguments_from_options(opts),
             get_heuristic_arguments_from_options(opts));
     }
@@ -43,9 +43,11 @@ protected:
 public:
     CGHeuristic(
         const std::shared_ptr<AbstractTask> &task, int max_cache_size,
-        tasks::AxiomHandlingType axiom_hanlding, bool cache_estimates,
-        const std::string &description, utils::Verbosity verbosity);
+        int max_sparse_cache_size, tasks::AxiomHandlingType axiom_hanlding,
+        bool cache_estimates, const std::string &description,
+        utils::Verbosity verbosity);
     virtual bool is_safe() const override;
+    virtual void print_statistics() const override;
 };
 }
 
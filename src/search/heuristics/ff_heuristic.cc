@@ -12,8 +12,11 @@ namespace ff_heuristic {
 // construction and destruction
 FFHeuristic::FFHeuristic(
     const shared_ptr<AbstractTask> &task, tasks::AxiomHandlingType axioms,
-    bool cache_estimates, const string &description, utils::Verbosity verbosity)
-    : AdditiveHeuristic(task, axioms, cache_estimates, description, verbosity),
+    bool incremental, bool share_exploration, bool cache_estimates,
+    const string &description, utils::Verbosity verbosity)
+    : AdditiveHeuristic(
+          task, axioms, incremental, share_exploration, cache_estimates,
+          description, verbosity),
       relaxed_plan(task_proxy.get_operators().size(), false) {
     if (log.is_at_least_normal()) {
         log << "Initializing FF heuristic..." << endl;
@@ -75,7 +78,7 @@ public:
     FFHeuristicFeature() : TypedFeature("ff") {
         document_title("FF heuristic");
 
-        relaxation_heuristic::add_relaxation_heuristic_options_to_feature(
+        additive_heuristic::add_additive_heuristic_options_to_feature(
             *this, "ff");
 
         document_language_support("action costs", "supported");
@@ -92,8 +95,8 @@ public:
         const plugins::Options &opts) const override {
         return components::make_auto_task_independent_component<
             FFHeuristic, Evaluator>(
-            relaxation_heuristic::
-                get_relaxation_heuristic_arguments_from_options(opts));
+            additive_heuristic::get_additive_heuristic_arguments_from_options(
+                opts));
     }
 };
 
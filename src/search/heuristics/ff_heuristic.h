@@ -34,7 +34,8 @@ protected:
 public:
     FFHeuristic(
         const std::shared_ptr<AbstractTask> &task,
-        tasks::AxiomHandlingType axioms, bool cache_estimates,
+        tasks::AxiomHandlingType axioms, bool incremental,
+        bool share_exploration, bool cache_estimates,
         const std::string &description, utils::Verbosity verbosity);
 };
 }
@@ -2,29 +2,187 @@
 
 #include "../plugins/plugin.h"
 #include "../task_utils/task_properties.h"
+#include "../utils/collections.h"
 #include "../utils/logging.h"
+#include "../utils/system.h"
 
+#include <algorithm>
 #include <cassert>
+#include <iterator>
 #include <limits>
-#include <set>
 
 using namespace std;
 
 namespace hm_heuristic {
+static const int INF = numeric_limits<int>::max();
+
+static void collect_subsets(
+    const vector<int> &tuple, int max_size, int start, vector<int> &subset,
+    vector<vector<int>> &subsets) {
+    assert(max_size >= 1);
+    for (size_t i = start; i < tuple.size(); ++i) {
+        subset.push_back(tuple[i]);
+        subsets.push_back(subset);
+        if (static_cast<int>(subset.size()) < max_size) {
+            collect_subsets(tuple, max_size, i + 1, subset, subsets);
+        }
+        subset.pop_back();
+    }
+}
+
+int HMHeuristic::get_rank(const Tuple &tuple) const {
+    /*
+      The rank of the set {f_1, ..., f_k} with f_1 < ... < f_k is
+      rank_offsets[k] + sum_{i=1}^k (f_i choose i).
+    */
+    int size = tuple.size();
+    assert(size >= 1 && size <= m);
+    int64_t rank = rank_offsets[size];
+    for (int i = 0; i < size; ++i) {
+        rank += binomials[i + 1][tuple[i]];
+    }
+    return rank;
+}
+
+/*
+  Call the callback with the ranks of all non-empty subsets of the given
+  tuple with at most m facts that contain tuple[required_index] (or of all
+  subsets if required_index is -1). The subsets are enumerated by adding
+  facts in increasing order, so that the rank can be computed along the
+  way (see get_rank).
+*/
+template<typename Callback>
+void HMHeuristic::for_each_subset_rank(
+    const Tuple &tuple, int required_index, const Callback &callback,
+    int start, int size, int64_t partial_rank) const {
+    int end = tuple.size();
+    if (required_index >= start) {
+        // We may not skip the required fact.
+        end = required_index + 1;
+    }
+    for (int i = start; i < end; ++i) {
+        int64_t rank = partial_rank + binomials[size + 1][tuple[i]];
+        if (i >= required_index) {
+            callback(rank_offsets[size + 1] + rank);
+        }
+        if (size + 1 < m) {
+            for_each_subset_rank(
+                tuple, required_index, callback, i + 1, size + 1, rank);
+        }
+    }
+}
+
 HMHeuristic::HMHeuristic(
     const shared_ptr<AbstractTask> &task, int m, bool cache_estimates,
     const string &description, utils::Verbosity verbosity)
     : Heuristic(task, cache_estimates, description, verbosity),
       m(m),
       has_cond_effects(task_properties::has_conditional_effects(task_proxy)),
-      goals(task_properties::get_fact_pairs(task_proxy.get_goals())) {
+      was_updated(false),
+      current_time(0),
+      small_entry_update_time(0) {
     if (log.is_at_least_normal()) {
         log << "Using h^" << m << "." << endl;
-        log << "The implementation of the h^m heuristic is preliminary." << endl
-            << "It is SLOOOOOOOOOOOW." << endl
-            << "Please do not use this for comparison!" << endl;
     }
-    generate_all_tuples();
+    build_tables();
+    build_operators();
+    fact_update_times.resize(fact_offsets.back());
+    operator_times.resize(operators.size());
+    for (FactProxy goal : task_proxy.get_goals()) {
+        goals.push_back(get_fact(goal));
+    }
+    sort(goals.begin(), goals.end());
+    if (log.is_at_least_normal()) {
+        log << "h^" << m << " table entries: " << hm_table.size() << endl;
+    }
+}
+
+void HMHeuristic::build_tables() {
+    VariablesProxy variables = task_proxy.get_variables();
+    fact_offsets.reserve(variables.size() + 1);
+    int num_facts = 0;
+    for (VariableProxy var : variables) {
+        fact_offsets.push_back(num_facts);
+        num_facts += var.get_domain_size();
+    }
+    fact_offsets.push_back(num_facts);
+
+    // Cap the binomial coefficients so that their sums cannot overflow.
+    const int64_t cap = numeric_limits<int64_t>::max() / 2;
+    binomials.assign(m + 1, vector<int64_t>(num_facts + 1, 0));
+    fill(binomials[0].begin(), binomials[0].end(), 1);
+    for (int k = 1; k <= m; ++k) {
+        for (int n = 1; n <= num_facts; ++n) {
+            binomials[k][n] =
+                min(cap, binomials[k - 1][n - 1] + binomials[k][n - 1]);
+        }
+    }
+
+    rank_offsets.assign(m + 2, 0);
+    for (int k = 1; k <= m; ++k) {
+        rank_offsets[k + 1] =
+            min(cap, rank_offsets[k] + binomials[k][num_facts]);
+    }
+    int64_t num_entries = rank_offsets[m + 1];
+    if (num_entries > numeric_limits<int>::max()) {
+        cerr << "The h^" << m << " table would need " << num_entries
+             << " entries, which exceeds the supported maximum." << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_OUT_OF_MEMORY);
+    }
+    hm_table.resize(num_entries, INF);
+}
+
+void HMHeuristic::build_operators() {
+    OperatorsProxy ops = task_proxy.get_operators();
+    operators.reserve(ops.size());
+    Tuple scratch;
+    for (OperatorProxy op : ops) {
+        HMOperator hm_op;
+        for (FactProxy pre : op.get_preconditions()) {
+            hm_op.precondition.push_back(get_fact(pre));
+        }
+        sort(hm_op.precondition.begin(), hm_op.precondition.end());
+
+        // Conditions of conditional effects are ignored.
+        for (EffectProxy eff : op.get_effects()) {
+            FactProxy fact = eff.get_fact();
+            hm_op.effect.push_back(get_fact(fact));
+            hm_op.effect_vars.push_back(fact.get_variable().get_id());
+        }
+        utils::sort_unique(hm_op.effect);
+        utils::sort_unique(hm_op.effect_vars);
+        hm_op.cost = op.get_cost();
+
+        for_each_subset_rank(
+            hm_op.effect, -1, [&hm_op](int64_t rank) {
+                hm_op.effect_subset_ranks.push_back(rank);
+            });
+        /*
+          For m = 1, no subset can be extended, so update_hm_table skips
+          the extensions of the regression.
+        */
+        if (m > 1) {
+            collect_subsets(
+                hm_op.effect, m - 1, 0, scratch,
+                hm_op.extendable_effect_subsets);
+            stable_sort(
+                hm_op.extendable_effect_subsets.begin(),
+                hm_op.extendable_effect_subsets.end(),
+                [](const Tuple &t1, const Tuple &t2) {
+                    return t1.size() < t2.size();
+                });
+        }
+        operators.push_back(move(hm_op));
+    }
+}
+
+int HMHeuristic::get_precondition_fact(const HMOperator &op, int var) const {
+    auto it = lower_bound(
+        op.precondition.begin(), op.precondition.end(), fact_offsets[var]);
+    if (it != op.precondition.end() && *it < fact_offsets[var + 1]) {
+        return *it;
+    }
+    return -1;
 }
 
 bool HMHeuristic::is_safe() const {
@@ -36,222 +194,168 @@ int HMHeuristic::compute_heuristic(const State &ancestor_state) {
     if (task_properties::is_goal_state(task_proxy, state)) {
         return 0;
     } else {
-        Tuple s_tup = task_properties::get_fact_pairs(state);
-
-        init_hm_table(s_tup);
+        init_hm_table(state);
         update_hm_table();
 
         int h = eval(goals);
 
-        if (h == numeric_limits<int>::max())
+        if (h == INF)
             return DEAD_END;
         return h;
     }
 }
 
-void HMHeuristic::init_hm_table(const Tuple &t) {
-    for (auto &hm_ent : hm_table) {
-        const Tuple &tuple = hm_ent.first;
-        int h_val = check_tuple_in_tuple(tuple, t);
-        hm_table[tuple] = h_val;
+void HMHeuristic::init_hm_table(const State &state) {
+    fill(hm_table.begin(), hm_table.end(), INF);
+    state_facts.clear();
+    for (FactProxy fact : state) {
+        state_facts.push_back(get_fact(fact));
     }
+    for_each_subset_rank(
+        state_facts, -1, [this](int64_t rank) {hm_table[rank] = 0;});
+}
+
+bool HMHeuristic::is_outdated(const HMOperator &op, int op_time) const {
+    if (op_time == -1 || small_entry_update_time >= op_time)
+        return true;
+    for (int fact : op.precondition) {
+        if (fact_update_times[fact] >= op_time)
+            return true;
+    }
+    return false;
 }
 
 void HMHeuristic::update_hm_table() {
+    current_time = 0;
+    fill(fact_update_times.begin(), fact_update_times.end(), 0);
+    small_entry_update_time = 0;
+    fill(operator_times.begin(), operator_times.end(), -1);
+    int num_operators = operators.size();
     do {
         was_updated = false;
 
-        for (OperatorProxy op : task_proxy.get_operators()) {
-            Tuple pre = get_operator_pre(op);
-
-            int c1 = eval(pre);
-            if (c1 != numeric_limits<int>::max()) {
-                Tuple eff = get_operator_eff(op);
-                vector<Tuple> partial_effs;
-                generate_all_partial_tuples(eff, partial_effs);
-                for (Tuple &partial_eff : partial_effs) {
-                    update_hm_entry(partial_eff, c1 + op.get_cost());
-
-                    int eff_size = partial_eff.size();
-                    if (eff_size < m) {
-                        extend_tuple(partial_eff, op);
-                    }
+        for (int op_id = 0; op_id < num_operators; ++op_id) {
+            const HMOperator &op = operators[op_id];
+            if (!is_outdated(op, operator_times[op_id]))
+                continue;
+            operator_times[op_id] = ++current_time;
+
+            int c1 = eval(op.precondition);
+            if (c1 == INF)
+                continue;
+            bool updated_effect = false;
+            for (int rank : op.effect_subset_ranks) {
+                updated_effect |= update_hm_entry(rank, c1 + op.cost);
+            }
+            if (updated_effect) {
+                for (int fact : op.effect) {
+                    fact_update_times[fact] = current_time;
                 }
             }
+            if (!op.extendable_effect_subsets.empty()) {
+                regression = op.precondition;
+                others.clear();
+                extend_regression(op, 0, c1);
+            }
         }
     } while (was_updated);
 }
 
-void HMHeuristic::extend_tuple(const Tuple &t, const OperatorProxy &op) {
-    for (auto &hm_ent : hm_table) {
-        const Tuple &tuple = hm_ent.first;
-        bool contradict = false;
-        for (const FactPair &fact : tuple) {
-            if (contradict_effect_of(op, fact.var, fact.value)) {
-                contradict = true;
-                break;
+/*
+  Update the entries t + O for all extendable subsets t of the effect of
+  op and all sets O of facts on variables that op does not change, using
+  the cost of the regression of t + O through op, which is the
+  precondition of op plus O. Since all other facts contradict the
+  precondition or the effect, these are all extensions of t that op can
+  achieve. The facts in O are added one variable at a time, starting with
+  start_var, and "value" is the h^m value of the current regression.
+  Facts on effect variables that agree with the effect need no
+  extension because the first rule of the fixpoint computation already
+  covers them with a lower cost.
+*/
+void HMHeuristic::extend_regression(
+    const HMOperator &op, int start_var, int value) {
+    int num_vars = fact_offsets.size() - 1;
+    for (int var = start_var; var < num_vars; ++var) {
+        if (binary_search(op.effect_vars.begin(), op.effect_vars.end(), var))
+            continue;
+        int pre_fact = get_precondition_fact(op, var);
+        int begin = (pre_fact == -1) ? fact_offsets[var] : pre_fact;
+        int end = (pre_fact == -1) ? fact_offsets[var + 1] : pre_fact + 1;
+        for (int fact = begin; fact < end; ++fact) {
+            int new_value = value;
+            int index = -1;
+            if (fact != pre_fact) {
+                // The rank of the set {fact} is fact.
+                if (hm_table[fact] == INF)
+                    continue;
+                index = lower_bound(regression.begin(), regression.end(), fact)
+                    - regression.begin();
+                regression.insert(regression.begin() + index, fact);
+                new_value = max(value, eval_with_fact(index));
             }
-        }
-        if (!contradict && (tuple.size() > t.size()) &&
-            (check_tuple_in_tuple(t, tuple) == 0)) {
-            Tuple pre = get_operator_pre(op);
-
-            Tuple others;
-            for (const FactPair &fact : tuple) {
-                if (find(t.begin(), t.end(), fact) == t.end()) {
-                    others.push_back(fact);
-                    if (find(pre.begin(), pre.end(), fact) == pre.end()) {
-                        pre.push_back(fact);
+            if (new_value != INF) {
+                others.push_back(fact);
+                int num_others = others.size();
+                for (const Tuple &effect_subset :
+                     op.extendable_effect_subsets) {
+                    if (static_cast<int>(effect_subset.size()) + num_others >
+                        m)
+                        break;
+                    subset.clear();
+                    merge(
+                        effect_subset.begin(), effect_subset.end(),
+                        others.begin(), others.end(), back_inserter(subset));
+                    if (update_hm_entry(
+                            get_rank(subset), new_value + op.cost)) {
+                        for (int subset_fact : subset) {
+                            fact_update_times[subset_fact] = current_time;
+                        }
                     }
                 }
-            }
-
-            sort(pre.begin(), pre.end());
-
-            set<int> vars;
-            bool is_valid = true;
-            for (const FactPair &fact : pre) {
-                if (vars.count(fact.var) != 0) {
-                    is_valid = false;
-                    break;
+                if (num_others < m - 1) {
+                    extend_regression(op, var + 1, new_value);
                 }
-                vars.insert(fact.var);
+                others.pop_back();
             }
-
-            if (is_valid) {
-                int c2 = eval(pre);
-                if (c2 != numeric_limits<int>::max()) {
-                    update_hm_entry(tuple, c2 + op.get_cost());
-                }
-            }
-        }
-    }
-}
-
-int HMHeuristic::eval(const Tuple &t) const {
-    vector<Tuple> partial;
-    generate_all_partial_tuples(t, partial);
-    int max = 0;
-    for (Tuple &tuple : partial) {
-        assert(hm_table.count(tuple) == 1);
-
-        int h = hm_table.at(tuple);
-        if (h > max) {
-            max = h;
-        }
-    }
-    return max;
-}
-
-int HMHeuristic::update_hm_entry(const Tuple &t, int val) {
-    assert(hm_table.count(t) == 1);
-    if (hm_table[t] > val) {
-        hm_table[t] = val;
-        was_updated = true;
-    }
-    return val;
-}
-
-int HMHeuristic::check_tuple_in_tuple(
-    const Tuple &tuple, const Tuple &big_tuple) const {
-    for (const FactPair &fact0 : tuple) {
-        bool found = false;
-        for (auto &fact1 : big_tuple) {
-            if (fact0 == fact1) {
-                found = true;
-                break;
+            if (index != -1) {
+                regression.erase(regression.begin() + index);
             }
         }
-        if (!found) {
-            return numeric_limits<int>::max();
-        }
     }
-    return 0;
 }
 
-HMHeuristic::Tuple HMHeuristic::get_operator_pre(
-    const OperatorProxy &op) const {
-    Tuple preconditions =
-        task_properties::get_fact_pairs(op.get_preconditions());
-    sort(preconditions.begin(), preconditions.end());
-    return preconditions;
+int HMHeuristic::eval(const Tuple &tuple) const {
+    int result = 0;
+    for_each_subset_rank(
+        tuple, -1, [this, &result](int64_t rank) {
+            result = max(result, hm_table[rank]);
+        });
+    return result;
 }
 
-HMHeuristic::Tuple HMHeuristic::get_operator_eff(
-    const OperatorProxy &op) const {
-    Tuple effects;
-    for (EffectProxy eff : op.get_effects()) {
-        effects.push_back(eff.get_fact().get_pair());
-    }
-    sort(effects.begin(), effects.end());
-    return effects;
+int HMHeuristic::eval_with_fact(int index) const {
+    // Only consider the subsets of the regression that contain the new fact.
+    int result = 0;
+    for_each_subset_rank(
+        regression, index, [this, &result](int64_t rank) {
+            result = max(result, hm_table[rank]);
+        });
+    return result;
 }
 
-bool HMHeuristic::contradict_effect_of(
-    const OperatorProxy &op, int var, int val) const {
-    for (EffectProxy eff : op.get_effects()) {
-        FactProxy fact = eff.get_fact();
-        if (fact.get_variable().get_id() == var && fact.get_value() != val) {
-            return true;
+bool HMHeuristic::update_hm_entry(int rank, int val) {
+    if (hm_table[rank] > val) {
+        hm_table[rank] = val;
+        was_updated = true;
+        if (rank < rank_offsets[m]) {
+            small_entry_update_time = current_time;
         }
+        return true;
     }
     return false;
 }
 
-void HMHeuristic::generate_all_tuples() {
-    Tuple t;
-    generate_all_tuples_aux(0, m, t);
-}
-
-void HMHeuristic::generate_all_tuples_aux(int var, int sz, const Tuple &base) {
-    int num_variables = task_proxy.get_variables().size();
-    for (int i = var; i < num_variables; ++i) {
-        int domain_size = task_proxy.get_variables()[i].get_domain_size();
-        for (int j = 0; j < domain_size; ++j) {
-            Tuple tuple(base);
-            tuple.emplace_back(i, j);
-            hm_table[tuple] = 0;
-            if (sz > 1) {
-                generate_all_tuples_aux(i + 1, sz - 1, tuple);
-            }
-        }
-    }
-}
-
-void HMHeuristic::generate_all_partial_tuples(
-    const Tuple &base_tuple, vector<Tuple> &res) const {
-    Tuple t;
-    generate_all_partial_tuples_aux(base_tuple, t, 0, m, res);
-}
-
-void HMHeuristic::generate_all_partial_tuples_aux(
-    const Tuple &base_tuple, const Tuple &t, int index, int sz,
-    vector<Tuple> &res) const {
-    if (sz == 1) {
-        for (size_t i = index; i < base_tuple.size(); ++i) {
-            Tuple tuple(t);
-            tuple.push_back(base_tuple[i]);
-            res.push_back(tuple);
-        }
-    } else {
-        for (size_t i = index; i < base_tuple.size(); ++i) {
-            Tuple tuple(t);
-            tuple.push_back(base_tuple[i]);
-            res.push_back(tuple);
-            generate_all_partial_tuples_aux(
-                base_tuple, tuple, i + 1, sz - 1, res);
-        }
-    }
-}
-
-void HMHeuristic::dump_table() const {
-    if (log.is_at_least_debug()) {
-        for (auto &hm_ent : hm_table) {
-            log << "h(" << hm_ent.first << ") = " << hm_ent.second << endl;
-        }
-    }
-}
-
 class HMHeuristicFeature
     : public plugins::TypedFeature<TaskIndependentEvaluator> {
 public:
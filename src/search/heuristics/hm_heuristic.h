@@ -3,7 +3,7 @@
 
 #include "../heuristic.h"
 
-#include <map>
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -11,46 +11,86 @@ namespace hm_heuristic {
 /*
   Haslum's h^m heuristic family ("critical path heuristics").
 
-  This is a very slow implementation and should not be used for
-  speed benchmarks.
+  Facts are numbered consecutively, ordered by variable and value, and
+  tuples are sorted vectors of fact numbers. The h^m table is a dense
+  vector indexed by a perfect ranking of all sets of at most m facts
+  (combinatorial number system). It also contains entries for sets with
+  several facts of the same variable, which are never used. For N facts,
+  the table has sum_{k=1}^m (N choose k) entries, which is only feasible
+  for small m.
 */
-
 class HMHeuristic : public Heuristic {
-    using Tuple = std::vector<FactPair>;
+    using Tuple = std::vector<int>;
+
+    struct HMOperator {
+        Tuple precondition;
+        Tuple effect;
+        int cost;
+        // Ranks of all non-empty subsets of the effect with at most m facts.
+        std::vector<int> effect_subset_ranks;
+        // Non-empty subsets of the effect with less than m facts by size.
+        std::vector<Tuple> extendable_effect_subsets;
+        // Variables that occur in the effect (sorted).
+        std::vector<int> effect_vars;
+    };
+
     // parameters
     const int m;
     const bool has_cond_effects;
 
-    const Tuple goals;
+    // fact_offsets[var] is the number of the first fact of var.
+    std::vector<int> fact_offsets;
+    // binomials[k][n] is (n choose k), capped to avoid overflows.
+    std::vector<std::vector<int64_t>> binomials;
+    // rank_offsets[k] is the rank of the first set of size k.
+    std::vector<int64_t> rank_offsets;
+    std::vector<HMOperator> operators;
+    Tuple goals;
 
     // h^m table
-    std::map<Tuple, int> hm_table;
+    std::vector<int> hm_table;
     bool was_updated;
 
-    // auxiliary methods
-    void init_hm_table(const Tuple &t);
+    /*
+      An operator only reads entries that contain one of its precondition
+      facts or have less than m facts. In the fixpoint computation, it only
+      needs to be processed again if such an entry changed after it was
+      processed the last time. Times are counted in processed operators.
+    */
+    int current_time;
+    // Last time an entry containing the fact changed.
+    std::vector<int> fact_update_times;
+    // Last time an entry with less than m facts changed.
+    int small_entry_update_time;
+    // Last time the operator was processed (-1 if never).
+    std::vector<int> operator_times;
+
+    // Reused between calls to avoid allocations.
+    Tuple state_facts;
+    Tuple regression;
+    Tuple others;
+    Tuple subset;
+
+    int get_fact(const FactProxy &fact) const {
+        return fact_offsets[fact.get_variable().get_id()] + fact.get_value();
+    }
+    void build_tables();
+    void build_operators();
+    int get_precondition_fact(const HMOperator &op, int var) const;
+
+    int get_rank(const Tuple &tuple) const;
+    template<typename Callback>
+    void for_each_subset_rank(
+        const Tuple &tuple, int required_index, const Callback &callback,
+        int start = 0, int size = 0, int64_t partial_rank = 0) const;
+
+    void init_hm_table(const State &state);
+    bool is_outdated(const HMOperator &op, int op_time) const;
     void update_hm_table();
-    int eval(const Tuple &t) const;
-    int update_hm_entry(const Tuple &t, int val);
-    void extend_tuple(const Tuple &t, const OperatorProxy &op);
-
-    int check_tuple_in_tuple(const Tuple &tuple, const Tuple &big_tuple) const;
-
-    int get_operator_pre_value(const OperatorProxy &op, int var) const;
-    Tuple get_operator_pre(const OperatorProxy &op) const;
-    Tuple get_operator_eff(const OperatorProxy &op) const;
-    bool contradict_effect_of(const OperatorProxy &op, int var, int val) const;
-
-    void generate_all_tuples();
-    void generate_all_tuples_aux(int var, int sz, const Tuple &base);
-
-    void generate_all_partial_tuples(
-        const Tuple &base_tuple, std::vector<Tuple> &res) const;
-    void generate_all_partial_tuples_aux(
-        const Tuple &base_tuple, const Tuple &t, int index, int sz,
-        std::vector<Tuple> &res) const;
-
-    void dump_table() const;
+    void extend_regression(const HMOperator &op, int start_var, int value);
+    int eval(const Tuple &tuple) const;
+    int eval_with_fact(int index) const;
+    bool update_hm_entry(int rank, int val);
 
 protected:
     virtual int compute_heuristic(const State &ancestor_state) override;
@@ -6,9 +6,11 @@
 
 #include "../plugins/plugin.h"
 #include "../task_utils/task_properties.h"
+#include "../utils/collections.h"
 #include "../utils/logging.h"
 #include "../utils/markup.h"
 
+#include <algorithm>
 #include <iostream>
 
 using namespace std;
@@ -16,22 +18,85 @@ using namespace std;
 namespace lm_cut_heuristic {
 LandmarkCutHeuristic::LandmarkCutHeuristic(
     const shared_ptr<AbstractTask> &task, bool use_goal_zone_detection,
-    bool use_border_detection, bool cache_estimates, const string &description,
-    utils::Verbosity verbosity)
+    bool use_border_detection, bool incremental, bool cache_estimates,
+    const string &description, utils::Verbosity verbosity)
     : Heuristic(task, cache_estimates, description, verbosity),
       landmark_generator(make_unique<LandmarkCutLandmarks>(
-          task_proxy, use_goal_zone_detection, use_border_detection)) {
+          task_proxy, use_goal_zone_detection, use_border_detection)),
+      incremental(incremental),
+      generating_operators(make_pair(StateID::no_state, -1)),
+      parent_id(StateID::no_state) {
     if (log.is_at_least_normal()) {
         log << "Initializing landmark cut heuristic..." << endl;
     }
 }
 
+void LandmarkCutHeuristic::notify_state_transition(
+    const State &parent_state, OperatorID op_id, const State &state) {
+    if (parent_state.get_id() != parent_id) {
+        /*
+          The landmarks of the parent are no longer needed once it is
+          expanded. If the parent has no stored landmarks (e.g., because
+          it is expanded again), its successors are computed from scratch.
+        */
+        parent_id = parent_state.get_id();
+        LandmarksWithCosts &landmarks = state_landmarks[parent_state];
+        parent_landmarks = move(landmarks);
+        utils::release_vector_memory(landmarks);
+    }
+    generating_operators[state] = make_pair(parent_id, op_id.get_index());
+}
+
+bool LandmarkCutHeuristic::get_seed_landmarks(const State &state) {
+    auto [generating_parent_id, op_id] = generating_operators[state];
+    if (generating_parent_id != parent_id) {
+        return false;
+    }
+
+    /*
+      Every plan for the state can be extended to a plan for the parent by
+      prepending the operator. Hence, each landmark of the parent that does
+      not contain the operator must be used by every plan for the state.
+    */
+    seed_landmarks.clear();
+    for (const auto &entry : parent_landmarks) {
+        const vector<int> &landmark = entry.first;
+        if (find(landmark.begin(), landmark.end(), op_id) == landmark.end()) {
+            seed_landmarks.push_back(entry);
+        }
+    }
+    return !seed_landmarks.empty();
+}
+
 int LandmarkCutHeuristic::compute_heuristic(const State &ancestor_state) {
     State state = convert_ancestor_state(ancestor_state);
     int total_cost = 0;
-    bool dead_end = landmark_generator->compute_landmarks(
-        state, [&total_cost](int cut_cost) { total_cost += cut_cost; },
-        nullptr);
+    auto cost_callback = [&total_cost](int cut_cost) {
+        total_cost += cut_cost;
+    };
+    // Only registered states can be parents in later transitions.
+    LandmarksWithCosts *landmarks = nullptr;
+    LandmarkCutLandmarks::LandmarkCallback landmark_callback = nullptr;
+    if (incremental && ancestor_state.get_registry()) {
+        landmarks = &state_landmarks[ancestor_state];
+        landmarks->clear();
+        landmark_callback = [landmarks](
+                                const LandmarkCutLandmarks::Landmark &landmark,
+                                int cost) {
+            landmarks->emplace_back(landmark, cost);
+        };
+    }
+    bool dead_end;
+    if (landmarks && get_seed_landmarks(ancestor_state)) {
+        dead_end = landmark_generator->compute_landmarks_from_seed(
+            state, seed_landmarks, cost_callback, landmark_callback);
+    } else {
+        dead_end = landmark_generator->compute_landmarks(
+            state, cost_callback, landmark_callback);
+    }
+    if (dead_end && landmarks) {
+        utils::release_vector_memory(*landmarks);
+    }
 
     if (dead_end)
         return DEAD_END;
@@ -54,9 +119,35 @@ public:
                 "https://fai.cs.uni-saarland.de/lauer/papers/hsdip2020.pdf",
                 "Proceedings of the 12th Workshop on Heuristic Search for "
                 "Domain-Independent Planning (HSDIP 2020)",
-                "9-15", "", "2020"));
+                "9-15", "", "2020") +
+            "The option {{{incremental}}} is based on the following paper:" +
+            utils::format_conference_reference(
+                {"Florian Pommerening", "Malte Helmert"}, "Incremental LM-Cut",
+                "https://ai.dmi.unibas.ch/papers/"
+                "pommerening-helmert-icaps2013.pdf",
+                "Proceedings of the 23rd International Conference on "
+                "Automated Planning and Scheduling (ICAPS 2013)",
+                "162-170", "AAAI Press", "2013"));
 
         add_landmark_cut_landmarks_options_to_feature(*this);
+        add_option<bool>(
+            "incremental",
+            "Compute the landmarks of a state incrementally from the "
+            "landmarks of the state from which it was generated: the "
+            "landmarks of the parent state that do not contain the "
+            "generating operator are kept with their costs, and further "
+            "cuts are only computed for the remaining operator costs. "
+            "The resulting estimates are path-dependent: they depend on "
+            "the parent through which a state is reached and can be lower "
+            "or higher than the LM-cut value of the state. They are always "
+            "admissible. The landmarks of each evaluated state are stored "
+            "until the state is expanded, which needs memory for all "
+            "landmarks of the open states. Landmarks are only reused "
+            "by search algorithms that notify path-dependent evaluators "
+            "about state transitions (e.g., eager search). Otherwise, and "
+            "if no landmark of the parent can be reused, the landmarks are "
+            "computed from scratch.",
+            "false");
         add_heuristic_options_to_feature(*this, "lmcut");
 
         document_language_support("action costs", "supported");
@@ -74,6 +165,7 @@ public:
         return components::make_auto_task_independent_component<
             LandmarkCutHeuristic, Evaluator>(
             get_landmark_cut_landmarks_arguments_from_options(opts),
+            opts.get<bool>("incremental"),
             get_heuristic_arguments_from_options(opts));
     }
 };
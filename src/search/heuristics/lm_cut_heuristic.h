@@ -2,8 +2,11 @@
 #define HEURISTICS_LM_CUT_HEURISTIC_H
 
 #include "../heuristic.h"
+#include "../per_state_information.h"
 
 #include <memory>
+#include <utility>
+#include <vector>
 
 namespace lm_cut_heuristic {
 class LandmarkCutLandmarks;
@@ -11,12 +14,41 @@ class LandmarkCutLandmarks;
 class LandmarkCutHeuristic : public Heuristic {
     std::unique_ptr<LandmarkCutLandmarks> landmark_generator;
 
+    using LandmarksWithCosts = std::vector<std::pair<std::vector<int>, int>>;
+
+    /*
+      With incremental computation, we store the landmarks computed for
+      each evaluated state until the state is expanded. For the successors
+      of the last expanded state (the parent), we store the parent and the
+      generating operator. The landmarks of the parent that do not contain
+      the operator leading to a successor are landmarks of the successor
+      and are used as a seed there.
+    */
+    const bool incremental;
+    PerStateInformation<LandmarksWithCosts> state_landmarks;
+    PerStateInformation<std::pair<StateID, int>> generating_operators;
+    StateID parent_id;
+    LandmarksWithCosts parent_landmarks;
+    LandmarksWithCosts seed_landmarks;
+
+    bool get_seed_landmarks(const State &state);
     virtual int compute_heuristic(const State &ancestor_state) override;
 public:
     LandmarkCutHeuristic(
         const std::shared_ptr<AbstractTask> &task, bool use_goal_zone_detection,
-        bool use_border_detection, bool cache_estimates,
+        bool use_border_detection, bool incremental, bool cache_estimates,
         const std::string &description, utils::Verbosity verbosity);
+
+    virtual void get_path_dependent_evaluators(
+        std::set<Evaluator *> &evals) override {
+        if (incremental) {
+            evals.insert(this);
+        }
+    }
+
+    virtual void notify_state_transition(
+        const State &parent_state, OperatorID op_id,
+        const State &state) override;
 };
 }
 
@@ -2,6 +2,7 @@
 
 #include "../plugins/plugin.h"
 #include "../task_utils/task_properties.h"
+#include "../utils/collections.h"
 
 #include <algorithm>
 #include <limits>
@@ -22,90 +23,97 @@ LandmarkCutLandmarks::LandmarkCutLandmarks(
     task_properties::verify_no_conditional_effects(task_proxy);
 
     // Build propositions.
-    num_propositions = 2; // artificial goal and artificial precondition
     VariablesProxy variables = task_proxy.get_variables();
-    propositions.resize(variables.size());
-    for (FactProxy fact : variables.get_facts()) {
-        int var_id = fact.get_variable().get_id();
-        propositions[var_id].push_back(RelaxedProposition());
-        ++num_propositions;
+    proposition_offsets.reserve(variables.size());
+    PropID num_facts = 0;
+    for (VariableProxy var : variables) {
+        proposition_offsets.push_back(num_facts);
+        num_facts += var.get_domain_size();
+    }
+    artificial_precondition = num_facts;
+    artificial_goal = num_facts + 1;
+    num_propositions = num_facts + 2;
+    propositions.resize(num_propositions);
+
+    // Build relaxed operators for operators.
+    OperatorsProxy operators = task_proxy.get_operators();
+    int num_relaxed_operators = operators.size() + 1;
+    relaxed_operators.resize(num_relaxed_operators);
+    operator_base_costs.reserve(num_relaxed_operators);
+    preconditions_offsets.reserve(num_relaxed_operators + 1);
+    preconditions_offsets.push_back(0);
+    effects_offsets.reserve(num_relaxed_operators + 1);
+    effects_offsets.push_back(0);
+    vector<PropID> precondition;
+    vector<PropID> effect;
+    for (OperatorProxy op : operators) {
+        precondition.clear();
+        effect.clear();
+        for (FactProxy pre : op.get_preconditions()) {
+            precondition.push_back(get_proposition(pre));
+        }
+        for (EffectProxy eff : op.get_effects()) {
+            effect.push_back(get_proposition(eff.get_fact()));
+        }
+        add_relaxed_operator(precondition, effect, op.get_cost());
     }
 
-    // Build relaxed operators for operators and axioms.
-    for (OperatorProxy op : task_proxy.get_operators())
-        build_relaxed_operator(op);
-
-    // Simplify relaxed operators.
-    // simplify();
-    /* TODO: Put this back in and test if it makes sense,
-       but only after trying out whether and how much the change to
-       unary operators hurts. */
-
-    // Build artificial goal proposition and operator.
-    vector<RelaxedProposition *> goal_op_pre, goal_op_eff;
+    // Build artificial goal operator. It gets the last operator ID.
+    precondition.clear();
     for (FactProxy goal : task_proxy.get_goals()) {
-        goal_op_pre.push_back(get_proposition(goal));
+        precondition.push_back(get_proposition(goal));
     }
-    goal_op_eff.push_back(&artificial_goal);
-    /* Use the invalid operator ID -1 so accessing
-       the artificial operator will generate an error. */
-    add_relaxed_operator(move(goal_op_pre), move(goal_op_eff), -1, 0);
+    add_relaxed_operator(precondition, {artificial_goal}, 0);
 
     // Cross-reference relaxed operators.
-    for (RelaxedOperator &op : relaxed_operators) {
-        for (RelaxedProposition *pre : op.preconditions)
-            pre->precondition_of.push_back(&op);
-        for (RelaxedProposition *eff : op.effects)
-            eff->effect_of.push_back(&op);
-    }
-}
-
-void LandmarkCutLandmarks::build_relaxed_operator(const OperatorProxy &op) {
-    vector<RelaxedProposition *> precondition;
-    vector<RelaxedProposition *> effects;
-    for (FactProxy pre : op.get_preconditions()) {
-        precondition.push_back(get_proposition(pre));
-    }
-    for (EffectProxy eff : op.get_effects()) {
-        effects.push_back(get_proposition(eff.get_fact()));
+    vector<vector<OpID>> precondition_of_by_prop(num_propositions);
+    vector<vector<OpID>> effect_of_by_prop(num_propositions);
+    for (OpID op_id = 0; op_id < num_relaxed_operators; ++op_id) {
+        for (PropID pre : get_preconditions(op_id))
+            precondition_of_by_prop[pre].push_back(op_id);
+        for (PropID eff : get_effects(op_id))
+            effect_of_by_prop[eff].push_back(op_id);
     }
-    add_relaxed_operator(
-        move(precondition), move(effects), op.get_id(), op.get_cost());
+    utils::flatten_vectors(
+        precondition_of_by_prop, precondition_of_offsets, precondition_of);
+    utils::flatten_vectors(effect_of_by_prop, effect_of_offsets, effect_of);
 }
 
 void LandmarkCutLandmarks::add_relaxed_operator(
-    vector<RelaxedProposition *> &&precondition,
-    vector<RelaxedProposition *> &&effects, int op_id, int base_cost) {
-    RelaxedOperator relaxed_op(
-        move(precondition), move(effects), op_id, base_cost);
-    if (relaxed_op.preconditions.empty())
-        relaxed_op.preconditions.push_back(&artificial_precondition);
-    relaxed_operators.push_back(relaxed_op);
+    const vector<PropID> &precondition, const vector<PropID> &effect,
+    int base_cost) {
+    if (precondition.empty()) {
+        preconditions.push_back(artificial_precondition);
+    } else {
+        preconditions.insert(
+            preconditions.end(), precondition.begin(), precondition.end());
+    }
+    preconditions_offsets.push_back(preconditions.size());
+    effects.insert(effects.end(), effect.begin(), effect.end());
+    effects_offsets.push_back(effects.size());
+    operator_base_costs.push_back(base_cost);
 }
 
-RelaxedProposition *LandmarkCutLandmarks::get_proposition(
-    const FactProxy &fact) {
+PropID LandmarkCutLandmarks::get_proposition(const FactProxy &fact) const {
     int var_id = fact.get_variable().get_id();
     int val = fact.get_value();
-    return &propositions[var_id][val];
+    return proposition_offsets[var_id] + val;
 }
 
 // heuristic computation
 void LandmarkCutLandmarks::setup_exploration_queue() {
     priority_queue.clear();
 
-    for (auto &var_props : propositions) {
-        for (RelaxedProposition &prop : var_props) {
-            prop.status = UNREACHED;
-        }
+    for (RelaxedProposition &prop : propositions) {
+        prop.status = UNREACHED;
     }
 
-    artificial_goal.status = UNREACHED;
-    artificial_precondition.status = UNREACHED;
-
-    for (RelaxedOperator &op : relaxed_operators) {
-        op.unsatisfied_preconditions = op.preconditions.size();
-        op.h_max_supporter = nullptr;
+    int num_relaxed_operators = relaxed_operators.size();
+    for (OpID op_id = 0; op_id < num_relaxed_operators; ++op_id) {
+        RelaxedOperator &op = relaxed_operators[op_id];
+        op.unsatisfied_preconditions =
+            preconditions_offsets[op_id + 1] - preconditions_offsets[op_id];
+        op.h_max_supporter = NO_PROP;
         op.h_max_supporter_cost = numeric_limits<int>::max();
     }
 }
@@ -114,7 +122,7 @@ void LandmarkCutLandmarks::setup_exploration_queue_state(const State &state) {
     for (FactProxy init_fact : state) {
         enqueue_if_necessary(get_proposition(init_fact), 0);
     }
-    enqueue_if_necessary(&artificial_precondition, 0);
+    enqueue_if_necessary(artificial_precondition, 0);
 }
 
 void LandmarkCutLandmarks::first_exploration(const State &state) {
@@ -122,23 +130,22 @@ void LandmarkCutLandmarks::first_exploration(const State &state) {
     setup_exploration_queue();
     setup_exploration_queue_state(state);
     while (!priority_queue.empty()) {
-        pair<int, RelaxedProposition *> top_pair = priority_queue.pop();
+        pair<int, PropID> top_pair = priority_queue.pop();
         int popped_cost = top_pair.first;
-        RelaxedProposition *prop = top_pair.second;
-        int prop_cost = prop->h_max_cost;
+        PropID prop_id = top_pair.second;
+        int prop_cost = propositions[prop_id].h_max_cost;
         assert(prop_cost <= popped_cost);
         if (prop_cost < popped_cost)
             continue;
-        const vector<RelaxedOperator *> &triggered_operators =
-            prop->precondition_of;
-        for (RelaxedOperator *relaxed_op : triggered_operators) {
-            --relaxed_op->unsatisfied_preconditions;
-            assert(relaxed_op->unsatisfied_preconditions >= 0);
-            if (relaxed_op->unsatisfied_preconditions == 0) {
-                relaxed_op->h_max_supporter = prop;
-                relaxed_op->h_max_supporter_cost = prop_cost;
-                int target_cost = prop_cost + relaxed_op->cost;
-                for (RelaxedProposition *effect : relaxed_op->effects) {
+        for (OpID op_id : get_precondition_of(prop_id)) {
+            RelaxedOperator &relaxed_op = relaxed_operators[op_id];
+            --relaxed_op.unsatisfied_preconditions;
+            assert(relaxed_op.unsatisfied_preconditions >= 0);
+            if (relaxed_op.unsatisfied_preconditions == 0) {
+                relaxed_op.h_max_supporter = prop_id;
+                relaxed_op.h_max_supporter_cost = prop_cost;
+                int target_cost = prop_cost + relaxed_op.cost;
+                for (PropID effect : get_effects(op_id)) {
                     enqueue_if_necessary(effect, target_cost);
                 }
             }
@@ -146,8 +153,7 @@ void LandmarkCutLandmarks::first_exploration(const State &state) {
     }
 }
 
-void LandmarkCutLandmarks::first_exploration_incremental(
-    vector<RelaxedOperator *> &cut) {
+void LandmarkCutLandmarks::first_exploration_incremental(vector<OpID> &cut) {
     assert(priority_queue.empty());
     /* We pretend that this queue has had as many pushes already as we
        have propositions to avoid switching from bucket-based to
@@ -155,32 +161,32 @@ void LandmarkCutLandmarks::first_exploration_incremental(
        to heap-based in problems where action costs are at most 1.
     */
     priority_queue.add_virtual_pushes(num_propositions);
-    for (RelaxedOperator *relaxed_op : cut) {
-        int cost = relaxed_op->h_max_supporter_cost + relaxed_op->cost;
-        for (RelaxedProposition *effect : relaxed_op->effects)
+    for (OpID op_id : cut) {
+        const RelaxedOperator &relaxed_op = relaxed_operators[op_id];
+        int cost = relaxed_op.h_max_supporter_cost + relaxed_op.cost;
+        for (PropID effect : get_effects(op_id))
             enqueue_if_necessary(effect, cost);
     }
     while (!priority_queue.empty()) {
-        pair<int, RelaxedProposition *> top_pair = priority_queue.pop();
+        pair<int, PropID> top_pair = priority_queue.pop();
         int popped_cost = top_pair.first;
-        RelaxedProposition *prop = top_pair.second;
-        int prop_cost = prop->h_max_cost;
+        PropID prop_id = top_pair.second;
+        int prop_cost = propositions[prop_id].h_max_cost;
         assert(prop_cost <= popped_cost);
         if (prop_cost < popped_cost)
             continue;
-        const vector<RelaxedOperator *> &triggered_operators =
-            prop->precondition_of;
-        for (RelaxedOperator *relaxed_op : triggered_operators) {
-            if (relaxed_op->h_max_supporter == prop) {
-                int old_supp_cost = relaxed_op->h_max_supporter_cost;
+        for (OpID op_id : get_precondition_of(prop_id)) {
+            RelaxedOperator &relaxed_op = relaxed_operators[op_id];
+            if (relaxed_op.h_max_supporter == prop_id) {
+                int old_supp_cost = relaxed_op.h_max_supporter_cost;
                 if (old_supp_cost > prop_cost) {
-                    relaxed_op->update_h_max_supporter();
-                    int new_supp_cost = relaxed_op->h_max_supporter_cost;
+                    update_h_max_supporter(op_id);
+                    int new_supp_cost = relaxed_op.h_max_supporter_cost;
                     if (new_supp_cost != old_supp_cost) {
                         // This operator has become cheaper.
                         assert(new_supp_cost < old_supp_cost);
-                        int target_cost = new_supp_cost + relaxed_op->cost;
-                        for (RelaxedProposition *effect : relaxed_op->effects)
+                        int target_cost = new_supp_cost + relaxed_op.cost;
+                        for (PropID effect : get_effects(op_id))
                             enqueue_if_necessary(effect, target_cost);
                     }
                 }
@@ -190,41 +196,41 @@ void LandmarkCutLandmarks::first_exploration_incremental(
 }
 
 void LandmarkCutLandmarks::second_exploration(
-    const State &state, vector<RelaxedProposition *> &second_exploration_queue,
-    vector<RelaxedOperator *> &cut) {
+    const State &state, vector<PropID> &second_exploration_queue,
+    vector<OpID> &cut) {
     assert(second_exploration_queue.empty());
     assert(cut.empty());
 
-    artificial_precondition.status = BEFORE_GOAL_ZONE;
-    second_exploration_queue.push_back(&artificial_precondition);
+    propositions[artificial_precondition].status = BEFORE_GOAL_ZONE;
+    second_exploration_queue.push_back(artificial_precondition);
 
     for (FactProxy init_fact : state) {
-        RelaxedProposition *init_prop = get_proposition(init_fact);
-        init_prop->status = BEFORE_GOAL_ZONE;
+        PropID init_prop = get_proposition(init_fact);
+        propositions[init_prop].status = BEFORE_GOAL_ZONE;
         second_exploration_queue.push_back(init_prop);
     }
 
     while (!second_exploration_queue.empty()) {
-        RelaxedProposition *prop = second_exploration_queue.back();
+        PropID prop_id = second_exploration_queue.back();
         second_exploration_queue.pop_back();
-        const vector<RelaxedOperator *> &triggered_operators =
-            prop->precondition_of;
-        for (RelaxedOperator *relaxed_op : triggered_operators) {
-            if (relaxed_op->h_max_supporter == prop) {
+        for (OpID op_id : get_precondition_of(prop_id)) {
+            const RelaxedOperator &relaxed_op = relaxed_operators[op_id];
+            if (relaxed_op.h_max_supporter == prop_id) {
                 bool reached_goal_zone = false;
-                for (RelaxedProposition *effect : relaxed_op->effects) {
-                    if (effect->status == GOAL_ZONE) {
-                        assert(relaxed_op->cost > 0);
+                for (PropID effect : get_effects(op_id)) {
+                    if (propositions[effect].status == GOAL_ZONE) {
+                        assert(relaxed_op.cost > 0);
                         reached_goal_zone = true;
-                        cut.push_back(relaxed_op);
+                        cut.push_back(op_id);
                         break;
                     }
                 }
                 if (!reached_goal_zone) {
-                    for (RelaxedProposition *effect : relaxed_op->effects) {
-                        if (effect->status != BEFORE_GOAL_ZONE) {
-                            assert(effect->status == REACHED);
-                            effect->status = BEFORE_GOAL_ZONE;
+                    for (PropID effect : get_effects(op_id)) {
+                        RelaxedProposition &prop = propositions[effect];
+                        if (prop.status != BEFORE_GOAL_ZONE) {
+                            assert(prop.status == REACHED);
+                            prop.status = BEFORE_GOAL_ZONE;
                             second_exploration_queue.push_back(effect);
                         }
                     }
@@ -234,47 +240,48 @@ void LandmarkCutLandmarks::second_exploration(
     }
 }
 
-static bool has_no_zero_cost_achiever(const RelaxedProposition *prop) {
-    for (const RelaxedOperator *op : prop->effect_of) {
-        if (op->cost == 0) {
+bool LandmarkCutLandmarks::has_no_zero_cost_achiever(PropID prop_id) const {
+    for (OpID op_id : get_effect_of(prop_id)) {
+        if (relaxed_operators[op_id].cost == 0) {
             return false;
         }
     }
     return true;
 }
 
-void LandmarkCutLandmarks::break_supporter_ties(RelaxedOperator *op) {
+void LandmarkCutLandmarks::break_supporter_ties(OpID op_id) {
     if (dont_tie_break) {
         return;
     }
-    for (RelaxedProposition *pre : op->preconditions) {
-        if (pre->h_max_cost != op->h_max_supporter_cost) {
+    RelaxedOperator &op = relaxed_operators[op_id];
+    for (PropID pre : get_preconditions(op_id)) {
+        if (propositions[pre].h_max_cost != op.h_max_supporter_cost) {
             continue;
         }
         if (use_border_detection && has_no_zero_cost_achiever(pre)) {
-            op->h_max_supporter = pre;
+            op.h_max_supporter = pre;
             break;
         }
-        if (use_goal_zone_detection && pre->status == GOAL_ZONE) {
-            op->h_max_supporter = pre;
+        if (use_goal_zone_detection && propositions[pre].status == GOAL_ZONE) {
+            op.h_max_supporter = pre;
             break;
         }
     }
 }
 
-void LandmarkCutLandmarks::mark_goal_plateau(RelaxedProposition *subgoal) {
+void LandmarkCutLandmarks::mark_goal_plateau(PropID subgoal) {
     /*
-      NOTE: subgoal can be null if we got here via recursion through
+      NOTE: subgoal can be NO_PROP if we got here via recursion through
       a zero-cost action that is relaxed unreachable. (This can only
       happen in domains which have zero-cost actions to start with.)
       For example, this happens in pegsol-strips #01.
     */
-    if (subgoal && subgoal->status != GOAL_ZONE) {
-        subgoal->status = GOAL_ZONE;
-        for (RelaxedOperator *achiever : subgoal->effect_of)
-            if (achiever->cost == 0) {
+    if (subgoal != NO_PROP && propositions[subgoal].status != GOAL_ZONE) {
+        propositions[subgoal].status = GOAL_ZONE;
+        for (OpID achiever : get_effect_of(subgoal))
+            if (relaxed_operators[achiever].cost == 0) {
                 break_supporter_ties(achiever);
-                mark_goal_plateau(achiever->h_max_supporter);
+                mark_goal_plateau(relaxed_operators[achiever].h_max_supporter);
             }
     }
 }
@@ -286,24 +293,26 @@ void LandmarkCutLandmarks::validate_h_max() const {
       variables when using NDEBUG. This whole code does nothing useful
       when assertions are switched off anyway.
     */
-    for (const RelaxedOperator &op : relaxed_operators) {
+    int num_relaxed_operators = relaxed_operators.size();
+    for (OpID op_id = 0; op_id < num_relaxed_operators; ++op_id) {
+        const RelaxedOperator &op = relaxed_operators[op_id];
         if (op.unsatisfied_preconditions) {
             bool reachable = true;
-            for (RelaxedProposition *pre : op.preconditions) {
-                if (pre->status == UNREACHED) {
+            for (PropID pre : get_preconditions(op_id)) {
+                if (propositions[pre].status == UNREACHED) {
                     reachable = false;
                     break;
                 }
             }
             assert(!reachable);
-            assert(!op.h_max_supporter);
+            assert(op.h_max_supporter == NO_PROP);
         } else {
-            assert(op.h_max_supporter);
+            assert(op.h_max_supporter != NO_PROP);
             int h_max_cost = op.h_max_supporter_cost;
-            assert(h_max_cost == op.h_max_supporter->h_max_cost);
-            for (RelaxedProposition *pre : op.preconditions) {
-                assert(pre->status != UNREACHED);
-                assert(pre->h_max_cost <= h_max_cost);
+            assert(h_max_cost == propositions[op.h_max_supporter].h_max_cost);
+            for (PropID pre : get_preconditions(op_id)) {
+                assert(propositions[pre].status != UNREACHED);
+                assert(propositions[pre].h_max_cost <= h_max_cost);
             }
         }
     }
@@ -313,42 +322,79 @@ void LandmarkCutLandmarks::validate_h_max() const {
 bool LandmarkCutLandmarks::compute_landmarks(
     const State &state, const CostCallback &cost_callback,
     const LandmarkCallback &landmark_callback) {
-    for (RelaxedOperator &op : relaxed_operators) {
-        op.cost = op.base_cost;
+    int num_relaxed_operators = relaxed_operators.size();
+    for (OpID op_id = 0; op_id < num_relaxed_operators; ++op_id) {
+        relaxed_operators[op_id].cost = operator_base_costs[op_id];
+    }
+    return compute_cuts(state, cost_callback, landmark_callback);
+}
+
+bool LandmarkCutLandmarks::compute_landmarks_from_seed(
+    const State &state, const vector<pair<Landmark, int>> &seed_landmarks,
+    const CostCallback &cost_callback,
+    const LandmarkCallback &landmark_callback) {
+    int num_relaxed_operators = relaxed_operators.size();
+    for (OpID op_id = 0; op_id < num_relaxed_operators; ++op_id) {
+        relaxed_operators[op_id].cost = operator_base_costs[op_id];
+    }
+    for (const auto &[landmark, cost] : seed_landmarks) {
+        for (int op_id : landmark) {
+            RelaxedOperator &op = relaxed_operators[op_id];
+            op.cost -= cost;
+            assert(op.cost >= 0);
+        }
+    }
+    bool dead_end = compute_cuts(state, cost_callback, landmark_callback);
+    if (!dead_end) {
+        for (const auto &[landmark, cost] : seed_landmarks) {
+            if (cost_callback) {
+                cost_callback(cost);
+            }
+            if (landmark_callback) {
+                landmark_callback(landmark, cost);
+            }
+        }
     }
+    return dead_end;
+}
+
+bool LandmarkCutLandmarks::compute_cuts(
+    const State &state, const CostCallback &cost_callback,
+    const LandmarkCallback &landmark_callback) {
     /*
       The following three variables could be declared inside the loop
       ("second_exploration_queue" even inside second_exploration),
       but having them here saves reallocations and hence provides a
       measurable speed boost.
     */
-    vector<RelaxedOperator *> cut;
+    vector<OpID> cut;
     Landmark landmark;
-    vector<RelaxedProposition *> second_exploration_queue;
+    vector<PropID> second_exploration_queue;
     first_exploration(state);
     // validate_h_max();  // too expensive to use even in regular debug mode
-    if (artificial_goal.status == UNREACHED)
+    if (propositions[artificial_goal].status == UNREACHED)
         return true;
 
-    while (artificial_goal.h_max_cost != 0) {
-        mark_goal_plateau(&artificial_goal);
+    while (propositions[artificial_goal].h_max_cost != 0) {
+        mark_goal_plateau(artificial_goal);
         assert(cut.empty());
         second_exploration(state, second_exploration_queue, cut);
         assert(!cut.empty());
         int cut_cost = numeric_limits<int>::max();
-        for (RelaxedOperator *op : cut)
-            cut_cost = min(cut_cost, op->cost);
-        for (RelaxedOperator *op : cut)
-            op->cost -= cut_cost;
+        for (OpID op_id : cut)
+            cut_cost = min(cut_cost, relaxed_operators[op_id].cost);
+        for (OpID op_id : cut)
+            relaxed_operators[op_id].cost -= cut_cost;
 
         if (cost_callback) {
             cost_callback(cut_cost);
         }
         if (landmark_callback) {
-            landmark.clear();
-            for (RelaxedOperator *op : cut) {
-                landmark.push_back(op->original_op_id);
-            }
+            /*
+              The artificial goal operator has no cost and can therefore
+              never be part of a cut, so all IDs are operator IDs.
+            */
+            landmark.assign(cut.begin(), cut.end());
             landmark_callback(landmark, cut_cost);
         }
 
@@ -362,14 +408,10 @@ bool LandmarkCutLandmarks::compute_landmarks(
           or something based on total_cost, so that we don't need a per-round
           reinitialization.
         */
-        for (auto &var_props : propositions) {
-            for (RelaxedProposition &prop : var_props) {
-                if (prop.status == GOAL_ZONE || prop.status == BEFORE_GOAL_ZONE)
-                    prop.status = REACHED;
-            }
+        for (RelaxedProposition &prop : propositions) {
+            if (prop.status == GOAL_ZONE || prop.status == BEFORE_GOAL_ZONE)
+                prop.status = REACHED;
         }
-        artificial_goal.status = REACHED;
-        artificial_precondition.status = REACHED;
     }
     return false;
 }
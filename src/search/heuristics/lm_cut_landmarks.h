@@ -6,9 +6,12 @@
 #include "../algorithms/priority_queues.h"
 
 #include <cassert>
+#include <cstdint>
 #include <functional>
 #include <memory>
+#include <span>
 #include <tuple>
+#include <utility>
 #include <vector>
 
 namespace plugins {
@@ -18,45 +21,31 @@ class Options;
 
 namespace lm_cut_heuristic {
 // TODO: Fix duplication with the other relaxation heuristics.
-struct RelaxedProposition;
+using PropID = int32_t;
+using OpID = int32_t;
 
-enum PropositionStatus {
+const PropID NO_PROP = -1;
+
+enum PropositionStatus : int32_t {
     UNREACHED = 0,
     REACHED = 1,
     GOAL_ZONE = 2,
     BEFORE_GOAL_ZONE = 3
 };
 
+/*
+  RelaxedOperator and RelaxedProposition only contain the data that the
+  explorations read and write for every state. The structure of the relaxed
+  task is stored separately in LandmarkCutLandmarks.
+*/
 struct RelaxedOperator {
-    int original_op_id;
-    std::vector<RelaxedProposition *> preconditions;
-    std::vector<RelaxedProposition *> effects;
-    int base_cost; // 0 for axioms, 1 for regular operators
-
     int cost;
     int unsatisfied_preconditions;
     int h_max_supporter_cost; // h_max_cost of h_max_supporter
-    RelaxedProposition *h_max_supporter;
-    RelaxedOperator(
-        std::vector<RelaxedProposition *> &&pre,
-        std::vector<RelaxedProposition *> &&eff, int op_id, int base)
-        : original_op_id(op_id),
-          preconditions(pre),
-          effects(eff),
-          base_cost(base),
-          cost(-1),
-          unsatisfied_preconditions(-1),
-          h_max_supporter_cost(-1),
-          h_max_supporter(nullptr) {
-    }
-
-    inline void update_h_max_supporter();
+    PropID h_max_supporter;
 };
 
 struct RelaxedProposition {
-    std::vector<RelaxedOperator *> precondition_of;
-    std::vector<RelaxedOperator *> effect_of;
-
     PropositionStatus status;
     int h_max_cost;
 };
@@ -66,44 +55,87 @@ class LandmarkCutLandmarks {
     bool use_border_detection;
     bool dont_tie_break;
 
+    /*
+      Relaxed operators are indexed by the IDs of the operators of the task,
+      followed by the artificial goal operator. Propositions are indexed
+      by fact, followed by the artificial precondition and goal.
+    */
     std::vector<RelaxedOperator> relaxed_operators;
-    std::vector<std::vector<RelaxedProposition>> propositions;
-    RelaxedProposition artificial_precondition;
-    RelaxedProposition artificial_goal;
+    std::vector<RelaxedProposition> propositions;
+    std::vector<int> operator_base_costs;
+    std::vector<PropID> proposition_offsets; // Indexed by variable.
+    PropID artificial_precondition;
+    PropID artificial_goal;
     int num_propositions;
-    priority_queues::AdaptiveQueue<RelaxedProposition *> priority_queue;
 
-    void build_relaxed_operator(const OperatorProxy &op);
+    /*
+      Adjacency lists in compressed sparse row format: the entries for
+      index i are stored in positions offsets[i] to offsets[i + 1] - 1.
+    */
+    std::vector<int> preconditions_offsets;
+    std::vector<PropID> preconditions;
+    std::vector<int> effects_offsets;
+    std::vector<PropID> effects;
+    std::vector<int> precondition_of_offsets;
+    std::vector<OpID> precondition_of;
+    std::vector<int> effect_of_offsets;
+    std::vector<OpID> effect_of;
+
+    priority_queues::AdaptiveQueue<PropID> priority_queue;
+
     void add_relaxed_operator(
-        std::vector<RelaxedProposition *> &&precondition,
-        std::vector<RelaxedProposition *> &&effects, int op_id, int base_cost);
-    RelaxedProposition *get_proposition(const FactProxy &fact);
+        const std::vector<PropID> &precondition,
+        const std::vector<PropID> &effect, int base_cost);
+    PropID get_proposition(const FactProxy &fact) const;
+    std::span<const PropID> get_preconditions(OpID op_id) const {
+        return {preconditions.data() + preconditions_offsets[op_id],
+                preconditions.data() + preconditions_offsets[op_id + 1]};
+    }
+    std::span<const PropID> get_effects(OpID op_id) const {
+        return {effects.data() + effects_offsets[op_id],
+                effects.data() + effects_offsets[op_id + 1]};
+    }
+    std::span<const OpID> get_precondition_of(PropID prop_id) const {
+        return {precondition_of.data() + precondition_of_offsets[prop_id],
+                precondition_of.data() + precondition_of_offsets[prop_id + 1]};
+    }
+    std::span<const OpID> get_effect_of(PropID prop_id) const {
+        return {effect_of.data() + effect_of_offsets[prop_id],
+                effect_of.data() + effect_of_offsets[prop_id + 1]};
+    }
+
     void setup_exploration_queue();
     void setup_exploration_queue_state(const State &state);
     void first_exploration(const State &state);
-    void first_exploration_incremental(std::vector<RelaxedOperator *> &cut);
+    void first_exploration_incremental(std::vector<OpID> &cut);
     void second_exploration(
-        const State &state,
-        std::vector<RelaxedProposition *> &second_exploration_queue,
-        std::vector<RelaxedOperator *> &cut);
+        const State &state, std::vector<PropID> &second_exploration_queue,
+        std::vector<OpID> &cut);
 
-    void enqueue_if_necessary(RelaxedProposition *prop, int cost) {
+    void enqueue_if_necessary(PropID prop_id, int cost) {
         assert(cost >= 0);
-        if (prop->status == UNREACHED || prop->h_max_cost > cost) {
-            prop->status = REACHED;
-            prop->h_max_cost = cost;
-            priority_queue.push(cost, prop);
+        RelaxedProposition &prop = propositions[prop_id];
+        if (prop.status == UNREACHED || prop.h_max_cost > cost) {
+            prop.status = REACHED;
+            prop.h_max_cost = cost;
+            priority_queue.push(cost, prop_id);
         }
     }
 
-    void break_supporter_ties(RelaxedOperator *op);
-    void mark_goal_plateau(RelaxedProposition *subgoal);
+    inline void update_h_max_supporter(OpID op_id);
+    bool has_no_zero_cost_achiever(PropID prop_id) const;
+    void break_supporter_ties(OpID op_id);
+    void mark_goal_plateau(PropID subgoal);
     void validate_h_max() const;
 public:
     using Landmark = std::vector<int>;
     using CostCallback = std::function<void(int)>;
     using LandmarkCallback = std::function<void(const Landmark &, int)>;
-
+private:
+    bool compute_cuts(
+        const State &state, const CostCallback &cost_callback,
+        const LandmarkCallback &landmark_callback);
+public:
     LandmarkCutLandmarks(
         const TaskProxy &task_proxy, bool use_goal_zone_detection,
         bool use_border_detection);
@@ -124,14 +156,40 @@ public:
     bool compute_landmarks(
         const State &state, const CostCallback &cost_callback,
         const LandmarkCallback &landmark_callback);
+
+    /*
+      Like compute_landmarks, but start from the given seed landmarks with
+      their costs instead of computing all cuts. The seed landmarks must
+      form a cost partitioning, i.e., for each operator the costs of the
+      seed landmarks containing it may not exceed the operator cost. The
+      remaining operator costs are used for computing further cuts. Unless
+      the state is a dead end, the seed landmarks are reported to the
+      callbacks after the computed ones.
+
+      The result is a set of landmarks with an admissible cost partitioning
+      for the state if all seed landmarks are landmarks of the state.
+      The sum of their costs can be lower than the LM-cut value of the
+      state, but it is never lower than the sum of the seed costs.
+    */
+    bool compute_landmarks_from_seed(
+        const State &state,
+        const std::vector<std::pair<Landmark, int>> &seed_landmarks,
+        const CostCallback &cost_callback,
+        const LandmarkCallback &landmark_callback);
 };
 
-inline void RelaxedOperator::update_h_max_supporter() {
-    assert(!unsatisfied_preconditions);
-    for (size_t i = 0; i < preconditions.size(); ++i)
-        if (preconditions[i]->h_max_cost > h_max_supporter->h_max_cost)
-            h_max_supporter = preconditions[i];
-    h_max_supporter_cost = h_max_supporter->h_max_cost;
+inline void LandmarkCutLandmarks::update_h_max_supporter(OpID op_id) {
+    RelaxedOperator &op = relaxed_operators[op_id];
+    assert(!op.unsatisfied_preconditions);
+    int supporter_cost = propositions[op.h_max_supporter].h_max_cost;
+    for (PropID pre : get_preconditions(op_id)) {
+        int cost = propositions[pre].h_max_cost;
+        if (cost > supporter_cost) {
+            op.h_max_supporter = pre;
+            supporter_cost = cost;
+        }
+    }
+    op.h_max_supporter_cost = supporter_cost;
 }
 
 extern void add_landmark_cut_landmarks_options_to_feature(
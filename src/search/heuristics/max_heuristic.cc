@@ -10,90 +10,103 @@ using namespace std;
 
 namespace max_heuristic {
 /*
-  TODO: At the time of this writing, this shares huge amounts of code
-        with h^add, and the two should be refactored so that the
-        common code is only included once, in so far as this is
-        possible without sacrificing run-time. We may want to avoid
-        virtual calls in the inner-most loops; maybe a templated
-        strategy pattern is an option. Right now, the only differences
-        to the h^add code are the use of max() instead of add() and
-        the lack of preferred operator support (but we might actually
-        reintroduce that if it doesn't hurt performance too much).
+  TODO: The setup of the queue and the incremental repair are shared
+        with h^add in RelaxationHeuristic, where the repair receives the
+        cost computation as a template parameter. The explorations from
+        scratch are still separate copies, which only differ in the use
+        of max() instead of add(), and could be shared the same way.
+        h^max also lacks preferred operator support (but we might
+        actually reintroduce that if it doesn't hurt performance too
+        much).
  */
 
 // construction and destruction
 HSPMaxHeuristic::HSPMaxHeuristic(
     const shared_ptr<AbstractTask> &task, tasks::AxiomHandlingType axioms,
-    bool cache_estimates, const string &description, utils::Verbosity verbosity)
+    bool incremental, bool cache_estimates, const string &description,
+    utils::Verbosity verbosity)
     : RelaxationHeuristic(
-          task, axioms, cache_estimates, description, verbosity) {
+          task, axioms, incremental, false, cache_estimates, description,
+          verbosity) {
     if (log.is_at_least_normal()) {
         log << "Initializing HSP max heuristic..." << endl;
     }
 }
 
 // heuristic computation
-void HSPMaxHeuristic::setup_exploration_queue() {
-    queue.clear();
-
-    for (Proposition &prop : propositions)
-        prop.cost = -1;
-
-    // Deal with operators and axioms without preconditions.
-    for (UnaryOperator &op : unary_operators) {
-        op.unsatisfied_preconditions = op.num_preconditions;
-        op.cost = op.base_cost; // will be increased by precondition costs
-
-        if (op.unsatisfied_preconditions == 0)
-            enqueue_if_necessary(op.effect, op.base_cost);
-    }
-}
-
-void HSPMaxHeuristic::setup_exploration_queue_state(const State &state) {
-    for (FactProxy fact : state) {
-        PropID init_prop = get_prop_id(fact);
-        enqueue_if_necessary(init_prop, 0);
-    }
-}
-
 void HSPMaxHeuristic::relaxed_exploration() {
     int unsolved_goals = goal_propositions.size();
     while (!queue.empty()) {
         pair<int, PropID> top_pair = queue.pop();
         int distance = top_pair.first;
         PropID prop_id = top_pair.second;
-        Proposition *prop = get_proposition(prop_id);
-        int prop_cost = prop->cost;
+        int prop_cost = proposition_costs[prop_id];
         assert(prop_cost >= 0);
         assert(prop_cost <= distance);
         if (prop_cost < distance)
             continue;
-        if (prop->is_goal && --unsolved_goals == 0)
+        // Incremental explorations need the complete fixpoint.
+        if (get_proposition(prop_id)->is_goal && --unsolved_goals == 0 &&
+            !incremental)
             return;
-        for (OpID op_id : precondition_of_pool.get_slice(
-                 prop->precondition_of, prop->num_precondition_occurences)) {
-            UnaryOperator *unary_op = get_operator(op_id);
-            unary_op->cost =
-                max(unary_op->cost, unary_op->base_cost + prop_cost);
-            --unary_op->unsatisfied_preconditions;
-            assert(unary_op->unsatisfied_preconditions >= 0);
-            if (unary_op->unsatisfied_preconditions == 0)
-                enqueue_if_necessary(unary_op->effect, unary_op->cost);
+        for (OpID op_id : get_precondition_of(prop_id)) {
+            int &unsatisfied = unsatisfied_preconditions[op_id];
+            --unsatisfied;
+            assert(unsatisfied >= 0);
+            if (unsatisfied == 0) {
+                /*
+                  Propositions are dequeued in order of increasing cost,
+                  so the last satisfied precondition is the most expensive
+                  one. This way, the loop only touches one array for all
+                  other preconditions.
+                */
+                int &op_cost = operator_costs[op_id];
+                op_cost = operator_base_costs[op_id] + prop_cost;
+                enqueue_if_necessary(
+                    get_operator(op_id)->effect, op_cost, op_id);
+            }
         }
     }
 }
 
+int HSPMaxHeuristic::compute_unary_operator_cost(OpID op_id) {
+    int max_precond_cost = 0;
+    for (PropID precond : get_preconditions(op_id)) {
+        int precond_cost = proposition_costs[precond];
+        if (precond_cost == -1)
+            return -1;
+        max_precond_cost = max(max_precond_cost, precond_cost);
+    }
+    return operator_base_costs[op_id] + max_precond_cost;
+}
+
+void HSPMaxHeuristic::update_exploration_incrementally(const State &state) {
+    bool repaired = RelaxationHeuristic::update_exploration_incrementally(
+        state, [this](OpID op_id) {
+            return compute_unary_operator_cost(op_id);
+        });
+    if (!repaired) {
+        setup_exploration_queue();
+        setup_exploration_queue_state(state);
+        relaxed_exploration();
+        set_explored_state(&state, true);
+    }
+}
+
 int HSPMaxHeuristic::compute_heuristic(const State &ancestor_state) {
     State state = convert_ancestor_state(ancestor_state);
 
-    setup_exploration_queue();
-    setup_exploration_queue_state(state);
-    relaxed_exploration();
+    if (incremental) {
+        update_exploration_incrementally(state);
+    } else {
+        setup_exploration_queue();
+        setup_exploration_queue_state(state);
+        relaxed_exploration();
+    }
 
     int total_cost = 0;
     for (PropID goal_id : goal_propositions) {
-        const Proposition *goal = get_proposition(goal_id);
-        int goal_cost = goal->cost;
+        int goal_cost = proposition_costs[goal_id];
         if (goal_cost == -1)
             return DEAD_END;
         total_cost = max(total_cost, goal_cost);
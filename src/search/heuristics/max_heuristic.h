@@ -3,40 +3,28 @@
 
 #include "relaxation_heuristic.h"
 
-#include "../algorithms/priority_queues.h"
-
-#include <cassert>
-
 namespace max_heuristic {
 using relaxation_heuristic::OpID;
 using relaxation_heuristic::PropID;
 
+using relaxation_heuristic::NO_OP;
+
 using relaxation_heuristic::Proposition;
 using relaxation_heuristic::UnaryOperator;
 
 class HSPMaxHeuristic : public relaxation_heuristic::RelaxationHeuristic {
-    priority_queues::AdaptiveQueue<PropID> queue;
-
-    void setup_exploration_queue();
-    void setup_exploration_queue_state(const State &state);
     void relaxed_exploration();
-
-    void enqueue_if_necessary(PropID prop_id, int cost) {
-        assert(cost >= 0);
-        Proposition *prop = get_proposition(prop_id);
-        if (prop->cost == -1 || prop->cost > cost) {
-            prop->cost = cost;
-            queue.push(cost, prop_id);
-        }
-        assert(prop->cost != -1 && prop->cost <= cost);
-    }
+    void update_exploration_incrementally(const State &state);
+    // Return -1 if a precondition is unreached.
+    int compute_unary_operator_cost(OpID op_id);
 protected:
     virtual int compute_heuristic(const State &ancestor_state) override;
 public:
     HSPMaxHeuristic(
         const std::shared_ptr<AbstractTask> &task,
-        tasks::AxiomHandlingType axioms, bool cache_estimates,
-        const std::string &description, utils::Verbosity verbosity);
+        tasks::AxiomHandlingType axioms, bool incremental,
+        bool cache_estimates, const std::string &description,
+        utils::Verbosity verbosity);
 };
 }
 
@@ -3,12 +3,15 @@
 #include "../plugins/plugin.h"
 #include "../task_utils/task_properties.h"
 #include "../utils/collections.h"
+#include "../utils/hash.h"
 #include "../utils/logging.h"
 #include "../utils/timer.h"
 
 #include <algorithm>
 #include <cassert>
 #include <cstddef>
+#include <memory>
+#include <mutex>
 #include <unordered_map>
 #include <vector>
 
@@ -16,11 +19,7 @@ using namespace std;
 
 namespace relaxation_heuristic {
 Proposition::Proposition()
-    : cost(-1),
-      reached_by(NO_OP),
-      is_goal(false),
-      marked(false),
-      num_precondition_occurences(-1) {
+    : reached_by(NO_OP), is_goal(false), marked(false) {
 }
 
 UnaryOperator::UnaryOperator(
@@ -36,24 +35,33 @@ UnaryOperator::UnaryOperator(
 void add_relaxation_heuristic_options_to_feature(
     plugins::Feature &feature, const string &description) {
     tasks::add_axioms_option_to_feature(feature);
+    feature.add_option<bool>(
+        "incremental",
+        "Keep the relaxed exploration of the last evaluated state and only "
+        "repair the costs that are affected by the facts in which the "
+        "next state differs, instead of exploring from scratch. This pays "
+        "off if consecutively evaluated states are similar, e.g., siblings "
+        "in eager search. The exploration cannot stop once all goals are "
+        "reached, so it can be slower if states differ a lot. Heuristic "
+        "values are the same, but ties between best achievers can be "
+        "broken differently, which can change relaxed plans and preferred "
+        "operators.",
+        "false");
     add_heuristic_options_to_feature(feature, description);
 }
 
-tuple<tasks::AxiomHandlingType, bool, string, utils::Verbosity>
+tuple<tasks::AxiomHandlingType, bool, bool, string, utils::Verbosity>
 get_relaxation_heuristic_arguments_from_options(const plugins::Options &opts) {
     return tuple_cat(
         tasks::get_axioms_arguments_from_options(opts),
+        make_tuple(opts.get<bool>("incremental")),
         get_heuristic_arguments_from_options(opts));
 }
 
 // construction and destruction
-RelaxationHeuristic::RelaxationHeuristic(
-    const shared_ptr<AbstractTask> &task, tasks::AxiomHandlingType axioms,
-    bool cache_estimates, const string &description, utils::Verbosity verbosity)
-    : Heuristic(
-          // issue1208 move this transformation to task-independent level?
-          tasks::get_default_value_axioms_task_if_needed(task, axioms),
-          cache_estimates, description, verbosity) {
+RelaxedExploration::RelaxedExploration(
+    const TaskProxy &task_proxy, utils::LogProxy &log)
+    : is_fixpoint(false) {
     // Build propositions.
     propositions.resize(task_properties::get_num_facts(task_proxy));
 
@@ -85,52 +93,211 @@ RelaxationHeuristic::RelaxationHeuristic(
 
     // Simplify unary operators.
     utils::Timer simplify_timer;
-    simplify();
+    simplify(log);
     if (log.is_at_least_normal()) {
         log << "time to simplify: " << simplify_timer << endl;
     }
 
     // Cross-reference unary operators.
-    vector<vector<OpID>> precondition_of_vectors(propositions.size());
-
+    int num_propositions = propositions.size();
     int num_unary_ops = unary_operators.size();
+    vector<vector<OpID>> precondition_of_vectors(num_propositions);
+    vector<vector<OpID>> achiever_vectors(num_propositions);
     for (OpID op_id = 0; op_id < num_unary_ops; ++op_id) {
         for (PropID precond : get_preconditions(op_id))
             precondition_of_vectors[precond].push_back(op_id);
+        achiever_vectors[unary_operators[op_id].effect].push_back(op_id);
     }
+    utils::flatten_vectors(
+        precondition_of_vectors, precondition_of_offsets, precondition_of);
+    utils::flatten_vectors(achiever_vectors, achievers_offsets, achievers);
+
+    // Build the data for the explorations.
+    proposition_costs.resize(num_propositions, -1);
+    operator_costs.resize(num_unary_ops);
+    unsatisfied_preconditions.resize(num_unary_ops);
+    operator_base_costs.reserve(num_unary_ops);
+    operator_num_preconditions.reserve(num_unary_ops);
+    for (OpID op_id = 0; op_id < num_unary_ops; ++op_id) {
+        const UnaryOperator &op = unary_operators[op_id];
+        operator_base_costs.push_back(op.base_cost);
+        operator_num_preconditions.push_back(op.num_preconditions);
+        if (op.num_preconditions == 0)
+            operators_without_preconditions.push_back(op_id);
+    }
+    is_invalidated.resize(num_propositions, false);
+}
 
-    int num_propositions = propositions.size();
-    for (PropID prop_id = 0; prop_id < num_propositions; ++prop_id) {
-        const auto &precondition_of_vec = precondition_of_vectors[prop_id];
-        propositions[prop_id].precondition_of =
-            precondition_of_pool.append(precondition_of_vec);
-        propositions[prop_id].num_precondition_occurences =
-            precondition_of_vec.size();
+void RelaxedExploration::reset_exploration() {
+    fill(proposition_costs.begin(), proposition_costs.end(), -1);
+    copy(
+        operator_base_costs.begin(), operator_base_costs.end(),
+        operator_costs.begin());
+    copy(
+        operator_num_preconditions.begin(), operator_num_preconditions.end(),
+        unsatisfied_preconditions.begin());
+}
+
+void RelaxedExploration::set_explored_state(
+    const State *state, bool is_fixpoint) {
+    if (state) {
+        int num_variables = proposition_offsets.size();
+        explored_state_values.resize(num_variables);
+        for (int var = 0; var < num_variables; ++var)
+            explored_state_values[var] = (*state)[var].get_value();
+        this->is_fixpoint = is_fixpoint;
+    } else {
+        explored_state_values.clear();
+        this->is_fixpoint = false;
     }
 }
 
-PropID RelaxationHeuristic::get_prop_id(int var, int value) const {
-    return proposition_offsets[var] + value;
+bool RelaxedExploration::is_explored(const State &state) const {
+    if (explored_state_values.empty())
+        return false;
+    int num_variables = explored_state_values.size();
+    for (int var = 0; var < num_variables; ++var) {
+        if (explored_state_values[var] != state[var].get_value())
+            return false;
+    }
+    return true;
 }
 
-PropID RelaxationHeuristic::get_prop_id(const FactProxy &fact) const {
-    return get_prop_id(fact.get_variable().get_id(), fact.get_value());
+bool RelaxedExploration::invalidate_changed_propositions(
+    const State &state, int max_invalidated_props, vector<PropID> &added_props,
+    vector<PropID> &invalidated_props) {
+    assert(added_props.empty() && invalidated_props.empty());
+    if (!is_fixpoint)
+        return false;
+
+    int num_variables = explored_state_values.size();
+    for (int var = 0; var < num_variables; ++var) {
+        int old_value = explored_state_values[var];
+        int new_value = state[var].get_value();
+        if (old_value != new_value) {
+            PropID old_prop = get_prop_id(var, old_value);
+            invalidated_props.push_back(old_prop);
+            is_invalidated[old_prop] = true;
+            added_props.push_back(get_prop_id(var, new_value));
+        }
+    }
+
+    // Invalidate the propositions whose best achiever depends on an
+    // invalidated proposition.
+    for (size_t i = 0; i < invalidated_props.size(); ++i) {
+        if (static_cast<int>(invalidated_props.size()) > max_invalidated_props)
+            break;
+        for (OpID op_id : get_precondition_of(invalidated_props[i])) {
+            PropID effect = unary_operators[op_id].effect;
+            if (!is_invalidated[effect] &&
+                propositions[effect].reached_by == op_id) {
+                invalidated_props.push_back(effect);
+                is_invalidated[effect] = true;
+            }
+        }
+    }
+
+    bool too_many =
+        static_cast<int>(invalidated_props.size()) > max_invalidated_props;
+    for (PropID prop_id : invalidated_props) {
+        is_invalidated[prop_id] = false;
+        if (!too_many) {
+            proposition_costs[prop_id] = -1;
+            propositions[prop_id].reached_by = NO_OP;
+        }
+    }
+    if (too_many) {
+        added_props.clear();
+        invalidated_props.clear();
+        return false;
+    }
+    set_explored_state(&state, true);
+    return true;
 }
 
-const Proposition *RelaxationHeuristic::get_proposition(
-    int var, int value) const {
-    return &propositions[get_prop_id(var, value)];
+static shared_ptr<RelaxedExploration> get_exploration(
+    const shared_ptr<AbstractTask> &task, tasks::AxiomHandlingType axioms,
+    bool share_exploration, const TaskProxy &relaxed_task_proxy,
+    utils::LogProxy &log) {
+    if (!share_exploration)
+        return make_shared<RelaxedExploration>(relaxed_task_proxy, log);
+
+    /*
+      The explorations are stored by the original task and the axiom
+      handling because the task with default value axioms is created
+      separately for each heuristic. The original task outlives the
+      heuristics, so the entry of an expired exploration can only be
+      reused for the same task. Expired entries are removed on every
+      lookup. The mutex protects the map if heuristics are created by
+      several threads. Explorations are never shared across threads
+      because every thread uses its own task (see hda_astar_search.cc).
+    */
+    using Key = pair<TaskID, int>;
+    static utils::HashMap<Key, weak_ptr<RelaxedExploration>> explorations;
+    static mutex explorations_mutex;
+    lock_guard<mutex> lock(explorations_mutex);
+    erase_if(explorations, [](const auto &entry) {
+        return entry.second.expired();
+    });
+    Key key(TaskProxy(*task).get_id(), static_cast<int>(axioms));
+    shared_ptr<RelaxedExploration> exploration = explorations[key].lock();
+    if (exploration) {
+        if (log.is_at_least_normal()) {
+            log << "Sharing relaxed exploration with another heuristic."
+                << endl;
+        }
+    } else {
+        exploration = make_shared<RelaxedExploration>(relaxed_task_proxy, log);
+        explorations[key] = exploration;
+    }
+    return exploration;
 }
 
-Proposition *RelaxationHeuristic::get_proposition(int var, int value) {
-    return &propositions[get_prop_id(var, value)];
+RelaxationHeuristic::RelaxationHeuristic(
+    const shared_ptr<AbstractTask> &task, tasks::AxiomHandlingType axioms,
+    bool incremental, bool share_exploration, bool cache_estimates,
+    const string &description, utils::Verbosity verbosity)
+    : Heuristic(
+          // issue1208 move this transformation to task-independent level?
+          tasks::get_default_value_axioms_task_if_needed(task, axioms),
+          cache_estimates, description, verbosity),
+      exploration(
+          get_exploration(task, axioms, share_exploration, task_proxy, log)),
+      unary_operators(exploration->unary_operators),
+      propositions(exploration->propositions),
+      goal_propositions(exploration->goal_propositions),
+      proposition_costs(exploration->proposition_costs),
+      operator_costs(exploration->operator_costs),
+      unsatisfied_preconditions(exploration->unsatisfied_preconditions),
+      operator_base_costs(exploration->operator_base_costs),
+      incremental(incremental) {
+}
+
+void RelaxationHeuristic::setup_exploration_queue() {
+    queue.clear();
+
+    // Operator costs will be increased by precondition costs.
+    reset_exploration();
+
+    // Deal with operators and axioms without preconditions.
+    for (OpID op_id : get_operators_without_preconditions()) {
+        enqueue_if_necessary(
+            get_operator(op_id)->effect, operator_costs[op_id], op_id);
+    }
+}
+
+void RelaxationHeuristic::setup_exploration_queue_state(const State &state) {
+    for (FactProxy fact : state) {
+        PropID init_prop = get_prop_id(fact);
+        enqueue_if_necessary(init_prop, 0, NO_OP);
+    }
 }
 
-Proposition *RelaxationHeuristic::get_proposition(const FactProxy &fact) {
-    return get_proposition(fact.get_variable().get_id(), fact.get_value());
+PropID RelaxedExploration::get_prop_id(const FactProxy &fact) const {
+    return get_prop_id(fact.get_variable().get_id(), fact.get_value());
 }
 
-void RelaxationHeuristic::build_unary_operators(const OperatorProxy &op) {
+void RelaxedExploration::build_unary_operators(const OperatorProxy &op) {
     int op_no = op.is_axiom() ? -1 : op.get_id();
     int base_cost = op.get_cost();
     vector<PropID> precondition_props;
@@ -161,7 +328,7 @@ void RelaxationHeuristic::build_unary_operators(const OperatorProxy &op) {
     }
 }
 
-void RelaxationHeuristic::simplify() {
+void RelaxedExploration::simplify(utils::LogProxy &log) {
     /*
       Remove dominated unary operators, including duplicates.
 
@@ -253,7 +420,8 @@ void RelaxationHeuristic::simplify() {
           map.
         */
 
-        OpID op_id = get_op_id(op);
+        OpID op_id = &op - unary_operators.data();
+        assert(utils::in_bounds(op_id, unary_operators));
         int cost = op.base_cost;
 
         const vector<PropID> precondition = get_preconditions_vector(op_id);
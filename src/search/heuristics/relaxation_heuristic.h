@@ -5,15 +5,20 @@
 
 #include "../heuristic.h"
 
+#include "../algorithms/priority_queues.h"
 #include "../tasks/default_value_axioms_task.h"
-#include "../utils/collections.h"
 
 #include <cassert>
+#include <span>
 #include <vector>
 
 class FactProxy;
 class OperatorProxy;
 
+namespace utils {
+class LogProxy;
+}
+
 namespace relaxation_heuristic {
 struct Proposition;
 struct UnaryOperator;
@@ -23,28 +28,27 @@ using OpID = int;
 
 const OpID NO_OP = -1;
 
+/*
+  The costs of propositions and unary operators, which change in every
+  exploration, are not stored in Proposition and UnaryOperator but in
+  separate arrays of RelaxedExploration (see there).
+*/
 struct Proposition {
     Proposition();
-    int cost; // used for h^max cost or h^add cost
     // TODO: Make sure in constructor that reached_by does not overflow.
     OpID reached_by : 30;
     /* The following two variables are conceptually bools, but Visual C++ does
        not support packing ints and bools together in a bitfield. */
     unsigned int is_goal : 1;
     unsigned int marked : 1; // used for preferred operators of h^add and h^FF
-    int num_precondition_occurences;
-    array_pool::ArrayPoolIndex precondition_of;
 };
 
-static_assert(sizeof(Proposition) == 16, "Proposition has wrong size");
+static_assert(sizeof(Proposition) == 4, "Proposition has wrong size");
 
 struct UnaryOperator {
     UnaryOperator(
         int num_preconditions, array_pool::ArrayPoolIndex preconditions,
         PropID effect, int operator_no, int base_cost);
-    int cost; // Used for h^max cost or h^add cost;
-              // includes operator cost (base_cost)
-    int unsatisfied_preconditions;
     PropID effect;
     int base_cost;
     int num_preconditions;
@@ -52,21 +56,75 @@ struct UnaryOperator {
     int operator_no; // -1 for axioms; index into the task's operators otherwise
 };
 
-static_assert(sizeof(UnaryOperator) == 28, "UnaryOperator has wrong size");
+static_assert(sizeof(UnaryOperator) == 20, "UnaryOperator has wrong size");
 
-class RelaxationHeuristic : public Heuristic {
+/*
+  The relaxed task (propositions and unary operators) of a relaxation
+  heuristic together with the data of its explorations. The relaxed task
+  only depends on the planning task, and the costs hold for the state of
+  the last exploration. Heuristics that compute the same costs can share
+  this object (see RelaxationHeuristic), so that evaluating all of them
+  on a state only builds the relaxed task once and explores once.
+*/
+class RelaxedExploration {
     void build_unary_operators(const OperatorProxy &op);
-    void simplify();
+    void simplify(utils::LogProxy &log);
 
+    // Used by invalidate_changed_propositions.
+    std::vector<bool> is_invalidated;
+public:
     // proposition_offsets[var_no]: first PropID related to variable var_no
     std::vector<PropID> proposition_offsets;
-protected:
     std::vector<UnaryOperator> unary_operators;
     std::vector<Proposition> propositions;
     std::vector<PropID> goal_propositions;
 
     array_pool::ArrayPool preconditions_pool;
-    array_pool::ArrayPool precondition_of_pool;
+
+    /*
+      The unary operators with precondition p are
+      precondition_of[precondition_of_offsets[p]], ...,
+      precondition_of[precondition_of_offsets[p + 1] - 1]
+      (compressed sparse row format). The unary operators achieving each
+      proposition are stored in the same format.
+    */
+    std::vector<int> precondition_of_offsets;
+    std::vector<OpID> precondition_of;
+    std::vector<int> achievers_offsets;
+    std::vector<OpID> achievers;
+
+    // Copy of the unary operator data used by reset_exploration.
+    std::vector<int> operator_base_costs;
+    std::vector<int> operator_num_preconditions;
+    std::vector<OpID> operators_without_preconditions;
+
+    /*
+      Data that changes in every exploration, stored as structure of
+      arrays: the inner loop of the exploration only touches the data it
+      needs, and resetting it is a sequence of fills and copies of
+      contiguous arrays that the compiler and the standard library
+      vectorize.
+    */
+    // h^max or h^add cost of each proposition (-1 if not reached)
+    std::vector<int> proposition_costs;
+    // h^max or h^add cost of each unary operator (including its base cost)
+    std::vector<int> operator_costs;
+    std::vector<int> unsatisfied_preconditions;
+
+    /*
+      Values of the state for which the costs hold (empty if they do not
+      hold for any state). If is_fixpoint is false, the exploration
+      stopped once all goals were reached.
+    */
+    std::vector<int> explored_state_values;
+    bool is_fixpoint;
+
+    RelaxedExploration(const TaskProxy &task_proxy, utils::LogProxy &log);
+
+    PropID get_prop_id(int var, int value) const {
+        return proposition_offsets[var] + value;
+    }
+    PropID get_prop_id(const FactProxy &fact) const;
 
     array_pool::ArrayPoolSlice get_preconditions(OpID op_id) const {
         const UnaryOperator &op = unary_operators[op_id];
@@ -74,31 +132,167 @@ protected:
             op.preconditions, op.num_preconditions);
     }
 
-    // HACK!
     std::vector<PropID> get_preconditions_vector(OpID op_id) const {
         auto view = get_preconditions(op_id);
         return std::vector<PropID>(view.begin(), view.end());
     }
 
+    std::span<const OpID> get_precondition_of(PropID prop_id) const {
+        return std::span<const OpID>(
+            precondition_of.data() + precondition_of_offsets[prop_id],
+            precondition_of.data() + precondition_of_offsets[prop_id + 1]);
+    }
+
+    std::span<const OpID> get_achievers(PropID prop_id) const {
+        return std::span<const OpID>(
+            achievers.data() + achievers_offsets[prop_id],
+            achievers.data() + achievers_offsets[prop_id + 1]);
+    }
+
+    // See RelaxationHeuristic for the following methods.
+    void reset_exploration();
+    void set_explored_state(const State *state, bool is_fixpoint);
+    bool is_explored(const State &state) const;
+    bool invalidate_changed_propositions(
+        const State &state, int max_invalidated_props,
+        std::vector<PropID> &added_props,
+        std::vector<PropID> &invalidated_props);
+};
+
+class RelaxationHeuristic : public Heuristic {
+    std::shared_ptr<RelaxedExploration> exploration;
+protected:
+    /*
+      Views of the data of the exploration that is used in the inner loops
+      of the explorations. Spans avoid the extra indirection of accessing
+      the vectors through the exploration object. They stay valid because
+      the vectors are not resized after the exploration is built.
+    */
+    std::span<UnaryOperator> unary_operators;
+    std::span<Proposition> propositions;
+    std::span<const PropID> goal_propositions;
+    std::span<int> proposition_costs;
+    std::span<int> operator_costs;
+    std::span<int> unsatisfied_preconditions;
+    std::span<const int> operator_base_costs;
+
     /*
-      TODO: Some of these protected methods are only needed for the
-      CEGAR hack in the additive heuristic and should eventually go
-      away.
+      If incremental is true, subclasses keep the costs of the last
+      exploration and repair them for the next state instead of exploring
+      from scratch (see invalidate_changed_propositions).
     */
-    PropID get_prop_id(const Proposition &prop) const {
-        PropID prop_id = &prop - propositions.data();
-        assert(utils::in_bounds(prop_id, propositions));
-        return prop_id;
+    const bool incremental;
+
+    // Queue of the explorations of h^max and h^add.
+    priority_queues::AdaptiveQueue<PropID> queue;
+    // Used by incremental explorations.
+    std::vector<PropID> added_props;
+    std::vector<PropID> invalidated_props;
+
+    void enqueue_if_necessary(PropID prop_id, int cost, OpID op_id) {
+        assert(cost >= 0);
+        int &prop_cost = proposition_costs[prop_id];
+        if (prop_cost == -1 || prop_cost > cost) {
+            prop_cost = cost;
+            get_proposition(prop_id)->reached_by = op_id;
+            queue.push(cost, prop_id);
+        }
+        assert(prop_cost != -1 && prop_cost <= cost);
     }
 
-    OpID get_op_id(const UnaryOperator &op) const {
-        OpID op_id = &op - unary_operators.data();
-        assert(utils::in_bounds(op_id, unary_operators));
-        return op_id;
+    /*
+      Start an exploration from scratch: reset the costs and enqueue the
+      effects of the operators without preconditions and the facts of the
+      state.
+    */
+    void setup_exploration_queue();
+    void setup_exploration_queue_state(const State &state);
+
+    /*
+      Repair the fixpoint of the last explored state for the given state
+      (see invalidate_changed_propositions). The hook
+      compute_operator_cost(op_id) returns the cost of the unary operator
+      computed from the costs of its preconditions, or -1 if one of them is
+      unreached. This is the only difference between h^max and h^add here.
+      The hook is a template parameter, so that it can be inlined in the
+      loops. Returns false without changing the costs if the heuristic has
+      to explore from scratch instead.
+    */
+    template<typename ComputeOperatorCost>
+    bool update_exploration_incrementally(
+        const State &state, const ComputeOperatorCost &compute_operator_cost);
+
+    std::span<const OpID> get_precondition_of(PropID prop_id) const {
+        return exploration->get_precondition_of(prop_id);
     }
 
-    PropID get_prop_id(int var, int value) const;
-    PropID get_prop_id(const FactProxy &fact) const;
+    std::span<const OpID> get_achievers(PropID prop_id) const {
+        return exploration->get_achievers(prop_id);
+    }
+
+    /*
+      Set the costs of all propositions to -1 and the costs and numbers of
+      unsatisfied preconditions of all unary operators to their base costs
+      and numbers of preconditions. Unary operators without preconditions
+      have to be handled separately (see operators_without_preconditions).
+    */
+    void reset_exploration() {
+        exploration->reset_exploration();
+    }
+    const std::vector<OpID> &get_operators_without_preconditions() const {
+        return exploration->operators_without_preconditions;
+    }
+
+    /*
+      Mark the costs as the result of an exploration for the given state,
+      or as invalid if state is nullptr. If is_fixpoint is false, the
+      exploration stopped once all goals were reached.
+    */
+    void set_explored_state(const State *state, bool is_fixpoint) {
+        exploration->set_explored_state(state, is_fixpoint);
+    }
+
+    /*
+      Return true if the costs hold for the given state, e.g., because
+      another heuristic sharing the exploration has just evaluated it.
+    */
+    bool is_explored(const State &state) const {
+        return exploration->is_explored(state);
+    }
+
+    /*
+      Prepare the repair of the fixpoint of the last explored state for the
+      given state. Propositions that are true in state but were false in
+      the explored state are added to added_props. Propositions whose cost
+      may increase are added to invalidated_props and their costs are set
+      to -1. These are the propositions that were true only in the explored
+      state and, transitively, the propositions whose best achiever has an
+      invalidated precondition. The costs of all other propositions can
+      only decrease.
+
+      Returns false without changing anything if the costs are not the
+      fixpoint of an explored state or if more than max_invalidated_props
+      propositions would be invalidated. Callers should then explore from
+      scratch.
+    */
+    bool invalidate_changed_propositions(
+        const State &state, int max_invalidated_props,
+        std::vector<PropID> &added_props,
+        std::vector<PropID> &invalidated_props) {
+        return exploration->invalidate_changed_propositions(
+            state, max_invalidated_props, added_props, invalidated_props);
+    }
+
+    array_pool::ArrayPoolSlice get_preconditions(OpID op_id) const {
+        return exploration->get_preconditions(op_id);
+    }
+
+    PropID get_prop_id(int var, int value) const {
+        return exploration->get_prop_id(var, value);
+    }
+    PropID get_prop_id(const FactProxy &fact) const {
+        return exploration->get_prop_id(fact);
+    }
 
     Proposition *get_proposition(PropID prop_id) {
         return &propositions[prop_id];
@@ -106,20 +300,83 @@ protected:
     UnaryOperator *get_operator(OpID op_id) {
         return &unary_operators[op_id];
     }
-
-    const Proposition *get_proposition(int var, int value) const;
-    Proposition *get_proposition(int var, int value);
-    Proposition *get_proposition(const FactProxy &fact);
 public:
+    /*
+      If share_exploration is true, the heuristic uses the same
+      RelaxedExploration object as all other heuristics that were created
+      with share_exploration = true for the same task and axiom handling
+      and still exist. This is only correct for heuristics that compute
+      the same costs with the same exploration, i.e., h^add and h^FF, or
+      that do not use the costs at all (relaxed reachability).
+    */
     RelaxationHeuristic(
         const std::shared_ptr<AbstractTask> &task,
-        tasks::AxiomHandlingType axioms, bool cache_estimates,
+        tasks::AxiomHandlingType axioms, bool incremental,
+        bool share_exploration, bool cache_estimates,
         const std::string &description, utils::Verbosity verbosity);
 };
 
+template<typename ComputeOperatorCost>
+bool RelaxationHeuristic::update_exploration_incrementally(
+    const State &state, const ComputeOperatorCost &compute_operator_cost) {
+    added_props.clear();
+    invalidated_props.clear();
+    int max_invalidated_props = propositions.size() / 2;
+    if (!invalidate_changed_propositions(
+            state, max_invalidated_props, added_props, invalidated_props)) {
+        return false;
+    }
+
+    queue.clear();
+    for (PropID prop_id : invalidated_props) {
+        for (OpID op_id : get_achievers(prop_id)) {
+            int op_cost = compute_operator_cost(op_id);
+            if (op_cost != -1)
+                enqueue_if_necessary(prop_id, op_cost, op_id);
+        }
+    }
+    for (PropID prop_id : added_props) {
+        /*
+          A zero-cost operator can have reached the proposition at cost 0
+          before it became true. Since invalidations follow the best
+          achievers, state facts must not keep such an achiever: when one
+          of its preconditions becomes false, the fact would be
+          invalidated although it is still true.
+        */
+        get_proposition(prop_id)->reached_by = NO_OP;
+        enqueue_if_necessary(prop_id, 0, NO_OP);
+    }
+
+    /*
+      Like the explorations from scratch, but only the propositions whose
+      costs changed are in the queue, so we recompute the cost of each
+      operator from all of its preconditions instead of counting down the
+      unsatisfied preconditions.
+    */
+    while (!queue.empty()) {
+        std::pair<int, PropID> top_pair = queue.pop();
+        int distance = top_pair.first;
+        PropID prop_id = top_pair.second;
+        int prop_cost = proposition_costs[prop_id];
+        assert(prop_cost >= 0);
+        assert(prop_cost <= distance);
+        if (prop_cost < distance)
+            continue;
+        for (OpID op_id : get_precondition_of(prop_id)) {
+            int op_cost = compute_operator_cost(op_id);
+            if (op_cost != -1) {
+                PropID effect = get_operator(op_id)->effect;
+                enqueue_if_necessary(effect, op_cost, op_id);
+            }
+        }
+    }
+    return true;
+}
+
 extern void add_relaxation_heuristic_options_to_feature(
     plugins::Feature &feature, const std::string &description);
-extern std::tuple<tasks::AxiomHandlingType, bool, std::string, utils::Verbosity>
+extern std::tuple<
+    tasks::AxiomHandlingType, bool, bool, std::string, utils::Verbosity>
 get_relaxation_heuristic_arguments_from_options(const plugins::Options &opts);
 }
 #endif
@@ -0,0 +1,170 @@
+#include "relaxed_reachability_heuristic.h"
+
+#include "../plugins/plugin.h"
+#include "../utils/logging.h"
+
+#include <algorithm>
+#include <cassert>
+
+using namespace std;
+
+namespace relaxed_reachability_heuristic {
+RelaxedReachabilityHeuristic::RelaxedReachabilityHeuristic(
+    const shared_ptr<AbstractTask> &task, tasks::AxiomHandlingType axioms,
+    bool cache_estimates, const string &description,
+    utils::Verbosity verbosity)
+    : RelaxationHeuristic(
+          task, axioms, false, true, cache_estimates, description, verbosity),
+      proposition_lanes(propositions.size(), 0),
+      is_queued(propositions.size(), false) {
+    num_preconditions.reserve(unary_operators.size());
+    for (const relaxation_heuristic::UnaryOperator &op : unary_operators)
+        num_preconditions.push_back(op.num_preconditions);
+    if (log.is_at_least_normal()) {
+        log << "Initializing relaxed reachability heuristic..." << endl;
+    }
+}
+
+void RelaxedReachabilityHeuristic::enqueue_lanes(
+    PropID prop_id, uint64_t lanes) {
+    uint64_t &prop_lanes = proposition_lanes[prop_id];
+    if (lanes & ~prop_lanes) {
+        if (!prop_lanes) {
+            for (OpID op_id : get_precondition_of(prop_id))
+                --unreached_preconditions[op_id];
+        }
+        prop_lanes |= lanes;
+        if (!is_queued[prop_id]) {
+            is_queued[prop_id] = true;
+            queue.push_back(prop_id);
+        }
+    }
+}
+
+uint64_t RelaxedReachabilityHeuristic::explore() {
+    assert(!states.empty() && states.size() <= NUM_LANES);
+    uint64_t all_lanes = states.size() == NUM_LANES
+                             ? ~uint64_t(0)
+                             : (uint64_t(1) << states.size()) - 1;
+
+    fill(proposition_lanes.begin(), proposition_lanes.end(), 0);
+    unreached_preconditions = num_preconditions;
+    assert(queue.empty());
+    for (size_t lane = 0; lane < states.size(); ++lane) {
+        for (FactProxy fact : states[lane]) {
+            enqueue_lanes(get_prop_id(fact), uint64_t(1) << lane);
+        }
+    }
+    for (OpID op_id : get_operators_without_preconditions()) {
+        enqueue_lanes(unary_operators[op_id].effect, all_lanes);
+    }
+
+    /*
+      A proposition is processed again whenever it becomes reachable in
+      more lanes, so it is processed at most once per lane. Operators are
+      only considered once all of their preconditions are reachable in
+      some lane, so that exploring a single state costs about as much as
+      counting unsatisfied preconditions in h^max. We stop early once all
+      goals are reachable in all lanes.
+    */
+    uint64_t goal_lanes = 0;
+    size_t queue_head = 0;
+    while (queue_head < queue.size()) {
+        PropID prop_id = queue[queue_head++];
+        is_queued[prop_id] = false;
+        if (propositions[prop_id].is_goal) {
+            goal_lanes = all_lanes;
+            for (PropID goal_id : goal_propositions)
+                goal_lanes &= proposition_lanes[goal_id];
+            if (goal_lanes == all_lanes)
+                break;
+        }
+        for (OpID op_id : get_precondition_of(prop_id)) {
+            if (unreached_preconditions[op_id])
+                continue;
+            uint64_t lanes = all_lanes;
+            for (PropID precond : get_preconditions(op_id)) {
+                lanes &= proposition_lanes[precond];
+                if (!lanes)
+                    break;
+            }
+            if (lanes)
+                enqueue_lanes(unary_operators[op_id].effect, lanes);
+        }
+    }
+    for (size_t i = queue_head; i < queue.size(); ++i)
+        is_queued[queue[i]] = false;
+    queue.clear();
+
+    goal_lanes = all_lanes;
+    for (PropID goal_id : goal_propositions)
+        goal_lanes &= proposition_lanes[goal_id];
+    return goal_lanes;
+}
+
+int RelaxedReachabilityHeuristic::compute_heuristic(
+    const State &ancestor_state) {
+    states.clear();
+    states.push_back(convert_ancestor_state(ancestor_state));
+    return explore() ? 0 : DEAD_END;
+}
+
+void RelaxedReachabilityHeuristic::compute_heuristics(
+    const vector<State> &ancestor_states, vector<int> &values) {
+    values.clear();
+    values.reserve(ancestor_states.size());
+    for (size_t start = 0; start < ancestor_states.size();
+         start += NUM_LANES) {
+        size_t end = min(start + NUM_LANES, ancestor_states.size());
+        states.clear();
+        for (size_t i = start; i < end; ++i) {
+            states.push_back(convert_ancestor_state(ancestor_states[i]));
+        }
+        uint64_t goal_lanes = explore();
+        for (size_t lane = 0; lane < states.size(); ++lane) {
+            bool is_reachable = goal_lanes & (uint64_t(1) << lane);
+            values.push_back(is_reachable ? 0 : DEAD_END);
+        }
+    }
+}
+
+class RelaxedReachabilityHeuristicFeature
+    : public plugins::TypedFeature<TaskIndependentEvaluator> {
+public:
+    RelaxedReachabilityHeuristicFeature()
+        : TypedFeature("relaxed_reachability") {
+        document_title("Relaxed reachability heuristic");
+        document_synopsis(
+            "Returns infinity for states from which the goal is not "
+            "reachable in the delete relaxation (i.e., iff h^max is "
+            "infinite) and 0 for all other states. When the heuristic is "
+            "evaluated on a batch of states (see the option "
+            "batch_evaluation of eager search), it explores up to 64 "
+            "states at once with bit-parallel operations. It is meant as "
+            "a cheap dead-end filter, e.g., with the option "
+            "dead_end_filter of eager search.");
+
+        tasks::add_axioms_option_to_feature(*this);
+        add_heuristic_options_to_feature(*this, "relaxed_reachability");
+
+        document_language_support("action costs", "ignored by design");
+        document_language_support("conditional effects", "supported");
+        document_language_support("axioms", "supported");
+
+        document_property("admissible", "yes for tasks without axioms");
+        document_property("consistent", "yes for tasks without axioms");
+        document_property("safe", "yes");
+        document_property("preferred operators", "no");
+    }
+
+    virtual shared_ptr<TaskIndependentEvaluator> create_component(
+        const plugins::Options &opts) const override {
+        return components::make_auto_task_independent_component<
+            RelaxedReachabilityHeuristic, Evaluator>(
+            tasks::get_axioms_arguments_from_options(opts),
+            get_heuristic_arguments_from_options(opts));
+    }
+};
+
+static plugins::FeaturePlugin<RelaxedReachabilityHeuristicFeature> _plugin;
+}
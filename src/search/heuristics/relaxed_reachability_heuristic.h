@@ -0,0 +1,57 @@
+#ifndef HEURISTICS_RELAXED_REACHABILITY_HEURISTIC_H
+#define HEURISTICS_RELAXED_REACHABILITY_HEURISTIC_H
+
+#include "relaxation_heuristic.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace relaxed_reachability_heuristic {
+using relaxation_heuristic::OpID;
+using relaxation_heuristic::PropID;
+
+/*
+  Detects dead ends by checking if the goal is reachable in the delete
+  relaxation, i.e., this heuristic reports a dead end iff h^max is
+  infinite and 0 otherwise.
+
+  The exploration is bit-parallel: it explores up to 64 states at once
+  by storing for each proposition a 64-bit mask of the states (lanes) in
+  which it is reachable. A unary operator is applicable in the lanes in
+  which all of its preconditions are reachable (bitwise AND of their
+  masks) and makes its effect reachable in these lanes (bitwise OR). A
+  batch of states is thus explored in about the time of a single
+  exploration. The heuristic only reads the relaxed task, so it shares it
+  with h^add and h^FF.
+*/
+class RelaxedReachabilityHeuristic
+    : public relaxation_heuristic::RelaxationHeuristic {
+    static const int NUM_LANES = 64;
+
+    std::vector<uint64_t> proposition_lanes;
+    std::vector<int> num_preconditions;
+    // Preconditions of each unary operator that are unreached in all lanes.
+    std::vector<int> unreached_preconditions;
+    // Propositions whose masks changed since they were last processed.
+    std::vector<PropID> queue;
+    std::vector<bool> is_queued;
+    // States of the current batch (reused to avoid allocations).
+    std::vector<State> states;
+
+    void enqueue_lanes(PropID prop_id, uint64_t lanes);
+    // Return the lanes (states) in which all goals are reachable.
+    uint64_t explore();
+protected:
+    virtual int compute_heuristic(const State &ancestor_state) override;
+    virtual void compute_heuristics(
+        const std::vector<State> &ancestor_states,
+        std::vector<int> &values) override;
+public:
+    RelaxedReachabilityHeuristic(
+        const std::shared_ptr<AbstractTask> &task,
+        tasks::AxiomHandlingType axioms, bool cache_estimates,
+        const std::string &description, utils::Verbosity verbosity);
+};
+}
+
+#endif
@@ -9,19 +9,20 @@
 
 #include "../task_proxy.h"
 
+#include "../task_utils/flattened_task.h"
 #include "../utils/collections.h"
 #include "../utils/logging.h"
 
 #include <algorithm>
 #include <cassert>
-#include <unordered_map>
+#include <span>
 #include <vector>
 
 using namespace std;
 
 namespace merge_and_shrink {
 class FTSFactory {
-    const TaskProxy &task_proxy;
+    const flattened_task::FlattenedTask &flat_task;
 
     struct TransitionSystemData {
         // The following two attributes are only used for statistics
@@ -52,23 +53,27 @@ class FTSFactory {
     // see TODO in build_transitions()
     int task_has_conditional_effects;
 
+    /*
+      Used by build_transitions_for_operator and indexed by variables.
+      Only the entries of the variables that are relevant for the current
+      operator are set, and they are reset after each operator, so that
+      handling an operator does not take time linear in the number of
+      variables.
+    */
+    vector<int> pre_values;
+    vector<bool> has_effect_on_var;
+    vector<vector<Transition>> transitions_by_var;
+    vector<int> relevant_vars;
+
     unique_ptr<Labels> create_labels();
-    void build_state_data(VariableProxy var);
+    void build_state_data(int var_id);
     void initialize_transition_system_data(const Labels &labels);
     bool is_relevant(int var_id, int label) const;
     void mark_as_relevant(int var_id, int label);
-    unordered_map<int, int> compute_preconditions(OperatorProxy op);
-    void handle_operator_effect(
-        OperatorProxy op, EffectProxy effect,
-        const unordered_map<int, int> &pre_val, vector<bool> &has_effect_on_var,
-        vector<vector<Transition>> &transitions_by_var);
-    void handle_operator_precondition(
-        OperatorProxy op, FactProxy precondition,
-        const vector<bool> &has_effect_on_var,
-        vector<vector<Transition>> &transitions_by_var);
-    void build_transitions_for_operator(OperatorProxy op);
-    void build_transitions_for_irrelevant_ops(
-        const VariableProxy &variable, const Labels &labels);
+    void handle_operator_effect(int label, int eff_no, const FactPair &fact);
+    void handle_operator_precondition(int label, const FactPair &precondition);
+    void build_transitions_for_operator(int label);
+    void build_transitions_for_irrelevant_ops(int var_id, const Labels &labels);
     void build_transitions(const Labels &labels);
     vector<unique_ptr<TransitionSystem>> create_transition_systems(
         const Labels &labels);
@@ -90,7 +95,8 @@ public:
 };
 
 FTSFactory::FTSFactory(const TaskProxy &task_proxy)
-    : task_proxy(task_proxy), task_has_conditional_effects(false) {
+    : flat_task(flattened_task::g_flattened_tasks[task_proxy]),
+      task_has_conditional_effects(false) {
 }
 
 FTSFactory::~FTSFactory() {
@@ -98,33 +104,30 @@ FTSFactory::~FTSFactory() {
 
 unique_ptr<Labels> FTSFactory::create_labels() {
     vector<int> label_costs;
-    OperatorsProxy ops = task_proxy.get_operators();
-    int num_ops = ops.size();
+    int num_ops = flat_task.get_num_operators();
     int max_num_labels = 0;
     if (num_ops > 0) {
         max_num_labels = 2 * num_ops - 1;
         label_costs.reserve(max_num_labels);
-        for (OperatorProxy op : ops) {
-            label_costs.push_back(op.get_cost());
+        for (int op_id = 0; op_id < num_ops; ++op_id) {
+            label_costs.push_back(flat_task.get_cost(op_id));
         }
     }
     return make_unique<Labels>(move(label_costs), max_num_labels);
 }
 
-void FTSFactory::build_state_data(VariableProxy var) {
-    int var_id = var.get_id();
+void FTSFactory::build_state_data(int var_id) {
     TransitionSystemData &ts_data = transition_system_data_by_var[var_id];
-    ts_data.init_state = task_proxy.get_initial_state()[var_id].get_value();
+    ts_data.init_state = flat_task.get_initial_state_values()[var_id];
 
-    int range = task_proxy.get_variables()[var_id].get_domain_size();
+    int range = flat_task.get_domain_size(var_id);
     ts_data.num_states = range;
 
     int goal_value = -1;
-    GoalsProxy goals = task_proxy.get_goals();
-    for (FactProxy goal : goals) {
-        if (goal.get_variable().get_id() == var_id) {
+    for (const FactPair &goal : flat_task.get_goals()) {
+        if (goal.var == var_id) {
             assert(goal_value == -1);
-            goal_value = goal.get_value();
+            goal_value = goal.value;
             break;
         }
     }
@@ -138,17 +141,19 @@ void FTSFactory::build_state_data(VariableProxy var) {
 }
 
 void FTSFactory::initialize_transition_system_data(const Labels &labels) {
-    VariablesProxy variables = task_proxy.get_variables();
-    transition_system_data_by_var.resize(variables.size());
-    for (VariableProxy var : variables) {
-        TransitionSystemData &ts_data =
-            transition_system_data_by_var[var.get_id()];
-        ts_data.num_variables = variables.size();
-        ts_data.incorporated_variables.push_back(var.get_id());
+    int num_variables = flat_task.get_num_variables();
+    transition_system_data_by_var.resize(num_variables);
+    for (int var_id = 0; var_id < num_variables; ++var_id) {
+        TransitionSystemData &ts_data = transition_system_data_by_var[var_id];
+        ts_data.num_variables = num_variables;
+        ts_data.incorporated_variables.push_back(var_id);
         ts_data.label_to_local_label.resize(labels.get_max_num_labels(), -1);
         ts_data.relevant_labels.resize(labels.get_num_total_labels(), false);
-        build_state_data(var);
+        build_state_data(var_id);
     }
+    pre_values.resize(num_variables, -1);
+    has_effect_on_var.resize(num_variables, false);
+    transitions_by_var.resize(num_variables);
 }
 
 bool FTSFactory::is_relevant(int var_id, int label) const {
@@ -156,38 +161,27 @@ bool FTSFactory::is_relevant(int var_id, int label) const {
 }
 
 void FTSFactory::mark_as_relevant(int var_id, int label) {
-    transition_system_data_by_var[var_id].relevant_labels[label] = true;
-}
-
-unordered_map<int, int> FTSFactory::compute_preconditions(OperatorProxy op) {
-    unordered_map<int, int> pre_val;
-    for (FactProxy precondition : op.get_preconditions())
-        pre_val[precondition.get_variable().get_id()] =
-            precondition.get_value();
-    return pre_val;
+    vector<bool> &relevant_labels =
+        transition_system_data_by_var[var_id].relevant_labels;
+    if (!relevant_labels[label]) {
+        relevant_labels[label] = true;
+        relevant_vars.push_back(var_id);
+    }
 }
 
 void FTSFactory::handle_operator_effect(
-    OperatorProxy op, EffectProxy effect,
-    const unordered_map<int, int> &pre_val, vector<bool> &has_effect_on_var,
-    vector<vector<Transition>> &transitions_by_var) {
-    int label = op.get_id();
-    FactProxy fact = effect.get_fact();
-    VariableProxy var = fact.get_variable();
-    int var_id = var.get_id();
+    int label, int eff_no, const FactPair &fact) {
+    int var_id = fact.var;
     has_effect_on_var[var_id] = true;
-    int post_value = fact.get_value();
+    int post_value = fact.value;
 
     // Determine possible values that var can have when this
     // operator is applicable.
-    int pre_value = -1;
-    auto pre_val_it = pre_val.find(var_id);
-    if (pre_val_it != pre_val.end())
-        pre_value = pre_val_it->second;
+    int pre_value = pre_values[var_id];
     int pre_value_min, pre_value_max;
     if (pre_value == -1) {
         pre_value_min = 0;
-        pre_value_max = var.get_domain_size();
+        pre_value_max = flat_task.get_domain_size(var_id);
     } else {
         pre_value_min = pre_value;
         pre_value_max = pre_value + 1;
@@ -200,12 +194,13 @@ void FTSFactory::handle_operator_effect(
       has_other_effect_cond is true iff there exists an effect
       condition on a variable other than var.
     */
-    EffectConditionsProxy effect_conditions = effect.get_conditions();
+    span<const FactPair> effect_conditions =
+        flat_task.get_effect_conditions(label, eff_no);
     int cond_effect_pre_value = -1;
     bool has_other_effect_cond = false;
-    for (FactProxy condition : effect_conditions) {
-        if (condition.get_variable() == var) {
-            cond_effect_pre_value = condition.get_value();
+    for (const FactPair &condition : effect_conditions) {
+        if (condition.var == var_id) {
+            cond_effect_pre_value = condition.value;
         } else {
             has_other_effect_cond = true;
         }
@@ -241,51 +236,43 @@ void FTSFactory::handle_operator_effect(
 }
 
 void FTSFactory::handle_operator_precondition(
-    OperatorProxy op, FactProxy precondition,
-    const vector<bool> &has_effect_on_var,
-    vector<vector<Transition>> &transitions_by_var) {
-    int label = op.get_id();
-    int var_id = precondition.get_variable().get_id();
+    int label, const FactPair &precondition) {
+    int var_id = precondition.var;
     if (!has_effect_on_var[var_id]) {
-        int value = precondition.get_value();
+        int value = precondition.value;
         transitions_by_var[var_id].emplace_back(value, value);
         mark_as_relevant(var_id, label);
     }
 }
 
-void FTSFactory::build_transitions_for_operator(OperatorProxy op) {
+void FTSFactory::build_transitions_for_operator(int label) {
     /*
       - Mark op as relevant in the transition systems corresponding
         to variables on which it has a precondition or effect.
       - Add transitions induced by op in these transition systems.
     */
-    unordered_map<int, int> pre_val = compute_preconditions(op);
-    int num_variables = task_proxy.get_variables().size();
-    vector<bool> has_effect_on_var(task_proxy.get_variables().size(), false);
-    vector<vector<Transition>> transitions_by_var(num_variables);
+    span<const FactPair> preconditions = flat_task.get_preconditions(label);
+    for (const FactPair &precondition : preconditions)
+        pre_values[precondition.var] = precondition.value;
 
-    for (EffectProxy effect : op.get_effects())
-        handle_operator_effect(
-            op, effect, pre_val, has_effect_on_var, transitions_by_var);
+    span<const FactPair> effects = flat_task.get_effects(label);
+    for (size_t eff_no = 0; eff_no < effects.size(); ++eff_no)
+        handle_operator_effect(label, eff_no, effects[eff_no]);
 
     /*
       We must handle preconditions *after* effects because handling
       the effects sets has_effect_on_var.
     */
-    for (FactProxy precondition : op.get_preconditions())
-        handle_operator_precondition(
-            op, precondition, has_effect_on_var, transitions_by_var);
+    for (const FactPair &precondition : preconditions)
+        handle_operator_precondition(label, precondition);
 
-    int label = op.get_id();
-    int label_cost = op.get_cost();
-    for (int var_id = 0; var_id < num_variables; ++var_id) {
-        if (!is_relevant(var_id, label)) {
-            /*
-              We do not want to add transitions of irrelevant labels here,
-              since they are handled together in a separate step.
-            */
-            continue;
-        }
+    /*
+      We do not want to add transitions of irrelevant labels here, since
+      they are handled together in a separate step.
+    */
+    int label_cost = flat_task.get_cost(label);
+    sort(relevant_vars.begin(), relevant_vars.end());
+    for (int var_id : relevant_vars) {
         vector<Transition> &transitions = transitions_by_var[var_id];
         /*
           TODO: Our method for generating transitions is only guarantueed
@@ -325,13 +312,19 @@ void FTSFactory::build_transitions_for_operator(OperatorProxy op) {
             assert(label_to_local_label[label] == -1);
             label_to_local_label[label] = new_local_label;
         }
+        transitions.clear();
     }
+
+    for (const FactPair &precondition : preconditions)
+        pre_values[precondition.var] = -1;
+    for (const FactPair &effect : effects)
+        has_effect_on_var[effect.var] = false;
+    relevant_vars.clear();
 }
 
 void FTSFactory::build_transitions_for_irrelevant_ops(
-    const VariableProxy &variable, const Labels &labels) {
-    int var_id = variable.get_id();
-    int num_states = variable.get_domain_size();
+    int var_id, const Labels &labels) {
+    int num_states = flat_task.get_domain_size(var_id);
 
     // Collect all irrelevant labels for this variable.
     LabelGroup irrelevant_labels;
@@ -365,21 +358,21 @@ void FTSFactory::build_transitions(const Labels &labels) {
         transitions of locally equivalent labels for a given variable.
       - Computes relevant operator information as a side effect.
     */
-    for (OperatorProxy op : task_proxy.get_operators())
-        build_transitions_for_operator(op);
+    for (int op_id = 0; op_id < flat_task.get_num_operators(); ++op_id)
+        build_transitions_for_operator(op_id);
 
     /*
       Compute transitions of irrelevant operators for each variable only
       once and put the labels into a single label group.
     */
-    for (VariableProxy variable : task_proxy.get_variables())
-        build_transitions_for_irrelevant_ops(variable, labels);
+    for (int var_id = 0; var_id < flat_task.get_num_variables(); ++var_id)
+        build_transitions_for_irrelevant_ops(var_id, labels);
 }
 
 vector<unique_ptr<TransitionSystem>> FTSFactory::create_transition_systems(
     const Labels &labels) {
     // Create the actual TransitionSystem objects.
-    int num_variables = task_proxy.get_variables().size();
+    int num_variables = flat_task.get_num_variables();
 
     // We reserve space for the transition systems added later by merging.
     vector<unique_ptr<TransitionSystem>> result;
@@ -399,7 +392,7 @@ vector<unique_ptr<TransitionSystem>> FTSFactory::create_transition_systems(
 vector<unique_ptr<MergeAndShrinkRepresentation>>
 FTSFactory::create_mas_representations() const {
     // Create the actual MergeAndShrinkRepresentation objects.
-    int num_variables = task_proxy.get_variables().size();
+    int num_variables = flat_task.get_num_variables();
 
     // We reserve space for the transition systems added later by merging.
     vector<unique_ptr<MergeAndShrinkRepresentation>> result;
@@ -407,7 +400,7 @@ FTSFactory::create_mas_representations() const {
     result.reserve(num_variables * 2 - 1);
 
     for (int var_id = 0; var_id < num_variables; ++var_id) {
-        int range = task_proxy.get_variables()[var_id].get_domain_size();
+        int range = flat_task.get_domain_size(var_id);
         result.push_back(
             make_unique<MergeAndShrinkRepresentationLeaf>(var_id, range));
     }
@@ -417,7 +410,7 @@ FTSFactory::create_mas_representations() const {
 vector<unique_ptr<Distances>> FTSFactory::create_distances(
     const vector<unique_ptr<TransitionSystem>> &transition_systems) const {
     // Create the actual Distances objects.
-    int num_variables = task_proxy.get_variables().size();
+    int num_variables = flat_task.get_num_variables();
 
     // We reserve space for the transition systems added later by merging.
     vector<unique_ptr<Distances>> result;
@@ -89,6 +89,14 @@ public:
     virtual void get_path_dependent_evaluators(
         std::set<Evaluator *> &evals) = 0;
 
+    /*
+      Add all evaluators that this open list uses directly into the result
+      set. Evaluators used indirectly by these evaluators are not added.
+      This is used for evaluating batches of states before they are
+      inserted (see EvaluationContext::evaluate_batch).
+    */
+    virtual void get_evaluators(std::set<Evaluator *> &evals) = 0;
+
     /*
       Accessor method for only_preferred.
 
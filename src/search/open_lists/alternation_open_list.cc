@@ -35,6 +35,7 @@ public:
     virtual void boost_preferred() override;
     virtual void get_path_dependent_evaluators(
         set<Evaluator *> &evals) override;
+    virtual void get_evaluators(set<Evaluator *> &evals) override;
     virtual bool is_dead_end(EvaluationContext &eval_context) const override;
     virtual bool is_reliable_dead_end(
         EvaluationContext &eval_context) const override;
@@ -104,6 +105,12 @@ void AlternationOpenList<Entry>::get_path_dependent_evaluators(
         sublist->get_path_dependent_evaluators(evals);
 }
 
+template<class Entry>
+void AlternationOpenList<Entry>::get_evaluators(set<Evaluator *> &evals) {
+    for (const auto &sublist : open_lists)
+        sublist->get_evaluators(evals);
+}
+
 template<class Entry>
 bool AlternationOpenList<Entry>::is_dead_end(
     EvaluationContext &eval_context) const {
@@ -33,6 +33,7 @@ public:
     virtual void clear() override;
     virtual void get_path_dependent_evaluators(
         set<Evaluator *> &evals) override;
+    virtual void get_evaluators(set<Evaluator *> &evals) override;
     virtual bool is_dead_end(EvaluationContext &eval_context) const override;
     virtual bool is_reliable_dead_end(
         EvaluationContext &eval_context) const override;
@@ -85,6 +86,11 @@ void BestFirstOpenList<Entry>::get_path_dependent_evaluators(
     evaluator->get_path_dependent_evaluators(evals);
 }
 
+template<class Entry>
+void BestFirstOpenList<Entry>::get_evaluators(set<Evaluator *> &evals) {
+    evals.insert(evaluator.get());
+}
+
 template<class Entry>
 bool BestFirstOpenList<Entry>::is_dead_end(
     EvaluationContext &eval_context) const {
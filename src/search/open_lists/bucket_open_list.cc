@@ -0,0 +1,368 @@
+#include "bucket_open_list.h"
+
+#include "tiebreaking_open_list.h"
+
+#include "../evaluator.h"
+#include "../open_list.h"
+
+#include "../plugins/plugin.h"
+#include "../task_utils/task_properties.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+namespace bucket_open_list {
+/*
+  Maximal number of f layers plus h buckets of an open list. This bounds
+  the memory used for buckets to a few dozen megabytes.
+*/
+static const int MAX_NUM_BUCKETS = 1 << 20;
+
+/*
+  FIFO queue that stores its entries contiguously. Removed entries stay in
+  the vector until more than half of the entries have been removed. When the
+  queue becomes empty, the memory is kept for later insertions.
+*/
+template<class Entry>
+class Bucket {
+    vector<Entry> entries;
+    size_t front;
+public:
+    Bucket() : front(0) {
+    }
+
+    bool empty() const {
+        return front == entries.size();
+    }
+
+    void push(const Entry &entry) {
+        entries.push_back(entry);
+    }
+
+    Entry pop() {
+        assert(!empty());
+        Entry result = entries[front++];
+        if (front == entries.size()) {
+            entries.clear();
+            front = 0;
+        } else if (front > 32 && 2 * front > entries.size()) {
+            entries.erase(entries.begin(), entries.begin() + front);
+            front = 0;
+        }
+        return result;
+    }
+
+    void clear() {
+        entries.clear();
+        front = 0;
+    }
+};
+
+template<class Entry>
+class FHBucketOpenList : public OpenList<Entry> {
+    struct FLayer {
+        // buckets[h] contains the entries with this f value and h value h.
+        vector<Bucket<Entry>> buckets;
+        int size;
+        // All buckets with smaller h values are empty.
+        int min_h;
+
+        FLayer() : size(0), min_h(0) {
+        }
+    };
+
+    // layers[f] contains the entries with f value f.
+    vector<FLayer> layers;
+    // Number of layers plus the number of buckets of all layers.
+    int num_buckets;
+    int num_bucket_entries;
+    /*
+      Entries for which a bucket would exceed MAX_NUM_BUCKETS. Entries with
+      the same (f, h) values can be stored here and in a bucket, but then
+      the entries here are older, so we remove them first.
+    */
+    map<pair<int, int>, Bucket<Entry>> overflow;
+    /*
+      The tie-breaking open list orders entries with infinite values after
+      all other entries. A* never inserts such entries, so we store them in
+      a single bucket instead of ordering them.
+    */
+    Bucket<Entry> infinite_bucket;
+    int size;
+    int num_infinite_entries;
+    // All layers with smaller f values are empty.
+    int min_f;
+
+    bool is_in_buckets(int f, int h) const;
+
+    shared_ptr<Evaluator> f_eval;
+    shared_ptr<Evaluator> h_eval;
+
+protected:
+    virtual void do_insertion(
+        EvaluationContext &eval_context, const Entry &entry) override;
+
+public:
+    FHBucketOpenList(
+        const shared_ptr<Evaluator> &f_eval,
+        const shared_ptr<Evaluator> &h_eval, bool pref_only);
+
+    virtual Entry remove_min() override;
+    virtual bool empty() const override;
+    virtual void clear() override;
+    virtual void get_path_dependent_evaluators(
+        set<Evaluator *> &evals) override;
+    virtual void get_evaluators(set<Evaluator *> &evals) override;
+    virtual bool is_dead_end(EvaluationContext &eval_context) const override;
+    virtual bool is_reliable_dead_end(
+        EvaluationContext &eval_context) const override;
+    virtual bool is_safe() const override;
+};
+
+template<class Entry>
+FHBucketOpenList<Entry>::FHBucketOpenList(
+    const shared_ptr<Evaluator> &f_eval, const shared_ptr<Evaluator> &h_eval,
+    bool pref_only)
+    : OpenList<Entry>(pref_only),
+      num_buckets(0),
+      num_bucket_entries(0),
+      size(0),
+      num_infinite_entries(0),
+      min_f(0),
+      f_eval(f_eval),
+      h_eval(h_eval) {
+}
+
+template<class Entry>
+bool FHBucketOpenList<Entry>::is_in_buckets(int f, int h) const {
+    int num_layers = layers.size();
+    if (f < num_layers && h < static_cast<int>(layers[f].buckets.size())) {
+        return true;
+    }
+    if (overflow.count(make_pair(f, h))) {
+        return false;
+    }
+    int64_t new_layers = max(0, f + 1 - num_layers);
+    int64_t layer_buckets = f < num_layers ? layers[f].buckets.size() : 0;
+    int64_t new_buckets = int64_t(h) + 1 - layer_buckets;
+    return num_buckets + new_layers + new_buckets <= MAX_NUM_BUCKETS;
+}
+
+template<class Entry>
+void FHBucketOpenList<Entry>::do_insertion(
+    EvaluationContext &eval_context, const Entry &entry) {
+    int f = eval_context.get_evaluator_value_or_infinity(f_eval.get());
+    int h = eval_context.get_evaluator_value_or_infinity(h_eval.get());
+    assert(f >= 0 && h >= 0);
+    ++size;
+    if (f == EvaluationResult::INFTY || h == EvaluationResult::INFTY) {
+        infinite_bucket.push(entry);
+        ++num_infinite_entries;
+        return;
+    }
+
+    if (!is_in_buckets(f, h)) {
+        overflow[make_pair(f, h)].push(entry);
+        return;
+    }
+    if (f >= static_cast<int>(layers.size())) {
+        num_buckets += f + 1 - layers.size();
+        layers.resize(f + 1);
+    }
+    FLayer &layer = layers[f];
+    if (h >= static_cast<int>(layer.buckets.size())) {
+        num_buckets += h + 1 - layer.buckets.size();
+        layer.buckets.resize(h + 1);
+    }
+    layer.buckets[h].push(entry);
+    ++layer.size;
+    ++num_bucket_entries;
+    if (layer.size == 1 || h < layer.min_h) {
+        layer.min_h = h;
+    }
+    if (f < min_f) {
+        min_f = f;
+    }
+}
+
+template<class Entry>
+Entry FHBucketOpenList<Entry>::remove_min() {
+    assert(size > 0);
+    --size;
+    if (num_bucket_entries == 0 && overflow.empty()) {
+        --num_infinite_entries;
+        return infinite_bucket.pop();
+    }
+    if (num_bucket_entries > 0) {
+        while (layers[min_f].size == 0) {
+            // Release the memory of layers that we no longer need.
+            num_buckets -= layers[min_f].buckets.size();
+            layers[min_f].buckets = vector<Bucket<Entry>>();
+            ++min_f;
+            assert(min_f < static_cast<int>(layers.size()));
+        }
+        FLayer &layer = layers[min_f];
+        while (layer.buckets[layer.min_h].empty()) {
+            ++layer.min_h;
+            assert(layer.min_h < static_cast<int>(layer.buckets.size()));
+        }
+        if (overflow.empty() ||
+            make_pair(min_f, layer.min_h) < overflow.begin()->first) {
+            --layer.size;
+            --num_bucket_entries;
+            return layer.buckets[layer.min_h].pop();
+        }
+    }
+    auto it = overflow.begin();
+    Entry result = it->second.pop();
+    if (it->second.empty()) {
+        overflow.erase(it);
+    }
+    return result;
+}
+
+template<class Entry>
+bool FHBucketOpenList<Entry>::empty() const {
+    return size == 0;
+}
+
+template<class Entry>
+void FHBucketOpenList<Entry>::clear() {
+    layers.clear();
+    num_buckets = 0;
+    num_bucket_entries = 0;
+    overflow.clear();
+    infinite_bucket.clear();
+    size = 0;
+    num_infinite_entries = 0;
+    min_f = 0;
+}
+
+template<class Entry>
+void FHBucketOpenList<Entry>::get_path_dependent_evaluators(
+    set<Evaluator *> &evals) {
+    f_eval->get_path_dependent_evaluators(evals);
+    h_eval->get_path_dependent_evaluators(evals);
+}
+
+template<class Entry>
+void FHBucketOpenList<Entry>::get_evaluators(set<Evaluator *> &evals) {
+    evals.insert(f_eval.get());
+    evals.insert(h_eval.get());
+}
+
+template<class Entry>
+bool FHBucketOpenList<Entry>::is_dead_end(
+    EvaluationContext &eval_context) const {
+    // Same semantics as a tie-breaking open list without unsafe pruning.
+    if (is_reliable_dead_end(eval_context))
+        return true;
+    return eval_context.is_evaluator_value_infinite(f_eval.get()) &&
+           eval_context.is_evaluator_value_infinite(h_eval.get());
+}
+
+template<class Entry>
+bool FHBucketOpenList<Entry>::is_reliable_dead_end(
+    EvaluationContext &eval_context) const {
+    return (eval_context.is_evaluator_value_infinite(f_eval.get()) &&
+            f_eval->is_safe()) ||
+           (eval_context.is_evaluator_value_infinite(h_eval.get()) &&
+            h_eval->is_safe());
+}
+
+template<class Entry>
+bool FHBucketOpenList<Entry>::is_safe() const {
+    if (this->only_contains_preferred_entries()) {
+        return false;
+    }
+    return f_eval->is_safe() || h_eval->is_safe();
+}
+
+FHBucketOpenListFactory::FHBucketOpenListFactory(
+    const shared_ptr<AbstractTask> &task, const shared_ptr<Evaluator> &f_eval,
+    const shared_ptr<Evaluator> &h_eval, int max_operator_cost, bool pref_only)
+    : OpenListFactory(task),
+      f_eval(f_eval),
+      h_eval(h_eval),
+      max_operator_cost(max_operator_cost),
+      pref_only(pref_only) {
+}
+
+bool FHBucketOpenListFactory::use_buckets() const {
+    for (OperatorProxy op : task_proxy.get_operators()) {
+        if (op.get_cost() > max_operator_cost) {
+            return false;
+        }
+    }
+    return true;
+}
+
+unique_ptr<StateOpenList> FHBucketOpenListFactory::create_state_open_list() {
+    if (use_buckets()) {
+        return make_unique<FHBucketOpenList<StateOpenListEntry>>(
+            f_eval, h_eval, pref_only);
+    }
+    return tiebreaking_open_list::TieBreakingOpenListFactory(
+               task, {f_eval, h_eval}, false, pref_only)
+        .create_state_open_list();
+}
+
+unique_ptr<EdgeOpenList> FHBucketOpenListFactory::create_edge_open_list() {
+    if (use_buckets()) {
+        return make_unique<FHBucketOpenList<EdgeOpenListEntry>>(
+            f_eval, h_eval, pref_only);
+    }
+    return tiebreaking_open_list::TieBreakingOpenListFactory(
+               task, {f_eval, h_eval}, false, pref_only)
+        .create_edge_open_list();
+}
+
+class FHBucketOpenListFeature
+    : public plugins::TypedFeature<TaskIndependentOpenListFactory> {
+public:
+    FHBucketOpenListFeature() : TypedFeature("fh_buckets") {
+        document_title("Bucket-based (f, h) open list");
+        document_synopsis(
+            "Selects the entry with the lowest f value and breaks ties by "
+            "the lowest h value and then in FIFO order. This is equivalent to "
+            "tiebreaking([f, h], unsafe_pruning=false), but entries are "
+            "stored in buckets indexed by the f and h values, so that "
+            "insertion and removal take amortized constant time. "
+            "Since the number of buckets grows with the f values of the "
+            "open entries, the bucket-based implementation is only used if "
+            "all operator costs are at most max_operator_cost. Otherwise, a "
+            "tie-breaking open list is used. The number of buckets is also "
+            "limited to about one million; entries with larger f or h values "
+            "are kept in an ordered map instead. The evaluators must not "
+            "produce negative values.");
+
+        add_option<shared_ptr<TaskIndependentEvaluator>>("f", "f evaluator");
+        add_option<shared_ptr<TaskIndependentEvaluator>>("h", "h evaluator");
+        add_option<int>(
+            "max_operator_cost",
+            "largest operator cost for which buckets are used",
+            to_string(DEFAULT_MAX_OPERATOR_COST),
+            plugins::Bounds("0", "infinity"));
+        add_open_list_options_to_feature(*this);
+    }
+
+    virtual shared_ptr<TaskIndependentOpenListFactory> create_component(
+        const plugins::Options &opts) const override {
+        return components::make_auto_task_independent_component<
+            FHBucketOpenListFactory, OpenListFactory>(
+            opts.get<shared_ptr<TaskIndependentEvaluator>>("f"),
+            opts.get<shared_ptr<TaskIndependentEvaluator>>("h"),
+            opts.get<int>("max_operator_cost"),
+            get_open_list_arguments_from_options(opts));
+    }
+};
+
+static plugins::FeaturePlugin<FHBucketOpenListFeature> _plugin;
+}
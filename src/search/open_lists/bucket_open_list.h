@@ -0,0 +1,47 @@
+#ifndef OPEN_LISTS_BUCKET_OPEN_LIST_H
+#define OPEN_LISTS_BUCKET_OPEN_LIST_H
+
+#include "../open_list_factory.h"
+
+namespace bucket_open_list {
+/*
+  Largest operator cost for which A* uses the bucket-based open list. With
+  larger costs, the f values of the open entries are spread over many
+  buckets that mostly stay empty.
+*/
+const int DEFAULT_MAX_OPERATOR_COST = 100;
+
+/*
+  Open list factory for A*-style open lists that order entries by (f, h)
+  with ties broken in FIFO order, like a tie-breaking open list with the
+  evaluators [f, h].
+
+  Entries are stored in a two-level bucket queue that is indexed directly
+  by the f and h values, so insertions and removals take amortized constant
+  time. The number of buckets grows with the largest f and h values. We
+  therefore only use the bucket queue if no operator costs more than
+  max_operator_cost and fall back to a tie-breaking open list otherwise.
+  Since the evaluators can still produce large values (e.g., weighted
+  heuristics), the number of buckets is also limited. Entries that would
+  need more buckets are ordered by a map instead.
+*/
+class FHBucketOpenListFactory : public OpenListFactory {
+    std::shared_ptr<Evaluator> f_eval;
+    std::shared_ptr<Evaluator> h_eval;
+    int max_operator_cost;
+    bool pref_only;
+
+    bool use_buckets() const;
+public:
+    FHBucketOpenListFactory(
+        const std::shared_ptr<AbstractTask> &task,
+        const std::shared_ptr<Evaluator> &f_eval,
+        const std::shared_ptr<Evaluator> &h_eval, int max_operator_cost,
+        bool pref_only);
+
+    virtual std::unique_ptr<StateOpenList> create_state_open_list() override;
+    virtual std::unique_ptr<EdgeOpenList> create_edge_open_list() override;
+};
+}
+
+#endif
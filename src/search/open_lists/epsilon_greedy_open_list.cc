@@ -55,6 +55,7 @@ public:
     virtual bool is_safe() const override;
     virtual void get_path_dependent_evaluators(
         set<Evaluator *> &evals) override;
+    virtual void get_evaluators(set<Evaluator *> &evals) override;
     virtual bool empty() const override;
     virtual void clear() override;
 };
@@ -134,6 +135,11 @@ void EpsilonGreedyOpenList<Entry>::get_path_dependent_evaluators(
     evaluator->get_path_dependent_evaluators(evals);
 }
 
+template<class Entry>
+void EpsilonGreedyOpenList<Entry>::get_evaluators(set<Evaluator *> &evals) {
+    evals.insert(evaluator.get());
+}
+
 template<class Entry>
 bool EpsilonGreedyOpenList<Entry>::empty() const {
     return size == 0;
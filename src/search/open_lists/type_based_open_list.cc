@@ -43,6 +43,7 @@ public:
         EvaluationContext &eval_context) const override;
     virtual void get_path_dependent_evaluators(
         set<Evaluator *> &evals) override;
+    virtual void get_evaluators(set<Evaluator *> &evals) override;
     virtual bool is_safe() const override;
 };
 
@@ -135,6 +136,13 @@ void TypeBasedOpenList<Entry>::get_path_dependent_evaluators(
     }
 }
 
+template<class Entry>
+void TypeBasedOpenList<Entry>::get_evaluators(set<Evaluator *> &evals) {
+    for (const shared_ptr<Evaluator> &evaluator : evaluators) {
+        evals.insert(evaluator.get());
+    }
+}
+
 template<class Entry>
 bool TypeBasedOpenList<Entry>::is_safe() const {
     auto is_evaluator_safe = [](const auto &evaluator) {
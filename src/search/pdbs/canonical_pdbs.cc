@@ -2,6 +2,8 @@
 
 #include "pattern_database.h"
 
+#include "../task_proxy.h"
+
 #include <algorithm>
 #include <cassert>
 #include <iostream>
@@ -10,35 +12,63 @@
 using namespace std;
 
 namespace pdbs {
+/*
+  Buffers reused between evaluations to avoid allocations. They are
+  thread-local because the evaluations are const and may run in parallel.
+*/
+static thread_local vector<int> ranks;
+static thread_local vector<int> h_values;
+static thread_local vector<int> clique_sums;
+
 CanonicalPDBs::CanonicalPDBs(
     const shared_ptr<PDBCollection> &pdbs,
     const shared_ptr<vector<PatternClique>> &pattern_cliques)
-    : pdbs(pdbs), pattern_cliques(pattern_cliques) {
+    : pdbs(pdbs),
+      pattern_cliques(pattern_cliques),
+      lookup(*pdbs),
+      max_clique_sum(*pattern_cliques) {
     assert(pdbs);
     assert(pattern_cliques);
 }
 
+int CanonicalPDBs::compute_value(const int *state_ranks) const {
+    int num_pdbs = lookup.get_num_pdbs();
+    h_values.resize(num_pdbs);
+    clique_sums.resize(max_clique_sum.get_padded_num_cliques());
+    for (int i = 0; i < num_pdbs; ++i) {
+        int h = lookup.get_value(i, state_ranks[i]);
+        if (h == numeric_limits<int>::max()) {
+            return numeric_limits<int>::max();
+        }
+        h_values[i] = h;
+    }
+    return max_clique_sum.compute(h_values.data(), clique_sums.data());
+}
+
 int CanonicalPDBs::get_value(const State &state) const {
     // If we have an empty collection, then pattern_cliques = { \emptyset }.
     assert(!pattern_cliques->empty());
-    int max_h = 0;
-    vector<int> h_values;
-    h_values.reserve(pdbs->size());
     state.unpack();
-    for (const shared_ptr<PatternDatabase> &pdb : *pdbs) {
-        int h = pdb->get_value(state.get_unpacked_values());
-        if (h == numeric_limits<int>::max()) {
-            return numeric_limits<int>::max();
-        }
-        h_values.push_back(h);
+    ranks.resize(lookup.get_padded_num_pdbs());
+    lookup.compute_ranks(state.get_unpacked_values(), ranks.data());
+    return compute_value(ranks.data());
+}
+
+void CanonicalPDBs::get_values(
+    const vector<State> &states, vector<int> &values) const {
+    assert(!pattern_cliques->empty());
+    int num_states = states.size();
+    int stride = lookup.get_padded_num_pdbs();
+    ranks.resize(num_states * stride);
+    for (int i = 0; i < num_states; ++i) {
+        states[i].unpack();
+        lookup.compute_ranks(
+            states[i].get_unpacked_values(), ranks.data() + i * stride);
     }
-    for (const PatternClique &clique : *pattern_cliques) {
-        int clique_h = 0;
-        for (PatternID pdb_index : clique) {
-            clique_h += h_values[pdb_index];
-        }
-        max_h = max(max_h, clique_h);
+    values.clear();
+    values.reserve(num_states);
+    for (int i = 0; i < num_states; ++i) {
+        values.push_back(compute_value(ranks.data() + i * stride));
     }
-    return max_h;
 }
 }
@@ -1,9 +1,11 @@
 #ifndef PDBS_CANONICAL_PDBS_H
 #define PDBS_CANONICAL_PDBS_H
 
+#include "pdb_lookup.h"
 #include "types.h"
 
 #include <memory>
+#include <vector>
 
 class State;
 
@@ -11,14 +13,29 @@ namespace pdbs {
 class CanonicalPDBs {
     std::shared_ptr<PDBCollection> pdbs;
     std::shared_ptr<std::vector<PatternClique>> pattern_cliques;
+    PDBLookup lookup;
+    MaxCliqueSum max_clique_sum;
 
+    int compute_value(const int *state_ranks) const;
 public:
     CanonicalPDBs(
         const std::shared_ptr<PDBCollection> &pdbs,
         const std::shared_ptr<std::vector<PatternClique>> &pattern_cliques);
     ~CanonicalPDBs() = default;
 
+    /*
+      get_value and get_values may be called concurrently (e.g., by the
+      hill climbing of iPDB): they only use thread-local buffers.
+    */
     int get_value(const State &state) const;
+
+    /*
+      Store the value of states[i] in values[i]. The ranks of all states
+      are computed before any distance is read, so that the cache misses
+      for different states overlap.
+    */
+    void get_values(
+        const std::vector<State> &states, std::vector<int> &values) const;
 };
 }
 
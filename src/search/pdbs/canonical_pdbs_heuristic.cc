@@ -1,6 +1,7 @@
 #include "canonical_pdbs_heuristic.h"
 
 #include "dominance_pruning.h"
+#include "pattern_database.h"
 #include "utils.h"
 
 #include "../plugins/plugin.h"
@@ -17,7 +18,8 @@ namespace pdbs {
 static CanonicalPDBs get_canonical_pdbs(
     const shared_ptr<AbstractTask> &task,
     const shared_ptr<PatternCollectionGenerator> &pattern_generator,
-    double max_time_dominance_pruning, utils::LogProxy &log) {
+    double max_time_dominance_pruning, int max_table_size,
+    utils::LogProxy &log) {
     utils::Timer timer;
     if (log.is_at_least_normal()) {
         log << "Initializing canonical PDB heuristic..." << endl;
@@ -35,6 +37,28 @@ static CanonicalPDBs get_canonical_pdbs(
     shared_ptr<vector<PatternClique>> pattern_cliques =
         pattern_collection_info.get_pattern_cliques();
 
+    /*
+      The PDBs of the collection are shared with the pattern generator,
+      so we compress them into a new collection. We do this before
+      dominance pruning, which then removes the compressed PDBs together
+      with their patterns.
+    */
+    if (max_table_size < numeric_limits<int>::max()) {
+        auto compressed_pdbs = make_shared<PDBCollection>();
+        compressed_pdbs->reserve(pdbs->size());
+        int64_t memory = 0;
+        for (const shared_ptr<PatternDatabase> &pdb : *pdbs) {
+            compressed_pdbs->push_back(
+                PatternDatabase::compress(pdb, max_table_size, log));
+            memory += compressed_pdbs->back()->get_memory_usage();
+        }
+        pdbs = move(compressed_pdbs);
+        if (log.is_at_least_normal()) {
+            log << "Memory of the compressed PDBs: " << memory << " bytes"
+                << endl;
+        }
+    }
+
     if (max_time_dominance_pruning > 0.0) {
         int num_variables = TaskProxy(*task).get_variables().size();
         /*
@@ -59,11 +83,12 @@ static CanonicalPDBs get_canonical_pdbs(
 CanonicalPDBsHeuristic::CanonicalPDBsHeuristic(
     const shared_ptr<AbstractTask> &task,
     const shared_ptr<PatternCollectionGenerator> &patterns,
-    double max_time_dominance_pruning, bool cache_estimates,
-    const string &description, utils::Verbosity verbosity)
+    double max_time_dominance_pruning, int max_table_size,
+    bool cache_estimates, const string &description,
+    utils::Verbosity verbosity)
     : Heuristic(task, cache_estimates, description, verbosity),
-      canonical_pdbs(
-          get_canonical_pdbs(task, patterns, max_time_dominance_pruning, log)) {
+      canonical_pdbs(get_canonical_pdbs(
+          task, patterns, max_time_dominance_pruning, max_table_size, log)) {
 }
 
 int CanonicalPDBsHeuristic::compute_heuristic(const State &ancestor_state) {
@@ -76,6 +101,21 @@ int CanonicalPDBsHeuristic::compute_heuristic(const State &ancestor_state) {
     }
 }
 
+void CanonicalPDBsHeuristic::compute_heuristics(
+    const vector<State> &ancestor_states, vector<int> &values) {
+    vector<State> states;
+    states.reserve(ancestor_states.size());
+    for (const State &ancestor_state : ancestor_states) {
+        states.push_back(convert_ancestor_state(ancestor_state));
+    }
+    canonical_pdbs.get_values(states, values);
+    for (int &h : values) {
+        if (h == numeric_limits<int>::max()) {
+            h = DEAD_END;
+        }
+    }
+}
+
 void add_canonical_pdbs_options_to_feature(plugins::Feature &feature) {
     feature.add_option<double>(
         "max_time_dominance_pruning",
@@ -84,11 +124,14 @@ void add_canonical_pdbs_options_to_feature(plugins::Feature &feature) {
         "and additive subsets that will never contribute to the heuristic "
         "value because there are dominating subsets in the collection.",
         "infinity", plugins::Bounds("0.0", "infinity"));
+    add_max_table_size_option_to_feature(feature);
 }
 
-tuple<double> get_canonical_pdbs_arguments_from_options(
+tuple<double, int> get_canonical_pdbs_arguments_from_options(
     const plugins::Options &opts) {
-    return make_tuple(opts.get<double>("max_time_dominance_pruning"));
+    return make_tuple(
+        opts.get<double>("max_time_dominance_pruning"),
+        opts.get<int>("max_table_size"));
 }
 
 class CanonicalPDBsHeuristicFeature
@@ -115,7 +158,8 @@ public:
         document_language_support("axioms", "not supported");
 
         document_property("admissible", "yes");
-        document_property("consistent", "yes");
+        document_property(
+            "consistent", "yes if no variable is folded (see max_table_size)");
         document_property("safe", "yes");
         document_property("preferred operators", "no");
     }
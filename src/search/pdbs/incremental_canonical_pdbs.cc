@@ -1,6 +1,5 @@
 #include "incremental_canonical_pdbs.h"
 
-#include "canonical_pdbs.h"
 #include "pattern_database.h"
 #include "pattern_database_factory.h"
 
@@ -38,6 +37,8 @@ void IncrementalCanonicalPDBs::add_pdb(const shared_ptr<PatternDatabase> &pdb) {
 
 void IncrementalCanonicalPDBs::recompute_pattern_cliques() {
     pattern_cliques = compute_pattern_cliques(*patterns, are_additive);
+    canonical_pdbs =
+        make_unique<CanonicalPDBs>(pattern_databases, pattern_cliques);
 }
 
 vector<PatternClique> IncrementalCanonicalPDBs::get_pattern_cliques(
@@ -47,8 +48,7 @@ vector<PatternClique> IncrementalCanonicalPDBs::get_pattern_cliques(
 }
 
 int IncrementalCanonicalPDBs::get_value(const State &state) const {
-    CanonicalPDBs canonical_pdbs(pattern_databases, pattern_cliques);
-    return canonical_pdbs.get_value(state);
+    return canonical_pdbs->get_value(state);
 }
 
 bool IncrementalCanonicalPDBs::is_dead_end(const State &state) const {
@@ -1,6 +1,7 @@
 #ifndef PDBS_INCREMENTAL_CANONICAL_PDBS_H
 #define PDBS_INCREMENTAL_CANONICAL_PDBS_H
 
+#include "canonical_pdbs.h"
 #include "pattern_cliques.h"
 #include "pattern_collection_information.h"
 #include "types.h"
@@ -16,6 +17,11 @@ class IncrementalCanonicalPDBs {
     std::shared_ptr<PatternCollection> patterns;
     std::shared_ptr<PDBCollection> pattern_databases;
     std::shared_ptr<std::vector<PatternClique>> pattern_cliques;
+    /*
+      Built once per change of the collection because it precomputes the
+      lookup tables for all PDBs.
+    */
+    std::unique_ptr<CanonicalPDBs> canonical_pdbs;
 
     // A pair of variables is additive if no operator has an effect on both.
     VariableAdditivity are_additive;
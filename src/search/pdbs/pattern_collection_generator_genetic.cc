@@ -1,5 +1,6 @@
 #include "pattern_collection_generator_genetic.h"
 
+#include "pattern_database_factory.h"
 #include "utils.h"
 #include "validation.h"
 #include "zero_one_pdbs.h"
@@ -11,6 +12,7 @@
 #include "../utils/logging.h"
 #include "../utils/markup.h"
 #include "../utils/math.h"
+#include "../utils/parallel.h"
 #include "../utils/rng.h"
 #include "../utils/rng_options.h"
 #include "../utils/timer.h"
@@ -18,6 +20,7 @@
 #include <algorithm>
 #include <cassert>
 #include <iostream>
+#include <limits>
 #include <unordered_set>
 #include <vector>
 
@@ -165,13 +168,16 @@ bool PatternCollectionGeneratorGenetic::mark_used_variables(
 void PatternCollectionGeneratorGenetic::evaluate(
     vector<double> &fitness_values) {
     TaskProxy task_proxy(*task);
-    for (size_t i = 0; i < pattern_collections.size(); ++i) {
+    int num_collections = pattern_collections.size();
+    // Valid pattern collections (nullptr for invalid ones).
+    vector<shared_ptr<PatternCollection>> valid_collections;
+    valid_collections.reserve(num_collections);
+    for (int i = 0; i < num_collections; ++i) {
         const auto &collection = pattern_collections[i];
         if (log.is_at_least_debug()) {
             log << "evaluate pattern collection " << (i + 1) << " of "
-                << pattern_collections.size() << endl;
+                << num_collections << endl;
         }
-        double fitness = 0;
         bool pattern_valid = true;
         vector<bool> variables_used(task_proxy.get_variables().size(), false);
         shared_ptr<PatternCollection> pattern_collection =
@@ -201,25 +207,36 @@ void PatternCollectionGeneratorGenetic::evaluate(
             remove_irrelevant_variables(pattern);
             pattern_collection->push_back(pattern);
         }
-        if (!pattern_valid) {
-            /* Set fitness to a very small value to cover cases in which all
-               patterns are invalid. */
-            fitness = 0.001;
-        } else {
-            /* Generate the pattern collection heuristic and get its fitness
-               value. */
-            ZeroOnePDBs zero_one_pdbs(task_proxy, *pattern_collection);
-            fitness = zero_one_pdbs.compute_approx_mean_finite_h();
-            // Update the best heuristic found so far.
-            if (fitness > best_fitness) {
-                best_fitness = fitness;
-                if (log.is_at_least_normal()) {
-                    log << "best_fitness = " << best_fitness << endl;
-                }
-                best_patterns = pattern_collection;
+        valid_collections.push_back(
+            pattern_valid ? pattern_collection : nullptr);
+    }
+
+    /*
+      Generate the pattern collection heuristics and get their fitness
+      values. Set the fitness of invalid collections to a very small value
+      to cover cases in which all patterns are invalid. The collections are
+      independent, so we evaluate them concurrently.
+    */
+    fitness_values.assign(num_collections, 0.001);
+    prepare_concurrent_pdb_computation(task_proxy);
+    utils::parallel_for(num_collections, [&](int i) {
+        if (valid_collections[i]) {
+            ZeroOnePDBs zero_one_pdbs(
+                task_proxy, *valid_collections[i], numeric_limits<int>::max(),
+                log);
+            fitness_values[i] = zero_one_pdbs.compute_approx_mean_finite_h();
+        }
+    });
+
+    // Update the best heuristic found so far.
+    for (int i = 0; i < num_collections; ++i) {
+        if (valid_collections[i] && fitness_values[i] > best_fitness) {
+            best_fitness = fitness_values[i];
+            if (log.is_at_least_normal()) {
+                log << "best_fitness = " << best_fitness << endl;
             }
+            best_patterns = valid_collections[i];
         }
-        fitness_values.push_back(fitness);
     }
 }
 
@@ -74,7 +74,8 @@ class PatternCollectionGeneratorGenetic : public PatternCollectionGenerator {
       partitioning pattern collection heuristic is constructed and its fitness
       ( = summed up mean h-values (dead ends are ignored) of all PDBs in the
       collection) computed. The overall best heuristic is eventually updated and
-      saved for further episodes.
+      saved for further episodes. The heuristics of different collections are
+      computed concurrently if several preprocessing threads are available.
     */
     void evaluate(std::vector<double> &fitness_values);
     bool is_pattern_too_large(const Pattern &pattern) const;
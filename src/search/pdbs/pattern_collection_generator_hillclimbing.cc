@@ -16,11 +16,13 @@
 #include "../utils/logging.h"
 #include "../utils/markup.h"
 #include "../utils/math.h"
+#include "../utils/parallel.h"
 #include "../utils/rng.h"
 #include "../utils/rng_options.h"
 #include "../utils/timer.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <iostream>
 #include <limits>
@@ -138,7 +140,7 @@ int PatternCollectionGeneratorHillclimbing::generate_candidate_pdbs(
     PDBCollection &candidate_pdbs) {
     const Pattern &pattern = pdb.get_pattern();
     int pdb_size = pdb.get_size();
-    int max_pdb_size = 0;
+    PatternCollection new_patterns;
     for (int pattern_var : pattern) {
         assert(utils::in_bounds(pattern_var, relevant_neighbours));
         const vector<int> &connected_vars = relevant_neighbours[pattern_var];
@@ -164,16 +166,21 @@ int PatternCollectionGeneratorHillclimbing::generate_candidate_pdbs(
                       surpass the size limit.
                     */
                     generated_patterns.insert(new_pattern);
-                    candidate_pdbs.push_back(
-                        compute_pdb(task_proxy, new_pattern));
-                    max_pdb_size =
-                        max(max_pdb_size, candidate_pdbs.back()->get_size());
+                    new_patterns.push_back(move(new_pattern));
                 }
             } else {
                 ++num_rejected;
             }
         }
     }
+
+    // The PDBs are independent, so we can compute them concurrently.
+    PDBCollection new_pdbs = compute_pdbs(task_proxy, new_patterns);
+    int max_pdb_size = 0;
+    for (shared_ptr<PatternDatabase> &new_pdb : new_pdbs) {
+        max_pdb_size = max(max_pdb_size, new_pdb->get_size());
+        candidate_pdbs.push_back(move(new_pdb));
+    }
     return max_pdb_size;
 }
 
@@ -207,11 +214,8 @@ pair<int, int> PatternCollectionGeneratorHillclimbing::find_best_improving_pdb(
     int improvement = 0;
     int best_pdb_index = -1;
 
-    // Iterate over all candidates and search for the best improving pattern/pdb
-    for (size_t i = 0; i < candidate_pdbs.size(); ++i) {
-        if (hill_climbing_timer->is_expired())
-            throw HillClimbingTimeout();
-
+    int num_candidates = candidate_pdbs.size();
+    for (int i = 0; i < num_candidates; ++i) {
         const shared_ptr<PatternDatabase> &pdb = candidate_pdbs[i];
         if (!pdb) {
             /* candidate pattern is too large or has already been added to
@@ -225,19 +229,33 @@ pair<int, int> PatternCollectionGeneratorHillclimbing::find_best_improving_pdb(
         int combined_size = current_pdbs->get_size() + pdb->get_size();
         if (combined_size > collection_max_size) {
             candidate_pdbs[i] = nullptr;
-            continue;
         }
+    }
 
-        /*
-          Calculate the "counting approximation" for all sample states: count
-          the number of samples for which the current pattern collection
-          heuristic would be improved if the new pattern was included into it.
-        */
-        /*
-          TODO: The original implementation by Haslum et al. uses m/t as a
-          statistical confidence interval to stop the A*-search (which they use,
-          see above) earlier.
-        */
+    /*
+      Calculate the "counting approximation" for all sample states: count
+      the number of samples for which the current pattern collection
+      heuristic would be improved if the new pattern was included into it.
+      The candidates are scored concurrently, but the best one is selected
+      in the order of candidate_pdbs afterwards, so the result does not
+      depend on the number of threads.
+    */
+    /*
+      TODO: The original implementation by Haslum et al. uses m/t as a
+      statistical confidence interval to stop the A*-search (which they use,
+      see above) earlier.
+    */
+    vector<int> counts(num_candidates, 0);
+    atomic<bool> timed_out(false);
+    utils::parallel_for(num_candidates, [&](int i) {
+        const shared_ptr<PatternDatabase> &pdb = candidate_pdbs[i];
+        if (!pdb || timed_out) {
+            return;
+        }
+        if (hill_climbing_timer->is_expired()) {
+            timed_out = true;
+            return;
+        }
         int count = 0;
         vector<PatternClique> pattern_cliques =
             current_pdbs->get_pattern_cliques(pdb->get_pattern());
@@ -251,6 +269,14 @@ pair<int, int> PatternCollectionGeneratorHillclimbing::find_best_improving_pdb(
                 ++count;
             }
         }
+        counts[i] = count;
+    });
+    if (timed_out) {
+        throw HillClimbingTimeout();
+    }
+
+    for (int i = 0; i < num_candidates; ++i) {
+        int count = counts[i];
         if (count > improvement) {
             improvement = count;
             best_pdb_index = i;
@@ -642,7 +668,8 @@ public:
         document_language_support("axioms", "not supported");
 
         document_property("admissible", "yes");
-        document_property("consistent", "yes");
+        document_property(
+            "consistent", "yes if no variable is folded (see max_table_size)");
         document_property("safe", "yes");
         document_property("preferred operators", "no");
     }
@@ -658,7 +685,7 @@ public:
 
         return components::make_auto_task_independent_component<
             CanonicalPDBsHeuristic, Evaluator>(
-            pgh, opts.get<double>("max_time_dominance_pruning"),
+            pgh, get_canonical_pdbs_arguments_from_options(opts),
             get_heuristic_arguments_from_options(opts));
     }
 };
@@ -10,6 +10,7 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cstdint>
 #include <unordered_set>
 #include <utility>
 
@@ -62,14 +63,15 @@ void PatternCollectionInformation::create_pdbs_if_missing() {
         if (log.is_at_least_normal()) {
             log << "Computing PDBs for pattern collection..." << endl;
         }
-        pdbs = make_shared<PDBCollection>();
-        for (const Pattern &pattern : *patterns) {
-            shared_ptr<PatternDatabase> pdb = compute_pdb(task_proxy, pattern);
-            pdbs->push_back(pdb);
-        }
+        pdbs = make_shared<PDBCollection>(compute_pdbs(task_proxy, *patterns));
         if (log.is_at_least_normal()) {
+            int64_t memory = 0;
+            for (const shared_ptr<PatternDatabase> &pdb : *pdbs) {
+                memory += pdb->get_memory_usage();
+            }
             log << "Done computing PDBs for pattern collection: " << timer
                 << endl;
+            log << "Memory of the PDBs: " << memory << " bytes" << endl;
         }
     }
 }
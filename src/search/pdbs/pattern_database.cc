@@ -1,9 +1,11 @@
 #include "pattern_database.h"
 
 #include "../task_utils/task_properties.h"
+#include "../utils/collections.h"
 #include "../utils/logging.h"
 #include "../utils/math.h"
 
+#include <algorithm>
 #include <cassert>
 #include <iostream>
 #include <limits>
@@ -12,6 +14,11 @@
 using namespace std;
 
 namespace pdbs {
+static int get_num_cell_words(int num_cells, int log_cell_bits) {
+    int cells_per_word = 1 << (6 - log_cell_bits);
+    return (num_cells + cells_per_word - 1) / cells_per_word;
+}
+
 Projection::Projection(const TaskProxy &task_proxy, const Pattern &pattern)
     : pattern(pattern) {
     task_properties::verify_no_axioms(task_proxy);
@@ -52,19 +59,94 @@ int Projection::unrank(int index, int var) const {
 
 PatternDatabase::PatternDatabase(
     Projection &&projection, vector<int> &&distances)
-    : projection(move(projection)), distances(move(distances)) {
+    : projection(move(projection)),
+      table_size(this->projection.get_num_abstract_states()) {
+    int num_vars = this->projection.get_pattern().size();
+    table_multipliers.reserve(num_vars);
+    for (int var = 0; var < num_vars; ++var) {
+        table_multipliers.push_back(this->projection.get_multiplier(var));
+    }
+    set_distances(distances);
+    // The packed table replaces the given distances.
+    utils::release_vector_memory(distances);
+}
+
+PatternDatabase::PatternDatabase(
+    const Projection &projection, vector<int> &&table_multipliers,
+    vector<int> &&distances)
+    : projection(projection),
+      table_multipliers(move(table_multipliers)),
+      table_size(distances.size()) {
+    set_distances(distances);
+    utils::release_vector_memory(distances);
+}
+
+PatternDatabase::PatternDatabase(
+    Projection &&projection, int log_cell_bits, const uint64_t *cells,
+    const shared_ptr<const utils::MappedFile> &mapped_file)
+    : projection(move(projection)),
+      table_size(this->projection.get_num_abstract_states()),
+      log_cell_bits(log_cell_bits),
+      num_cell_words(get_num_cell_words(table_size, log_cell_bits)),
+      cells(cells),
+      mapped_file(mapped_file) {
+    assert(log_cell_bits >= 2 && log_cell_bits <= 5);
+    int num_vars = this->projection.get_pattern().size();
+    table_multipliers.reserve(num_vars);
+    for (int var = 0; var < num_vars; ++var) {
+        table_multipliers.push_back(this->projection.get_multiplier(var));
+    }
+}
+
+void PatternDatabase::set_distances(const vector<int> &distances) {
+    assert(static_cast<int>(distances.size()) == table_size);
+    int max_finite_distance = 0;
+    for (int distance : distances) {
+        if (distance != numeric_limits<int>::max()) {
+            max_finite_distance = max(max_finite_distance, distance);
+        }
+    }
+    log_cell_bits = 2;
+    uint64_t cell_mask = 0xF;
+    while (static_cast<uint64_t>(max_finite_distance) >= cell_mask) {
+        ++log_cell_bits;
+        cell_mask = (uint64_t(1) << (1 << log_cell_bits)) - 1;
+    }
+    assert(log_cell_bits <= 5);
+
+    int log_cells_per_word = 6 - log_cell_bits;
+    int cells_per_word = 1 << log_cells_per_word;
+    num_cell_words = get_num_cell_words(table_size, log_cell_bits);
+    owned_cells.assign(num_cell_words, 0);
+    for (int index = 0; index < table_size; ++index) {
+        uint64_t value = distances[index] == numeric_limits<int>::max()
+                             ? cell_mask
+                             : distances[index];
+        int shift = (index & (cells_per_word - 1)) << log_cell_bits;
+        owned_cells[index >> log_cells_per_word] |= value << shift;
+    }
+    cells = owned_cells.data();
+    mapped_file = nullptr;
 }
 
 int PatternDatabase::get_value(const vector<int> &state) const {
-    return distances[projection.rank(state)];
+    const Pattern &pattern = projection.get_pattern();
+    int index = 0;
+    for (size_t i = 0; i < pattern.size(); ++i) {
+        index += table_multipliers[i] * state[pattern[i]];
+    }
+    return get_distance(index);
 }
 
-double PatternDatabase::compute_mean_finite_h() const {
+template<typename GetDistance>
+static double compute_mean_finite_distance(
+    int num_distances, const GetDistance &get_distance) {
     double sum = 0;
     int size = 0;
-    for (size_t i = 0; i < distances.size(); ++i) {
-        if (distances[i] != numeric_limits<int>::max()) {
-            sum += distances[i];
+    for (int index = 0; index < num_distances; ++index) {
+        int distance = get_distance(index);
+        if (distance != numeric_limits<int>::max()) {
+            sum += distance;
             ++size;
         }
     }
@@ -74,4 +156,87 @@ double PatternDatabase::compute_mean_finite_h() const {
         return sum / size;
     }
 }
+
+double PatternDatabase::compute_mean_finite_h() const {
+    return compute_mean_finite_distance(
+        table_size, [this](int index) { return get_distance(index); });
+}
+
+/*
+  Fold the variable with the given table multiplier and domain size. The
+  table is indexed by the unfolded variables in the order of the pattern,
+  so folding the variable merges each block of domain_size entries with
+  distance multiplier into one block.
+*/
+static vector<int> compute_folded_distances(
+    const vector<int> &distances, int multiplier, int domain_size) {
+    assert(multiplier != 0);
+    int table_size = distances.size();
+    int block_size = multiplier * domain_size;
+    vector<int> folded(table_size / domain_size, numeric_limits<int>::max());
+    for (int index = 0; index < table_size; ++index) {
+        int new_index = index % multiplier + index / block_size * multiplier;
+        folded[new_index] = min(folded[new_index], distances[index]);
+    }
+    return folded;
+}
+
+shared_ptr<PatternDatabase> PatternDatabase::compress(
+    const shared_ptr<PatternDatabase> &pdb, int max_table_size,
+    utils::LogProxy &log) {
+    if (pdb->table_size <= max_table_size) {
+        return pdb;
+    }
+    const Projection &projection = pdb->projection;
+    vector<int> table_multipliers = pdb->table_multipliers;
+    vector<int> distances;
+    distances.reserve(pdb->table_size);
+    for (int index = 0; index < pdb->table_size; ++index) {
+        distances.push_back(pdb->get_distance(index));
+    }
+    int num_vars = table_multipliers.size();
+    bool folded_any = false;
+    while (static_cast<int>(distances.size()) > max_table_size) {
+        int best_var = -1;
+        double best_mean_h = -1;
+        vector<int> best_distances;
+        for (int var = 0; var < num_vars; ++var) {
+            if (table_multipliers[var] == 0 ||
+                projection.get_domain_size(var) == 1) {
+                continue;
+            }
+            vector<int> folded = compute_folded_distances(
+                distances, table_multipliers[var],
+                projection.get_domain_size(var));
+            double mean_h = compute_mean_finite_distance(
+                folded.size(),
+                [&folded](int index) { return folded[index]; });
+            if (mean_h > best_mean_h) {
+                best_mean_h = mean_h;
+                best_var = var;
+                best_distances = move(folded);
+            }
+        }
+        if (best_var == -1) {
+            break;
+        }
+        if (log.is_at_least_verbose()) {
+            log << "Folding variable " << projection.get_pattern()[best_var]
+                << " of pattern " << projection.get_pattern()
+                << " (mean finite h-value " << best_mean_h << ")" << endl;
+        }
+        int domain_size = projection.get_domain_size(best_var);
+        table_multipliers[best_var] = 0;
+        for (int var = best_var + 1; var < num_vars; ++var) {
+            table_multipliers[var] /= domain_size;
+        }
+        distances = move(best_distances);
+        folded_any = true;
+    }
+    if (!folded_any) {
+        return pdb;
+    }
+    return shared_ptr<PatternDatabase>(new PatternDatabase(
+        projection, move(table_multipliers), move(distances)));
+}
 }
@@ -5,8 +5,17 @@
 
 #include "../task_proxy.h"
 
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <span>
 #include <vector>
 
+namespace utils {
+class LogProxy;
+class MappedFile;
+}
+
 namespace pdbs {
 class Projection {
     Pattern pattern;
@@ -36,18 +45,79 @@ public:
     int get_multiplier(int var) const {
         return hash_multipliers[var];
     }
+
+    int get_domain_size(int var) const {
+        return domain_sizes[var];
+    }
 };
 
+/*
+  Return the distance in cell index of the given cells of 2^log_cell_bits
+  bits (see PatternDatabase).
+*/
+inline int get_packed_distance(
+    const uint64_t *cells, int log_cell_bits, int index) {
+    int log_cells_per_word = 6 - log_cell_bits;
+    uint64_t word = cells[index >> log_cells_per_word];
+    int shift = (index & ((1 << log_cells_per_word) - 1)) << log_cell_bits;
+    uint64_t cell_mask = (uint64_t(1) << (1 << log_cell_bits)) - 1;
+    uint64_t value = (word >> shift) & cell_mask;
+    if (value == cell_mask) {
+        return std::numeric_limits<int>::max();
+    }
+    return static_cast<int>(value);
+}
+
 class PatternDatabase {
     Projection projection;
 
     /*
-      final h-values for abstract-states.
-      dead-ends are represented by numeric_limits<int>::max()
+      Multipliers for ranking abstract states in the distance table, one for
+      each variable of the pattern. They are the hash multipliers of the
+      projection unless variables were folded (see compress). Folded
+      variables have multiplier 0.
     */
-    std::vector<int> distances;
+    std::vector<int> table_multipliers;
+    int table_size;
+
+    /*
+      Final h-values for abstract states, packed into cells of
+      2^log_cell_bits bits. We use the narrowest of 4, 8, 16 and 32 bits in
+      which all finite h-values fit. Dead ends are represented by the
+      largest value of a cell.
+    */
+    int log_cell_bits;
+    int num_cell_words;
+    const uint64_t *cells;
+    /*
+      The cells are either owned by the PDB or stored in a file of the PDB
+      cache (see pdb_cache.h) that is mapped into memory.
+    */
+    std::vector<uint64_t> owned_cells;
+    std::shared_ptr<const utils::MappedFile> mapped_file;
+
+    void set_distances(const std::vector<int> &distances);
+
+    int get_distance(int index) const {
+        return get_packed_distance(cells, log_cell_bits, index);
+    }
+
+    // Use the given table of distances with folded variables (see compress).
+    PatternDatabase(
+        const Projection &projection, std::vector<int> &&table_multipliers,
+        std::vector<int> &&distances);
 public:
     PatternDatabase(Projection &&projection, std::vector<int> &&distances);
+    /*
+      Use the given cells of a mapped file without copying them. The PDB
+      keeps the file open.
+    */
+    PatternDatabase(
+        Projection &&projection, int log_cell_bits, const uint64_t *cells,
+        const std::shared_ptr<const utils::MappedFile> &mapped_file);
+    PatternDatabase(const PatternDatabase &) = delete;
+    PatternDatabase &operator=(const PatternDatabase &) = delete;
+
     int get_value(const std::vector<int> &state) const;
 
     const Pattern &get_pattern() const {
@@ -68,6 +138,45 @@ public:
       this method!
     */
     double compute_mean_finite_h() const;
+
+    /*
+      Return a PDB whose distance table has at most max_table_size entries,
+      computed with min-compression: repeatedly fold a pattern variable,
+      i.e., merge the entries for all values of the variable into their
+      minimum, choosing the variable that keeps the highest mean finite
+      h-value. The result stays admissible (and the pattern is unchanged,
+      so additivity is unaffected), but it is consistent only if no
+      variable is folded.
+
+      PDBs are shared (e.g., by PatternCollectionInformation and the PDB
+      cache), so the given PDB is never changed. If it is small enough, it
+      is returned itself.
+    */
+    static std::shared_ptr<PatternDatabase> compress(
+        const std::shared_ptr<PatternDatabase> &pdb, int max_table_size,
+        utils::LogProxy &log);
+
+    bool has_folded_variables() const {
+        return table_size != projection.get_num_abstract_states();
+    }
+
+    // Multipliers for ranking states (0 for folded variables).
+    const std::vector<int> &get_table_multipliers() const {
+        return table_multipliers;
+    }
+
+    int get_log_cell_bits() const {
+        return log_cell_bits;
+    }
+
+    std::span<const uint64_t> get_cells() const {
+        return {cells, static_cast<size_t>(num_cell_words)};
+    }
+
+    // Number of bytes used for the distance table.
+    int64_t get_memory_usage() const {
+        return static_cast<int64_t>(num_cell_words) * sizeof(uint64_t);
+    }
 };
 }
 
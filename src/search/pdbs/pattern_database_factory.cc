@@ -3,25 +3,48 @@
 #include "abstract_operator.h"
 #include "match_tree.h"
 #include "pattern_database.h"
+#include "pdb_cache.h"
 
 #include "../algorithms/priority_queues.h"
+#include "../task_utils/flattened_task.h"
 #include "../task_utils/task_properties.h"
+#include "../utils/collections.h"
 #include "../utils/math.h"
+#include "../utils/parallel.h"
 #include "../utils/rng.h"
 
 #include <algorithm>
+#include <atomic>
+#include <barrier>
 #include <cassert>
+#include <exception>
 #include <limits>
+#include <map>
+#include <span>
 #include <vector>
 
 using namespace std;
 
 namespace pdbs {
+/*
+  Smaller PDBs are always computed with one thread because starting the
+  threads and synchronizing them would take longer than the computation.
+*/
+static const int MIN_STATES_FOR_PARALLEL_DISTANCES = 100000;
+
 class PatternDatabaseFactory {
     const TaskProxy &task_proxy;
-    VariablesProxy variables;
+    const flattened_task::FlattenedTask &flat_task;
     Projection projection;
     vector<int> variable_to_index;
+    /*
+      Used by build_abstract_operators_for_op and indexed by pattern
+      variables: the precondition value of the current operator or -1,
+      and whether the operator also has an effect on the variable. They
+      are reset after each operator.
+    */
+    vector<int> precondition_values;
+    vector<bool> has_precondition_and_effect;
     vector<AbstractOperator> abstract_ops;
     vector<FactPair> abstract_goals;
     vector<int> distances;
@@ -60,8 +83,7 @@ class PatternDatabaseFactory {
       variables in the task to their index in the pattern or -1.
     */
     void build_abstract_operators_for_op(
-        const OperatorProxy &op, int cost,
-        vector<AbstractOperator> &operators) const;
+        int op_id, int cost, vector<AbstractOperator> &operators);
 
     void compute_abstract_operators(const vector<int> &operator_costs);
 
@@ -85,6 +107,24 @@ class PatternDatabaseFactory {
 
     void compute_distances(const MatchTree &match_tree, bool compute_plan);
 
+    /*
+      Compute the same distances as compute_distances with multiple
+      threads (see utils::g_parallel_pdb_distances), but without the
+      generating operators for plans. Abstract states are put into buckets
+      of width delta by their distance, where delta is the minimal
+      positive cost of an abstract operator. Regressing a state can then
+      only reach states in later buckets, except via zero-cost operators,
+      so all states in the lowest bucket can be regressed in parallel.
+      This is level-synchronous regression for unit costs and
+      delta-stepping in general. The threads regress chunks of the states
+      in the current bucket (they only read the match tree) and decrease
+      the distances of the predecessors with atomic operations. Between
+      two rounds, one thread moves the reached predecessors to their
+      buckets. States whose distance decreases after they were regressed
+      (via zero-cost operators) are regressed again.
+    */
+    void compute_distances_in_parallel(const MatchTree &match_tree);
+
     void compute_plan(
         const MatchTree &match_tree,
         const shared_ptr<utils::RandomNumberGenerator> &rng,
@@ -108,10 +148,12 @@ public:
 };
 
 void PatternDatabaseFactory::compute_variable_to_index(const Pattern &pattern) {
-    variable_to_index.resize(variables.size(), -1);
+    variable_to_index.resize(flat_task.get_num_variables(), -1);
     for (size_t i = 0; i < pattern.size(); ++i) {
         variable_to_index[pattern[i]] = i;
     }
+    precondition_values.resize(pattern.size(), -1);
+    has_precondition_and_effect.resize(pattern.size(), false);
 }
 
 AbstractOperator PatternDatabaseFactory::build_abstract_operator(
@@ -158,8 +200,9 @@ void PatternDatabaseFactory::multiply_out(
         // abstract operator.
         int var_id = effects_without_pre[pos].var;
         int eff = effects_without_pre[pos].value;
-        VariableProxy var = variables[projection.get_pattern()[var_id]];
-        for (int i = 0; i < var.get_domain_size(); ++i) {
+        int domain_size =
+            flat_task.get_domain_size(projection.get_pattern()[var_id]);
+        for (int i = 0; i < domain_size; ++i) {
             if (i != eff) {
                 pre_pairs.emplace_back(var_id, i);
                 eff_pairs.emplace_back(var_id, eff);
@@ -180,8 +223,7 @@ void PatternDatabaseFactory::multiply_out(
 }
 
 void PatternDatabaseFactory::build_abstract_operators_for_op(
-    const OperatorProxy &op, int cost,
-    vector<AbstractOperator> &operators) const {
+    int op_id, int cost, vector<AbstractOperator> &operators) {
     // All variable value pairs that are a prevail condition
     vector<FactPair> prev_pairs;
     // All variable value pairs that are a precondition (value != -1)
@@ -191,53 +233,55 @@ void PatternDatabaseFactory::build_abstract_operators_for_op(
     // All variable value pairs that are a precondition (value = -1)
     vector<FactPair> effects_without_pre;
 
-    size_t num_vars = variables.size();
-    vector<bool> has_precond_and_effect_on_var(num_vars, false);
-    vector<bool> has_precondition_on_var(num_vars, false);
-
-    for (FactProxy pre : op.get_preconditions())
-        has_precondition_on_var[pre.get_variable().get_id()] = true;
+    /*
+      Only the facts of pattern variables matter, so we only look at
+      them and only touch the entries of pattern variables.
+    */
+    span<const FactPair> preconditions = flat_task.get_preconditions(op_id);
+    for (const FactPair &pre : preconditions) {
+        int pattern_var_id = variable_to_index[pre.var];
+        if (pattern_var_id != -1)
+            precondition_values[pattern_var_id] = pre.value;
+    }
 
-    for (EffectProxy eff : op.get_effects()) {
-        int var_id = eff.get_fact().get_variable().get_id();
-        int pattern_var_id = variable_to_index[var_id];
-        int val = eff.get_fact().get_value();
+    for (const FactPair &eff : flat_task.get_effects(op_id)) {
+        int pattern_var_id = variable_to_index[eff.var];
         if (pattern_var_id != -1) {
-            if (has_precondition_on_var[var_id]) {
-                has_precond_and_effect_on_var[var_id] = true;
-                eff_pairs.emplace_back(pattern_var_id, val);
+            if (precondition_values[pattern_var_id] != -1) {
+                has_precondition_and_effect[pattern_var_id] = true;
+                eff_pairs.emplace_back(pattern_var_id, eff.value);
             } else {
-                effects_without_pre.emplace_back(pattern_var_id, val);
+                effects_without_pre.emplace_back(pattern_var_id, eff.value);
             }
         }
     }
-    for (FactProxy pre : op.get_preconditions()) {
-        int var_id = pre.get_variable().get_id();
-        int pattern_var_id = variable_to_index[var_id];
-        int val = pre.get_value();
+    for (const FactPair &pre : preconditions) {
+        int pattern_var_id = variable_to_index[pre.var];
         if (pattern_var_id != -1) { // variable occurs in pattern
-            if (has_precond_and_effect_on_var[var_id]) {
-                pre_pairs.emplace_back(pattern_var_id, val);
+            if (has_precondition_and_effect[pattern_var_id]) {
+                pre_pairs.emplace_back(pattern_var_id, pre.value);
             } else {
-                prev_pairs.emplace_back(pattern_var_id, val);
+                prev_pairs.emplace_back(pattern_var_id, pre.value);
             }
+            precondition_values[pattern_var_id] = -1;
+            has_precondition_and_effect[pattern_var_id] = false;
         }
     }
     multiply_out(
-        op.get_id(), cost, 0, prev_pairs, pre_pairs, eff_pairs,
-        effects_without_pre, operators);
+        op_id, cost, 0, prev_pairs, pre_pairs, eff_pairs, effects_without_pre,
+        operators);
 }
 
 void PatternDatabaseFactory::compute_abstract_operators(
     const vector<int> &operator_costs) {
-    for (OperatorProxy op : task_proxy.get_operators()) {
+    for (int op_id = 0; op_id < flat_task.get_num_operators(); ++op_id) {
         int op_cost;
         if (operator_costs.empty()) {
-            op_cost = op.get_cost();
+            op_cost = flat_task.get_cost(op_id);
         } else {
-            op_cost = operator_costs[op.get_id()];
+            op_cost = operator_costs[op_id];
         }
-        build_abstract_operators_for_op(op, op_cost, abstract_ops);
+        build_abstract_operators_for_op(op_id, op_cost, abstract_ops);
     }
 }
 
@@ -252,11 +296,10 @@ unique_ptr<MatchTree> PatternDatabaseFactory::compute_match_tree() const {
 }
 
 void PatternDatabaseFactory::compute_abstract_goals() {
-    for (FactProxy goal : task_proxy.get_goals()) {
-        int var_id = goal.get_variable().get_id();
-        int val = goal.get_value();
-        if (variable_to_index[var_id] != -1) {
-            abstract_goals.emplace_back(variable_to_index[var_id], val);
+    for (const FactPair &goal : flat_task.get_goals()) {
+        int pattern_var_id = variable_to_index[goal.var];
+        if (pattern_var_id != -1) {
+            abstract_goals.emplace_back(pattern_var_id, goal.value);
         }
     }
 }
@@ -331,6 +374,139 @@ void PatternDatabaseFactory::compute_distances(
     }
 }
 
+void PatternDatabaseFactory::compute_distances_in_parallel(
+    const MatchTree &match_tree) {
+    const int num_threads = utils::g_num_preprocessing_threads;
+    const int num_states = projection.get_num_abstract_states();
+    const int infinity = numeric_limits<int>::max();
+    // Threads take chunks of this many states from a shared index.
+    const int chunk_size = 1024;
+
+    int delta = infinity;
+    for (const AbstractOperator &op : abstract_ops) {
+        if (op.get_cost() > 0)
+            delta = min(delta, op.get_cost());
+    }
+
+    // Found goal states or reached predecessors of each thread.
+    vector<vector<int>> outboxes(num_threads);
+
+    distances.assign(num_states, infinity);
+    atomic<int> next_index(0);
+    utils::run_in_parallel(num_threads, [&](int thread_id) {
+        vector<int> &goal_states = outboxes[thread_id];
+        int start;
+        while ((start = next_index.fetch_add(chunk_size)) < num_states) {
+            int end = min(start + chunk_size, num_states);
+            for (int state_index = start; state_index < end; ++state_index) {
+                if (is_goal_state(state_index)) {
+                    distances[state_index] = 0;
+                    goal_states.push_back(state_index);
+                }
+            }
+        }
+    });
+
+    // buckets[i] holds states whose distance was set to [i * delta, ...).
+    map<int, vector<int>> buckets;
+    vector<int> frontier;
+    int current_bucket = 0;
+    bool finished = false;
+    /*
+      A thread that throws an exception drops out of the barrier, so that
+      the other threads can finish the round, and sets failed to stop the
+      search. run_in_parallel then rethrows the exception. The barrier
+      completion must not throw, so it stores its exception instead.
+    */
+    atomic<bool> failed(false);
+    exception_ptr completion_exception;
+    auto prepare_next_round = [&]() noexcept {
+        if (failed) {
+            finished = true;
+            return;
+        }
+        try {
+            for (vector<int> &outbox : outboxes) {
+                for (int state_index : outbox) {
+                    buckets[distances[state_index] / delta].push_back(
+                        state_index);
+                }
+                outbox.clear();
+            }
+            if (buckets.empty()) {
+                finished = true;
+                return;
+            }
+            auto it = buckets.begin();
+            current_bucket = it->first;
+            frontier = move(it->second);
+            buckets.erase(it);
+            // A state can have been reached several times.
+            utils::sort_unique(frontier);
+            next_index = 0;
+        } catch (...) {
+            completion_exception = current_exception();
+            finished = true;
+        }
+    };
+    prepare_next_round();
+
+    auto regress_frontier = [&](
+        vector<int> &predecessors, vector<int> &applicable_operator_ids) {
+        int frontier_size = frontier.size();
+        int start;
+        while ((start = next_index.fetch_add(chunk_size)) < frontier_size) {
+            int end = min(start + chunk_size, frontier_size);
+            for (int i = start; i < end; ++i) {
+                int state_index = frontier[i];
+                int distance = atomic_ref<int>(distances[state_index])
+                                   .load(memory_order_relaxed);
+                // Skip states that have been moved to a lower bucket.
+                if (distance / delta != current_bucket)
+                    continue;
+                applicable_operator_ids.clear();
+                match_tree.get_applicable_operator_ids(
+                    state_index, applicable_operator_ids);
+                for (int op_id : applicable_operator_ids) {
+                    const AbstractOperator &op = abstract_ops[op_id];
+                    int predecessor = state_index + op.get_hash_effect();
+                    int alternative_cost = distance + op.get_cost();
+                    atomic_ref<int> predecessor_distance(
+                        distances[predecessor]);
+                    int old_distance =
+                        predecessor_distance.load(memory_order_relaxed);
+                    while (alternative_cost < old_distance &&
+                           !predecessor_distance.compare_exchange_weak(
+                               old_distance, alternative_cost,
+                               memory_order_relaxed)) {
+                    }
+                    if (alternative_cost < old_distance)
+                        predecessors.push_back(predecessor);
+                }
+            }
+        }
+    };
+
+    barrier round_end(num_threads, prepare_next_round);
+    utils::run_in_parallel(num_threads, [&](int thread_id) {
+        vector<int> &predecessors = outboxes[thread_id];
+        vector<int> applicable_operator_ids;
+        while (!finished) {
+            try {
+                regress_frontier(predecessors, applicable_operator_ids);
+            } catch (...) {
+                failed = true;
+                round_end.arrive_and_drop();
+                throw;
+            }
+            round_end.arrive_and_wait();
+        }
+    });
+    if (completion_exception) {
+        rethrow_exception(completion_exception);
+    }
+}
+
 void PatternDatabaseFactory::compute_plan(
     const MatchTree &match_tree,
     const shared_ptr<utils::RandomNumberGenerator> &rng,
@@ -347,9 +523,8 @@ void PatternDatabaseFactory::compute_plan(
       is biased by the number of operators leading to the same successor
       from the given state.
     */
-    State initial_state = task_proxy.get_initial_state();
-    initial_state.unpack();
-    int current_state = projection.rank(initial_state.get_unpacked_values());
+    int current_state =
+        projection.rank(flat_task.get_initial_state_values());
     if (distances[current_state] != numeric_limits<int>::max()) {
         while (!is_goal_state(current_state)) {
             int op_id = generating_op_ids[current_state];
@@ -399,16 +574,25 @@ PatternDatabaseFactory::PatternDatabaseFactory(
     const shared_ptr<utils::RandomNumberGenerator> &rng,
     bool compute_wildcard_plan)
     : task_proxy(task_proxy),
-      variables(task_proxy.get_variables()),
+      flat_task(flattened_task::g_flattened_tasks[task_proxy]),
       projection(task_proxy, pattern) {
     assert(
         operator_costs.empty() ||
-        operator_costs.size() == task_proxy.get_operators().size());
+        static_cast<int>(operator_costs.size()) ==
+            flat_task.get_num_operators());
     compute_variable_to_index(pattern);
     compute_abstract_operators(operator_costs);
     unique_ptr<MatchTree> match_tree = compute_match_tree();
     compute_abstract_goals();
-    compute_distances(*match_tree, compute_plan);
+    if (utils::g_parallel_pdb_distances &&
+        utils::g_num_preprocessing_threads > 1 &&
+        !utils::is_in_parallel_region() && !compute_plan &&
+        projection.get_num_abstract_states() >=
+            MIN_STATES_FOR_PARALLEL_DISTANCES) {
+        compute_distances_in_parallel(*match_tree);
+    } else {
+        compute_distances(*match_tree, compute_plan);
+    }
 
     if (compute_plan) {
         this->compute_plan(*match_tree, rng, compute_wildcard_plan);
@@ -419,9 +603,40 @@ shared_ptr<PatternDatabase> compute_pdb(
     const TaskProxy &task_proxy, const Pattern &pattern,
     const vector<int> &operator_costs,
     const shared_ptr<utils::RandomNumberGenerator> &rng) {
+    bool use_cache = should_cache_pdb(task_proxy, pattern);
+    PDBCacheKey cache_key{};
+    if (use_cache) {
+        cache_key = compute_pdb_cache_key(task_proxy, pattern, operator_costs);
+        shared_ptr<PatternDatabase> pdb =
+            load_pdb_from_cache(task_proxy, pattern, cache_key);
+        if (pdb) {
+            return pdb;
+        }
+    }
     PatternDatabaseFactory pdb_factory(
         task_proxy, pattern, operator_costs, false, rng);
-    return pdb_factory.extract_pdb();
+    shared_ptr<PatternDatabase> pdb = pdb_factory.extract_pdb();
+    if (use_cache) {
+        store_pdb_in_cache(*pdb, cache_key);
+    }
+    return pdb;
+}
+
+PDBCollection compute_pdbs(
+    const TaskProxy &task_proxy, const PatternCollection &patterns) {
+    PDBCollection pdbs(patterns.size());
+    prepare_concurrent_pdb_computation(task_proxy);
+    utils::parallel_for(patterns.size(), [&](int i) {
+        pdbs[i] = compute_pdb(task_proxy, patterns[i]);
+    });
+    return pdbs;
+}
+
+void prepare_concurrent_pdb_computation(const TaskProxy &task_proxy) {
+    flattened_task::g_flattened_tasks[task_proxy];
+    if (is_pdb_cache_enabled()) {
+        prepare_concurrent_pdb_cache_access(task_proxy);
+    }
 }
 
 tuple<shared_ptr<PatternDatabase>, vector<vector<OperatorID>>>
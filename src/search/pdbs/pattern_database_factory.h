@@ -28,6 +28,21 @@ extern std::shared_ptr<PatternDatabase> compute_pdb(
     const std::vector<int> &operator_costs = std::vector<int>(),
     const std::shared_ptr<utils::RandomNumberGenerator> &rng = nullptr);
 
+/*
+  Compute the PDBs for all given patterns like compute_pdb() does. The PDBs
+  are computed concurrently if several preprocessing threads are available
+  (see utils::g_num_preprocessing_threads), but the result is the same.
+*/
+extern PDBCollection compute_pdbs(
+    const TaskProxy &task_proxy, const PatternCollection &patterns);
+
+/*
+  Code that calls compute_pdb() concurrently must first call this function
+  on a single thread. It creates the data that all PDB computations for the
+  task share.
+*/
+extern void prepare_concurrent_pdb_computation(const TaskProxy &task_proxy);
+
 /*
   In addition to computing a PDB for the given task and pattern like
   compute_pdb() above, also compute an abstract plan along.
@@ -0,0 +1,190 @@
+#include "pdb_cache.h"
+
+#include "pattern_database.h"
+
+#include "../per_task_information.h"
+#include "../task_utils/flattened_task.h"
+#include "../utils/disk_cache.h"
+#include "../utils/hash.h"
+
+#include <cassert>
+#include <iomanip>
+#include <sstream>
+
+using namespace std;
+
+namespace pdbs {
+// "FDPDB" followed by the version of the file format.
+static const uint64_t CACHE_FILE_MAGIC = 0x4644504442000002ULL;
+/*
+  The header consists of the magic number, the three parts of the
+  PDBCacheKey, the size of the pattern, log_cell_bits and the number of
+  words of the distance table.
+*/
+static const int HEADER_SIZE = 7;
+/*
+  Smaller PDBs take at most a few milliseconds to compute, which is not
+  much more than looking up, writing and renaming their files. Pattern
+  generators compute many such PDBs that are never used again.
+*/
+static const int MIN_STATES_FOR_CACHING = 100000;
+
+bool is_pdb_cache_enabled() {
+    return !utils::g_cache_directory.empty();
+}
+
+static string get_cache_file_path(uint64_t key) {
+    ostringstream path;
+    path << utils::g_cache_directory << "/" << hex << setw(16)
+         << setfill('0') << key << ".pdb";
+    return path.str();
+}
+
+bool should_cache_pdb(const TaskProxy &task_proxy, const Pattern &pattern) {
+    if (!is_pdb_cache_enabled()) {
+        return false;
+    }
+    const vector<int> &domain_sizes =
+        flattened_task::g_flattened_tasks[task_proxy].get_domain_sizes();
+    int64_t num_states = 1;
+    for (int var : pattern) {
+        num_states *= domain_sizes[var];
+        if (num_states >= MIN_STATES_FOR_CACHING) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static uint64_t compute_costs_fingerprint(const vector<int> &operator_costs) {
+    utils::HashState hash_state;
+    utils::feed(hash_state, operator_costs);
+    return hash_state.get_hash64();
+}
+
+/*
+  Fingerprints of the variables, operators and goals of a task, and of its
+  operator costs.
+*/
+struct TaskFingerprint {
+    uint64_t structure;
+    uint64_t costs;
+
+    explicit TaskFingerprint(const TaskProxy &task_proxy);
+};
+
+TaskFingerprint::TaskFingerprint(const TaskProxy &task_proxy) {
+    const flattened_task::FlattenedTask &flat_task =
+        flattened_task::g_flattened_tasks[task_proxy];
+    utils::HashState hash_state;
+    utils::feed(hash_state, flat_task.get_domain_sizes());
+    int num_operators = flat_task.get_num_operators();
+    utils::feed(hash_state, num_operators);
+    vector<int> operator_costs;
+    operator_costs.reserve(num_operators);
+    for (int op_id = 0; op_id < num_operators; ++op_id) {
+        span<const FactPair> preconditions =
+            flat_task.get_preconditions(op_id);
+        utils::feed(hash_state, static_cast<int>(preconditions.size()));
+        for (const FactPair &fact : preconditions) {
+            utils::feed(hash_state, fact);
+        }
+        span<const FactPair> effects = flat_task.get_effects(op_id);
+        utils::feed(hash_state, static_cast<int>(effects.size()));
+        for (const FactPair &fact : effects) {
+            utils::feed(hash_state, fact);
+        }
+        operator_costs.push_back(flat_task.get_cost(op_id));
+    }
+    utils::feed(hash_state, flat_task.get_goals());
+    structure = hash_state.get_hash64();
+    costs = compute_costs_fingerprint(operator_costs);
+}
+
+static PerTaskInformation<TaskFingerprint> task_fingerprints;
+
+void prepare_concurrent_pdb_cache_access(const TaskProxy &task_proxy) {
+    task_fingerprints[task_proxy];
+}
+
+PDBCacheKey compute_pdb_cache_key(
+    const TaskProxy &task_proxy, const Pattern &pattern,
+    const vector<int> &operator_costs) {
+    const TaskFingerprint &task_fingerprint = task_fingerprints[task_proxy];
+    PDBCacheKey key;
+    key.task_fingerprint = task_fingerprint.structure;
+    key.costs_fingerprint = operator_costs.empty()
+                                ? task_fingerprint.costs
+                                : compute_costs_fingerprint(operator_costs);
+    utils::HashState hash_state;
+    utils::feed(hash_state, CACHE_FILE_MAGIC);
+    utils::feed(hash_state, key.task_fingerprint);
+    utils::feed(hash_state, key.costs_fingerprint);
+    utils::feed(hash_state, pattern);
+    key.hash = hash_state.get_hash64();
+    return key;
+}
+
+shared_ptr<PatternDatabase> load_pdb_from_cache(
+    const TaskProxy &task_proxy, const Pattern &pattern,
+    const PDBCacheKey &key) {
+    shared_ptr<const utils::MappedFile> file =
+        utils::MappedFile::open(get_cache_file_path(key.hash));
+    if (!file) {
+        return nullptr;
+    }
+    const uint64_t *words = file->get_words();
+    size_t num_words = file->get_num_words();
+    size_t pattern_size = pattern.size();
+    if (num_words < HEADER_SIZE + pattern_size ||
+        words[0] != CACHE_FILE_MAGIC || words[1] != key.task_fingerprint ||
+        words[2] != key.costs_fingerprint || words[3] != key.hash ||
+        words[4] != pattern_size) {
+        return nullptr;
+    }
+    for (size_t i = 0; i < pattern_size; ++i) {
+        if (words[HEADER_SIZE + i] != static_cast<uint64_t>(pattern[i])) {
+            return nullptr;
+        }
+    }
+    int log_cell_bits = words[5];
+    uint64_t num_cell_words = words[6];
+    if (log_cell_bits < 2 || log_cell_bits > 5 ||
+        num_words != HEADER_SIZE + pattern_size + num_cell_words) {
+        return nullptr;
+    }
+    Projection projection(task_proxy, pattern);
+    shared_ptr<PatternDatabase> pdb = make_shared<PatternDatabase>(
+        move(projection), log_cell_bits,
+        words + HEADER_SIZE + pattern_size, file);
+    if (pdb->get_cells().size() != num_cell_words) {
+        return nullptr;
+    }
+    return pdb;
+}
+
+void store_pdb_in_cache(const PatternDatabase &pdb, const PDBCacheKey &key) {
+    if (pdb.has_folded_variables()) {
+        return;
+    }
+    const Pattern &pattern = pdb.get_pattern();
+    span<const uint64_t> cells = pdb.get_cells();
+    size_t num_words = HEADER_SIZE + pattern.size() + cells.size();
+    if (!utils::fits_into_cache(num_words * sizeof(uint64_t))) {
+        return;
+    }
+    vector<uint64_t> words;
+    words.reserve(num_words);
+    words.push_back(CACHE_FILE_MAGIC);
+    words.push_back(key.task_fingerprint);
+    words.push_back(key.costs_fingerprint);
+    words.push_back(key.hash);
+    words.push_back(pattern.size());
+    words.push_back(pdb.get_log_cell_bits());
+    words.push_back(cells.size());
+    assert(words.size() == HEADER_SIZE);
+    words.insert(words.end(), pattern.begin(), pattern.end());
+    words.insert(words.end(), cells.begin(), cells.end());
+    utils::write_file_atomically(get_cache_file_path(key.hash), words);
+}
+}
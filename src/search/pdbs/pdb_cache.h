@@ -0,0 +1,79 @@
+#ifndef PDBS_PDB_CACHE_H
+#define PDBS_PDB_CACHE_H
+
+#include "types.h"
+
+#include "../task_proxy.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace pdbs {
+/*
+  Persistent cache for PDBs in utils::g_cache_directory, so that runs on
+  the same task (or on tasks with the same variables, operators and goals)
+  do not recompute their PDBs.
+
+  Each PDB is stored in its own file, named after a 64-bit hash of the
+  task, the operator costs and the pattern. The file consists of 64-bit
+  words: a header, the pattern and the packed distance table (see
+  PatternDatabase). The header contains the separate fingerprints of the
+  task and of the operator costs, which are compared together with the
+  pattern when the file is loaded. A file is therefore only used for the
+  wrong PDB if both fingerprints collide. PDBs are loaded by mapping the
+  file into memory, so planner processes that use the same PDB share its
+  pages. Files are written under a temporary name and renamed afterwards,
+  so concurrent processes never read incomplete files. The cache is
+  limited by utils::g_cache_size_limit; see the usage of the planner for
+  how to clean it.
+*/
+extern bool is_pdb_cache_enabled();
+
+/*
+  Return true if the cache is enabled and the PDB for the pattern is large
+  enough to be cached. Smaller PDBs are computed faster than their files
+  are opened and written, so they are never cached.
+*/
+extern bool should_cache_pdb(
+    const TaskProxy &task_proxy, const Pattern &pattern);
+
+/*
+  Compute the fingerprint of the task used by compute_pdb_cache_key, so
+  that cache keys can afterwards be computed concurrently for the task.
+*/
+extern void prepare_concurrent_pdb_cache_access(const TaskProxy &task_proxy);
+
+struct PDBCacheKey {
+    // Fingerprint of the variables, operators and goals of the task.
+    uint64_t task_fingerprint;
+    uint64_t costs_fingerprint;
+    // Hash of both fingerprints and the pattern, used as the file name.
+    uint64_t hash;
+};
+
+/*
+  Compute the key of the PDB for the given task, pattern and operator
+  costs. As for compute_pdb(), empty operator_costs stand for the costs of
+  the task. The fingerprints that only depend on the task are computed
+  once per task.
+*/
+extern PDBCacheKey compute_pdb_cache_key(
+    const TaskProxy &task_proxy, const Pattern &pattern,
+    const std::vector<int> &operator_costs);
+
+// Return nullptr if the cache has no valid file for the key.
+extern std::shared_ptr<PatternDatabase> load_pdb_from_cache(
+    const TaskProxy &task_proxy, const Pattern &pattern,
+    const PDBCacheKey &key);
+
+/*
+  Write the PDB to the cache unless it has folded variables or the cache
+  is full. Failing to write the file is not an error: the PDB is then
+  simply not cached.
+*/
+extern void store_pdb_in_cache(
+    const PatternDatabase &pdb, const PDBCacheKey &key);
+}
+
+#endif
@@ -1,8 +1,10 @@
 #include "pdb_heuristic.h"
 
 #include "pattern_database.h"
+#include "utils.h"
 
 #include "../plugins/plugin.h"
+#include "../utils/logging.h"
 #include "../utils/markup.h"
 
 #include <limits>
@@ -13,21 +15,28 @@ using namespace std;
 namespace pdbs {
 static shared_ptr<PatternDatabase> get_pdb_from_generator(
     const shared_ptr<AbstractTask> &task,
-    const shared_ptr<PatternGenerator> &pattern_generator) {
+    const shared_ptr<PatternGenerator> &pattern_generator,
+    int max_table_size, utils::LogProxy &log) {
     PatternInformation pattern_info = pattern_generator->generate(task);
-    return pattern_info.get_pdb();
+    return PatternDatabase::compress(
+        pattern_info.get_pdb(), max_table_size, log);
 }
 
 PDBHeuristic::PDBHeuristic(
     const shared_ptr<AbstractTask> &task,
-    const shared_ptr<PatternGenerator> &pattern, bool cache_estimates,
-    const string &description, utils::Verbosity verbosity)
+    const shared_ptr<PatternGenerator> &pattern, int max_table_size,
+    bool cache_estimates, const string &description,
+    utils::Verbosity verbosity)
     : Heuristic(task, cache_estimates, description, verbosity),
-      pdb(get_pdb_from_generator(task, pattern)) {
+      pdb(get_pdb_from_generator(task, pattern, max_table_size, log)) {
+    if (log.is_at_least_normal()) {
+        log << "PDB memory: " << pdb->get_memory_usage() << " bytes" << endl;
+    }
 }
 
 int PDBHeuristic::compute_heuristic(const State &ancestor_state) {
     State state = convert_ancestor_state(ancestor_state);
+    state.unpack();
     int h = pdb->get_value(state.get_unpacked_values());
     if (h == numeric_limits<int>::max())
         return DEAD_END;
@@ -64,6 +73,7 @@ public:
 
         add_option<shared_ptr<TaskIndependentPatternGenerator>>(
             "pattern", "pattern generation method", "greedy()");
+        add_max_table_size_option_to_feature(*this);
         add_heuristic_options_to_feature(*this, "pdb");
 
         document_language_support("action costs", "supported");
@@ -71,7 +81,8 @@ public:
         document_language_support("axioms", "not supported");
 
         document_property("admissible", "yes");
-        document_property("consistent", "yes");
+        document_property(
+            "consistent", "yes if no variable is folded (see max_table_size)");
         document_property("safe", "yes");
         document_property("preferred operators", "no");
     }
@@ -81,6 +92,7 @@ public:
         return components::make_auto_task_independent_component<
             PDBHeuristic, Evaluator>(
             opts.get<shared_ptr<TaskIndependentPatternGenerator>>("pattern"),
+            opts.get<int>("max_table_size"),
             get_heuristic_arguments_from_options(opts));
     }
 };
@@ -23,12 +23,14 @@ public:
        operator_costs: Can specify individual operator costs for each
        operator. This is useful for action cost partitioning. If left
        empty, default operator costs are used.
+       max_table_size: If the PDB has more abstract states, it is reduced
+       with min-compression (see PatternDatabase::compress).
     */
     PDBHeuristic(
         const std::shared_ptr<AbstractTask> &task,
         const std::shared_ptr<PatternGenerator> &pattern_generator,
-        bool cache_estimates, const std::string &description,
-        utils::Verbosity verbosity);
+        int max_table_size, bool cache_estimates,
+        const std::string &description, utils::Verbosity verbosity);
 };
 }
 
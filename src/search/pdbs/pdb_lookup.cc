@@ -0,0 +1,166 @@
+#include "pdb_lookup.h"
+
+#include "pattern_database.h"
+
+#include <algorithm>
+#include <cassert>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#define PDB_LOOKUP_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+namespace pdbs {
+static const int LANES = SparseIntMatrix::LANES;
+
+static void multiply_scalar(
+    const int *x, const int *columns, const int *weights,
+    const int *block_offsets, int num_blocks, int *y) {
+    for (int block = 0; block < num_blocks; ++block) {
+        int *block_y = y + block * LANES;
+        fill(block_y, block_y + LANES, 0);
+        for (int k = block_offsets[block]; k < block_offsets[block + 1]; ++k) {
+            const int *term_columns = columns + k * LANES;
+            const int *term_weights = weights + k * LANES;
+            for (int j = 0; j < LANES; ++j) {
+                block_y[j] += term_weights[j] * x[term_columns[j]];
+            }
+        }
+    }
+}
+
+#ifdef PDB_LOOKUP_X86_KERNELS
+__attribute__((target("avx2"))) static void multiply_avx2(
+    const int *x, const int *columns, const int *weights,
+    const int *block_offsets, int num_blocks, int *y) {
+    static_assert(LANES == 8, "AVX2 kernel assumes 8 lanes");
+    for (int block = 0; block < num_blocks; ++block) {
+        __m256i acc = _mm256_setzero_si256();
+        for (int k = block_offsets[block]; k < block_offsets[block + 1]; ++k) {
+            __m256i term_columns = _mm256_loadu_si256(
+                reinterpret_cast<const __m256i *>(columns + k * LANES));
+            __m256i term_weights = _mm256_loadu_si256(
+                reinterpret_cast<const __m256i *>(weights + k * LANES));
+            __m256i values = _mm256_i32gather_epi32(x, term_columns, 4);
+            acc = _mm256_add_epi32(
+                acc, _mm256_mullo_epi32(values, term_weights));
+        }
+        _mm256_storeu_si256(
+            reinterpret_cast<__m256i *>(y + block * LANES), acc);
+    }
+}
+#endif
+
+static SparseIntMatrix::Kernel select_kernel() {
+#ifdef PDB_LOOKUP_X86_KERNELS
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        return multiply_avx2;
+#endif
+    return multiply_scalar;
+}
+
+SparseIntMatrix::SparseIntMatrix(const vector<vector<pair<int, int>>> &rows)
+    : num_rows(rows.size()),
+      num_blocks((num_rows + LANES - 1) / LANES),
+      kernel(select_kernel()) {
+    block_offsets.reserve(num_blocks + 1);
+    block_offsets.push_back(0);
+    for (int block = 0; block < num_blocks; ++block) {
+        int begin = block * LANES;
+        int end = min(begin + LANES, num_rows);
+        size_t num_terms = 0;
+        for (int row = begin; row < end; ++row) {
+            num_terms = max(num_terms, rows[row].size());
+        }
+        // Padding terms have column 0 and weight 0.
+        size_t first_entry = columns.size();
+        columns.resize(first_entry + num_terms * LANES, 0);
+        weights.resize(first_entry + num_terms * LANES, 0);
+        for (int row = begin; row < end; ++row) {
+            for (size_t k = 0; k < rows[row].size(); ++k) {
+                size_t entry = first_entry + k * LANES + (row - begin);
+                columns[entry] = rows[row][k].first;
+                weights[entry] = rows[row][k].second;
+            }
+        }
+        block_offsets.push_back(block_offsets.back() + num_terms);
+    }
+}
+
+static vector<vector<pair<int, int>>> get_rank_matrix_rows(
+    const PDBCollection &pdbs) {
+    vector<vector<pair<int, int>>> rows;
+    rows.reserve(pdbs.size());
+    for (const shared_ptr<PatternDatabase> &pdb : pdbs) {
+        const Pattern &pattern = pdb->get_pattern();
+        const vector<int> &multipliers = pdb->get_table_multipliers();
+        vector<pair<int, int>> row;
+        for (size_t i = 0; i < pattern.size(); ++i) {
+            if (multipliers[i] != 0) {
+                row.emplace_back(pattern[i], multipliers[i]);
+            }
+        }
+        rows.push_back(move(row));
+    }
+    return rows;
+}
+
+PDBLookup::PDBLookup(const PDBCollection &pdbs)
+    : pdbs(pdbs), rank_matrix(get_rank_matrix_rows(pdbs)) {
+    cells.reserve(pdbs.size());
+    log_cell_bits.reserve(pdbs.size());
+    for (const shared_ptr<PatternDatabase> &pdb : pdbs) {
+        cells.push_back(pdb->get_cells().data());
+        log_cell_bits.push_back(pdb->get_log_cell_bits());
+    }
+}
+
+void PDBLookup::compute_ranks(const vector<int> &state, int *ranks) const {
+    rank_matrix.multiply(state.data(), ranks);
+#ifdef __GNUC__
+    int num_pdbs = get_num_pdbs();
+    for (int i = 0; i < num_pdbs; ++i) {
+        __builtin_prefetch(cells[i] + (ranks[i] >> (6 - log_cell_bits[i])));
+    }
+#endif
+}
+
+int PDBLookup::get_value(int pdb_index, int rank) const {
+    assert(cells[pdb_index] == pdbs[pdb_index]->get_cells().data());
+    return get_packed_distance(
+        cells[pdb_index], log_cell_bits[pdb_index], rank);
+}
+
+static vector<vector<pair<int, int>>> get_clique_matrix_rows(
+    const vector<PatternClique> &pattern_cliques) {
+    vector<vector<pair<int, int>>> rows;
+    rows.reserve(pattern_cliques.size());
+    for (const PatternClique &clique : pattern_cliques) {
+        vector<pair<int, int>> row;
+        row.reserve(clique.size());
+        for (PatternID pdb_index : clique) {
+            row.emplace_back(pdb_index, 1);
+        }
+        rows.push_back(move(row));
+    }
+    return rows;
+}
+
+MaxCliqueSum::MaxCliqueSum(const vector<PatternClique> &pattern_cliques)
+    : clique_matrix(get_clique_matrix_rows(pattern_cliques)) {
+}
+
+int MaxCliqueSum::compute(const int *h_values, int *clique_sums) const {
+    clique_matrix.multiply(h_values, clique_sums);
+    // Padding rows have sum 0, which does not affect the maximum.
+    int num_sums = get_padded_num_cliques();
+    int max_h = 0;
+    for (int i = 0; i < num_sums; ++i) {
+        max_h = max(max_h, clique_sums[i]);
+    }
+    return max_h;
+}
+}
@@ -0,0 +1,106 @@
+#ifndef PDBS_PDB_LOOKUP_H
+#define PDBS_PDB_LOOKUP_H
+
+#include "types.h"
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace pdbs {
+/*
+  Sparse integer matrix M for computing y = Mx. The rows are grouped into
+  blocks of LANES rows. Each row of a block stores as many terms as the
+  longest row of the block (padded with weight 0), and the k-th terms of
+  all rows of a block are stored next to each other. This way, all rows of
+  a block are computed together with vector instructions (AVX2 gathers)
+  where they are available.
+*/
+class SparseIntMatrix {
+public:
+    static constexpr int LANES = 8;
+    using Kernel = void (*)(
+        const int *x, const int *columns, const int *weights,
+        const int *block_offsets, int num_blocks, int *y);
+private:
+    int num_rows;
+    int num_blocks;
+    // Terms of block b are block_offsets[b], ..., block_offsets[b + 1] - 1.
+    std::vector<int> block_offsets;
+    // Entry k * LANES + j belongs to term k and row j of its block.
+    std::vector<int> columns;
+    std::vector<int> weights;
+    Kernel kernel;
+public:
+    // rows[i] contains the (column, weight) pairs of row i.
+    explicit SparseIntMatrix(
+        const std::vector<std::vector<std::pair<int, int>>> &rows);
+
+    // Number of entries of y: the number of rows rounded up to LANES.
+    int get_padded_num_rows() const {
+        return num_blocks * LANES;
+    }
+
+    void multiply(const int *x, int *y) const {
+        kernel(
+            x, columns.data(), weights.data(), block_offsets.data(),
+            num_blocks, y);
+    }
+};
+
+/*
+  Looks up the h-values of a state in all PDBs of a collection. The ranks
+  of the state in all PDBs are one product of a sparse matrix (the
+  multipliers) with the state. Afterwards, we prefetch the cells of all
+  PDBs before reading any of them, so that the cache misses of the
+  lookups overlap. Callers evaluating several states can compute the
+  ranks of all states first to overlap the misses for all of them.
+
+  The lookup stores pointers to the distance tables. This is safe because
+  PDBs are not modified after construction (compressing a PDB creates a
+  new one, see PatternDatabase::compress); get_value asserts this.
+*/
+class PDBLookup {
+    // Keeps the distance tables alive.
+    PDBCollection pdbs;
+    SparseIntMatrix rank_matrix;
+    std::vector<const uint64_t *> cells;
+    std::vector<int> log_cell_bits;
+public:
+    explicit PDBLookup(const PDBCollection &pdbs);
+
+    int get_num_pdbs() const {
+        return pdbs.size();
+    }
+
+    // Number of entries of the ranks passed to compute_ranks.
+    int get_padded_num_pdbs() const {
+        return rank_matrix.get_padded_num_rows();
+    }
+
+    // Compute the ranks of the state and prefetch the cells for them.
+    void compute_ranks(const std::vector<int> &state, int *ranks) const;
+
+    int get_value(int pdb_index, int rank) const;
+};
+
+/*
+  Computes the maximum over all pattern cliques of the sum of the h-values
+  of their PDBs.
+*/
+class MaxCliqueSum {
+    SparseIntMatrix clique_matrix;
+public:
+    explicit MaxCliqueSum(const std::vector<PatternClique> &pattern_cliques);
+
+    // Number of entries of the clique sums passed to compute.
+    int get_padded_num_cliques() const {
+        return clique_matrix.get_padded_num_rows();
+    }
+
+    // All h-values must be finite.
+    int compute(const int *h_values, int *clique_sums) const;
+};
+}
+
+#endif
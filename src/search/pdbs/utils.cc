@@ -6,6 +6,7 @@
 
 #include "../task_proxy.h"
 
+#include "../plugins/plugin.h"
 #include "../task_utils/causal_graph.h"
 #include "../task_utils/task_properties.h"
 #include "../utils/logging.h"
@@ -139,6 +140,18 @@ void dump_pattern_collection_generation_statistics(
     }
 }
 
+void add_max_table_size_option_to_feature(plugins::Feature &feature) {
+    feature.add_option<int>(
+        "max_table_size",
+        "maximum number of entries of the distance table of a PDB. Larger "
+        "PDBs are reduced with min-compression: the entries for all values "
+        "of a pattern variable are merged into their minimum, choosing "
+        "the variable that keeps the highest mean h-value, until the "
+        "table is small enough. This keeps the heuristic admissible "
+        "but not necessarily consistent.",
+        "infinity", plugins::Bounds("1", "infinity"));
+}
+
 string get_rovner_et_al_reference() {
     return utils::format_conference_reference(
         {"Alexander Rovner", "Silvan Sievers", "Malte Helmert"},
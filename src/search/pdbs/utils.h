@@ -10,6 +10,10 @@
 #include <memory>
 #include <string>
 
+namespace plugins {
+class Feature;
+}
+
 namespace utils {
 class LogProxy;
 class RandomNumberGenerator;
@@ -61,6 +65,12 @@ extern void dump_pattern_collection_generation_statistics(
     const std::string &identifier, utils::Duration runtime,
     const PatternCollectionInformation &pci, utils::LogProxy &log);
 
+/*
+  Add the option max_table_size, which limits the number of entries of the
+  distance table of each PDB (see PatternDatabase::compress).
+*/
+extern void add_max_table_size_option_to_feature(plugins::Feature &feature);
+
 extern std::string get_rovner_et_al_reference();
 }
 
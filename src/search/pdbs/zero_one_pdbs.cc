@@ -16,14 +16,19 @@
 using namespace std;
 
 namespace pdbs {
-ZeroOnePDBs::ZeroOnePDBs(
-    const TaskProxy &task_proxy, const PatternCollection &patterns) {
+// Reused between evaluations (see canonical_pdbs.cc).
+static thread_local vector<int> ranks;
+
+static PDBCollection compute_zero_one_pdbs(
+    const TaskProxy &task_proxy, const PatternCollection &patterns,
+    int max_table_size, utils::LogProxy &log) {
     vector<int> remaining_operator_costs;
     OperatorsProxy operators = task_proxy.get_operators();
     remaining_operator_costs.reserve(operators.size());
     for (OperatorProxy op : operators)
         remaining_operator_costs.push_back(op.get_cost());
 
+    PDBCollection pattern_databases;
     pattern_databases.reserve(patterns.size());
     for (const Pattern &pattern : patterns) {
         shared_ptr<PatternDatabase> pdb =
@@ -36,19 +41,29 @@ ZeroOnePDBs::ZeroOnePDBs(
                 remaining_operator_costs[op.get_id()] = 0;
         }
 
-        pattern_databases.push_back(pdb);
+        pattern_databases.push_back(
+            PatternDatabase::compress(pdb, max_table_size, log));
     }
+    return pattern_databases;
 }
 
-int ZeroOnePDBs::get_value(const State &state) const {
+ZeroOnePDBs::ZeroOnePDBs(
+    const TaskProxy &task_proxy, const PatternCollection &patterns,
+    int max_table_size, utils::LogProxy &log)
+    : pattern_databases(compute_zero_one_pdbs(
+          task_proxy, patterns, max_table_size, log)),
+      lookup(pattern_databases) {
+}
+
+int ZeroOnePDBs::compute_value(const int *state_ranks) const {
     /*
       Because we use cost partitioning, we can simply add up all
       heuristic values of all patterns in the pattern collection.
     */
-    state.unpack();
+    int num_pdbs = lookup.get_num_pdbs();
     int h_val = 0;
-    for (const shared_ptr<PatternDatabase> &pdb : pattern_databases) {
-        int pdb_value = pdb->get_value(state.get_unpacked_values());
+    for (int i = 0; i < num_pdbs; ++i) {
+        int pdb_value = lookup.get_value(i, state_ranks[i]);
         if (pdb_value == numeric_limits<int>::max())
             return numeric_limits<int>::max();
         h_val += pdb_value;
@@ -56,6 +71,30 @@ int ZeroOnePDBs::get_value(const State &state) const {
     return h_val;
 }
 
+int ZeroOnePDBs::get_value(const State &state) const {
+    state.unpack();
+    ranks.resize(lookup.get_padded_num_pdbs());
+    lookup.compute_ranks(state.get_unpacked_values(), ranks.data());
+    return compute_value(ranks.data());
+}
+
+void ZeroOnePDBs::get_values(
+    const vector<State> &states, vector<int> &values) const {
+    int num_states = states.size();
+    int stride = lookup.get_padded_num_pdbs();
+    ranks.resize(num_states * stride);
+    for (int i = 0; i < num_states; ++i) {
+        states[i].unpack();
+        lookup.compute_ranks(
+            states[i].get_unpacked_values(), ranks.data() + i * stride);
+    }
+    values.clear();
+    values.reserve(num_states);
+    for (int i = 0; i < num_states; ++i) {
+        values.push_back(compute_value(ranks.data() + i * stride));
+    }
+}
+
 double ZeroOnePDBs::compute_approx_mean_finite_h() const {
     double approx_mean_finite_h = 0;
     for (const shared_ptr<PatternDatabase> &pdb : pattern_databases) {
@@ -64,6 +103,14 @@ double ZeroOnePDBs::compute_approx_mean_finite_h() const {
     return approx_mean_finite_h;
 }
 
+int64_t ZeroOnePDBs::get_memory_usage() const {
+    int64_t memory = 0;
+    for (const shared_ptr<PatternDatabase> &pdb : pattern_databases) {
+        memory += pdb->get_memory_usage();
+    }
+    return memory;
+}
+
 void ZeroOnePDBs::dump(utils::LogProxy &log) const {
     if (log.is_at_least_debug()) {
         for (const shared_ptr<PatternDatabase> &pdb : pattern_databases) {
@@ -1,8 +1,12 @@
 #ifndef PDBS_ZERO_ONE_PDBS_H
 #define PDBS_ZERO_ONE_PDBS_H
 
+#include "pdb_lookup.h"
 #include "types.h"
 
+#include <cstdint>
+#include <vector>
+
 class State;
 class TaskProxy;
 
@@ -13,11 +17,24 @@ class LogProxy;
 namespace pdbs {
 class ZeroOnePDBs {
     PDBCollection pattern_databases;
+    PDBLookup lookup;
+
+    int compute_value(const int *state_ranks) const;
 public:
-    ZeroOnePDBs(const TaskProxy &task_proxy, const PatternCollection &patterns);
+    /*
+      PDBs with more than max_table_size abstract states are compressed
+      (see PatternDatabase::compress).
+    */
+    ZeroOnePDBs(
+        const TaskProxy &task_proxy, const PatternCollection &patterns,
+        int max_table_size, utils::LogProxy &log);
     ~ZeroOnePDBs() = default;
 
+    // Like CanonicalPDBs, these may be called concurrently.
     int get_value(const State &state) const;
+    // See CanonicalPDBs::get_values.
+    void get_values(
+        const std::vector<State> &states, std::vector<int> &values) const;
     /*
       Returns the sum of all mean finite h-values of every PDB.
       This is an approximation of the real mean finite h-value of the Heuristic,
@@ -27,6 +44,8 @@ public:
       these states.
     */
     double compute_approx_mean_finite_h() const;
+    // Return the memory of the distance tables in bytes.
+    int64_t get_memory_usage() const;
     void dump(utils::LogProxy &log) const;
 };
 }
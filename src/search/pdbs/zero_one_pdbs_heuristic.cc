@@ -1,6 +1,9 @@
 #include "zero_one_pdbs_heuristic.h"
 
+#include "utils.h"
+
 #include "../plugins/plugin.h"
+#include "../utils/logging.h"
 
 #include <limits>
 
@@ -9,21 +12,28 @@ using namespace std;
 namespace pdbs {
 static ZeroOnePDBs get_zero_one_pdbs_from_generator(
     const shared_ptr<AbstractTask> &task,
-    const shared_ptr<PatternCollectionGenerator> &pattern_generator) {
+    const shared_ptr<PatternCollectionGenerator> &pattern_generator,
+    int max_table_size, utils::LogProxy &log) {
     PatternCollectionInformation pattern_collection_info =
         pattern_generator->generate(task);
     shared_ptr<PatternCollection> patterns =
         pattern_collection_info.get_patterns();
     TaskProxy task_proxy(*task);
-    return ZeroOnePDBs(task_proxy, *patterns);
+    ZeroOnePDBs zero_one_pdbs(task_proxy, *patterns, max_table_size, log);
+    if (log.is_at_least_normal()) {
+        log << "Memory of the PDBs: " << zero_one_pdbs.get_memory_usage()
+            << " bytes" << endl;
+    }
+    return zero_one_pdbs;
 }
 
 ZeroOnePDBsHeuristic::ZeroOnePDBsHeuristic(
     const shared_ptr<AbstractTask> &task,
-    const shared_ptr<PatternCollectionGenerator> &patterns,
+    const shared_ptr<PatternCollectionGenerator> &patterns, int max_table_size,
     bool cache_estimates, const string &description, utils::Verbosity verbosity)
     : Heuristic(task, cache_estimates, description, verbosity),
-      zero_one_pdbs(get_zero_one_pdbs_from_generator(task, patterns)) {
+      zero_one_pdbs(get_zero_one_pdbs_from_generator(
+          task, patterns, max_table_size, log)) {
 }
 
 int ZeroOnePDBsHeuristic::compute_heuristic(const State &ancestor_state) {
@@ -34,6 +44,21 @@ int ZeroOnePDBsHeuristic::compute_heuristic(const State &ancestor_state) {
     return h;
 }
 
+void ZeroOnePDBsHeuristic::compute_heuristics(
+    const vector<State> &ancestor_states, vector<int> &values) {
+    vector<State> states;
+    states.reserve(ancestor_states.size());
+    for (const State &ancestor_state : ancestor_states) {
+        states.push_back(convert_ancestor_state(ancestor_state));
+    }
+    zero_one_pdbs.get_values(states, values);
+    for (int &h : values) {
+        if (h == numeric_limits<int>::max()) {
+            h = DEAD_END;
+        }
+    }
+}
+
 class ZeroOnePDBsHeuristicFeature
     : public plugins::TypedFeature<TaskIndependentEvaluator> {
 public:
@@ -53,6 +78,7 @@ public:
 
         add_option<shared_ptr<TaskIndependentPatternCollectionGenerator>>(
             "patterns", "pattern generation method", "systematic(1)");
+        add_max_table_size_option_to_feature(*this);
         add_heuristic_options_to_feature(*this, "zopdbs");
 
         document_language_support("action costs", "supported");
@@ -60,7 +86,8 @@ public:
         document_language_support("axioms", "not supported");
 
         document_property("admissible", "yes");
-        document_property("consistent", "yes");
+        document_property(
+            "consistent", "yes if no variable is folded (see max_table_size)");
         document_property("safe", "yes");
         document_property("preferred operators", "no");
     }
@@ -71,6 +98,7 @@ public:
             ZeroOnePDBsHeuristic, Evaluator>(
             opts.get<shared_ptr<TaskIndependentPatternCollectionGenerator>>(
                 "patterns"),
+            opts.get<int>("max_table_size"),
             get_heuristic_arguments_from_options(opts));
     }
 };
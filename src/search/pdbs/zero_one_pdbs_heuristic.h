@@ -13,11 +13,14 @@ class ZeroOnePDBsHeuristic : public Heuristic {
     ZeroOnePDBs zero_one_pdbs;
 protected:
     virtual int compute_heuristic(const State &ancestor_state) override;
+    virtual void compute_heuristics(
+        const std::vector<State> &ancestor_states,
+        std::vector<int> &values) override;
 public:
     ZeroOnePDBsHeuristic(
         const std::shared_ptr<AbstractTask> &task,
         const std::shared_ptr<PatternCollectionGenerator> &patterns,
-        bool cache_estimates, const std::string &name,
+        int max_table_size, bool cache_estimates, const std::string &name,
         utils::Verbosity verbosity);
 };
 }
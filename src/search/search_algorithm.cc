@@ -46,7 +46,7 @@ SearchAlgorithm::SearchAlgorithm(
       log(utils::get_log_for_verbosity(verbosity)),
       state_registry(task_proxy),
       successor_generator(get_successor_generator(task_proxy, log)),
-      search_space(state_registry, log),
+      search_space(state_registry, cost_type, log),
       statistics(log),
       bound(bound),
       cost_type(cost_type),
@@ -138,6 +138,16 @@ void print_initial_evaluator_values(const EvaluationContext &eval_context) {
         });
 }
 
+void print_evaluator_statistics(const set<Evaluator *> &evals) {
+    set<Evaluator *> all_evals;
+    for (Evaluator *eval : evals) {
+        eval->get_evaluators(all_evals);
+    }
+    for (const Evaluator *eval : all_evals) {
+        eval->print_statistics();
+    }
+}
+
 /* TODO: merge this into add_options_to_feature when all search
          algorithms support pruning.
 
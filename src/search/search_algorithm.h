@@ -15,6 +15,7 @@
 #include "utils/logging.h"
 
 #include <limits>
+#include <set>
 #include <vector>
 
 namespace plugins {
@@ -111,6 +112,12 @@ using TaskIndependentSearchAlgorithm =
 extern void print_initial_evaluator_values(
     const EvaluationContext &eval_context);
 
+/*
+  Print the statistics of the given evaluators and of all evaluators they
+  depend on, once per evaluator.
+*/
+extern void print_evaluator_statistics(const std::set<Evaluator *> &evals);
+
 extern void collect_preferred_operators(
     EvaluationContext &eval_context, Evaluator *preferred_operator_evaluator,
     ordered_set::OrderedSet<OperatorID> &preferred_operators);
@@ -0,0 +1,16 @@
+#include "benchmark.h"
+
+using namespace std;
+
+namespace benchmark {
+Benchmark::Benchmark(
+    const shared_ptr<AbstractTask> &task, OperatorCost cost_type, int bound,
+    double max_time, const string &description, utils::Verbosity verbosity)
+    : SearchAlgorithm(task, cost_type, bound, max_time, description, verbosity) {
+}
+
+SearchStatus Benchmark::step() {
+    run();
+    return FAILED;
+}
+}
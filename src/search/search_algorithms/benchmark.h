@@ -0,0 +1,33 @@
+#ifndef SEARCH_ALGORITHMS_BENCHMARK_H
+#define SEARCH_ALGORITHMS_BENCHMARK_H
+
+#include "../search_algorithm.h"
+
+namespace benchmark {
+/*
+  Base class for micro-benchmarks of planner components. Benchmarks are
+  implemented as search algorithms so that they can be run on any task
+  like a normal planner configuration. The first search step runs the
+  benchmark and then fails, so benchmarks never find a plan.
+*/
+class Benchmark : public SearchAlgorithm {
+protected:
+    virtual void run() = 0;
+    virtual SearchStatus step() override final;
+
+public:
+    Benchmark(
+        const std::shared_ptr<AbstractTask> &task, OperatorCost cost_type,
+        int bound, double max_time, const std::string &description,
+        utils::Verbosity verbosity);
+
+    virtual void print_statistics() const override {
+    }
+
+    virtual bool is_complete_within_bound() const override {
+        return false;
+    }
+};
+}
+
+#endif
@@ -25,20 +25,27 @@ EagerSearch::EagerSearch(
     const shared_ptr<Evaluator> &f_eval,
     const vector<shared_ptr<Evaluator>> &preferred,
     const shared_ptr<PruningMethod> &pruning,
-    const shared_ptr<Evaluator> &lazy_evaluator, OperatorCost cost_type,
-    int bound, double max_time, const string &description,
-    utils::Verbosity verbosity)
+    const shared_ptr<Evaluator> &lazy_evaluator,
+    const shared_ptr<Evaluator> &dead_end_filter, bool batch_evaluation,
+    OperatorCost cost_type, int bound, double max_time,
+    const string &description, utils::Verbosity verbosity)
     : SearchAlgorithm(task, cost_type, bound, max_time, description, verbosity),
       reopen_closed_nodes(reopen_closed),
+      batch_evaluation(batch_evaluation),
       open_list(open->create_state_open_list()),
       f_evaluator(f_eval), // default nullptr
       preferred_operator_evaluators(preferred),
       lazy_evaluator(lazy_evaluator), // default nullptr
+      dead_end_filter(dead_end_filter), // default nullptr
       pruning_method(pruning) {
     if (lazy_evaluator && !lazy_evaluator->does_cache_estimates()) {
         cerr << "lazy_evaluator must cache its estimates" << endl;
         utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
     }
+    if (dead_end_filter && !dead_end_filter->is_safe()) {
+        cerr << "dead_end_filter must be safe" << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+    }
 }
 
 void EagerSearch::initialize() {
@@ -76,8 +83,19 @@ void EagerSearch::initialize() {
         lazy_evaluator->get_path_dependent_evaluators(evals);
     }
 
+    if (dead_end_filter) {
+        dead_end_filter->get_path_dependent_evaluators(evals);
+    }
+
     path_dependent_evaluators.assign(evals.begin(), evals.end());
 
+    if (batch_evaluation) {
+        set<Evaluator *> open_list_evals;
+        open_list->get_evaluators(open_list_evals);
+        open_list_evaluators.assign(
+            open_list_evals.begin(), open_list_evals.end());
+    }
+
     State initial_state = state_registry.get_initial_state();
     for (Evaluator *evaluator : path_dependent_evaluators) {
         evaluator->notify_initial_state(initial_state);
@@ -91,7 +109,7 @@ void EagerSearch::initialize() {
 
     statistics.inc_evaluated_states();
 
-    if (open_list->is_dead_end(eval_context)) {
+    if (is_dead_end(eval_context)) {
         log << "Initial state is a dead end." << endl;
     } else {
         if (search_progress.check_progress(eval_context))
@@ -112,6 +130,20 @@ void EagerSearch::print_statistics() const {
     statistics.print_detailed_statistics();
     search_space.print_statistics();
     pruning_method->print_statistics();
+
+    set<Evaluator *> evals;
+    open_list->get_evaluators(evals);
+    for (const shared_ptr<Evaluator> &evaluator :
+         preferred_operator_evaluators) {
+        evals.insert(evaluator.get());
+    }
+    for (const shared_ptr<Evaluator> &evaluator :
+         {f_evaluator, lazy_evaluator, dead_end_filter}) {
+        if (evaluator) {
+            evals.insert(evaluator.get());
+        }
+    }
+    print_evaluator_statistics(evals);
 }
 
 SearchStatus EagerSearch::step() {
@@ -221,6 +253,21 @@ void EagerSearch::generate_successors(const SearchNode &node) {
     ordered_set::OrderedSet<OperatorID> preferred_operators;
     collect_preferred_operators_for_node(node, preferred_operators);
 
+    /*
+      With batch evaluation, we first register all successors and open the
+      new ones provisionally (so that duplicates within the batch are not
+      considered new). Then, we evaluate all new successors with one call
+      per evaluator of the open list and finally handle the successors in
+      the same order and in the same way as without batch evaluation.
+      Path-dependent evaluators are notified of all transitions of the
+      batch before the evaluation, so their values can differ from the
+      values without batch evaluation.
+    */
+    vector<OperatorID> batch_operators;
+    vector<State> batch_states;
+    vector<int> batch_eval_context_ids;
+    vector<EvaluationContext> batch_eval_contexts;
+
     for (OperatorID op_id : applicable_operators) {
         OperatorProxy op = task_proxy.get_operators()[op_id];
         if ((node.get_real_g() + op.get_cost()) >= bound)
@@ -229,84 +276,157 @@ void EagerSearch::generate_successors(const SearchNode &node) {
         State succ_state = state_registry.get_successor_state(state, op);
         statistics.inc_generated();
 
-        SearchNode succ_node = search_space.get_node(succ_state);
-
         for (Evaluator *evaluator : path_dependent_evaluators) {
             evaluator->notify_state_transition(state, op_id, succ_state);
         }
 
-        // Previously encountered dead end. Don't re-evaluate.
-        if (succ_node.is_dead_end())
+        bool is_preferred = preferred_operators.contains(op_id);
+        if (!batch_evaluation) {
+            handle_successor(node, op, succ_state, is_preferred, nullptr);
             continue;
+        }
 
-        bool is_preferred = preferred_operators.contains(op_id);
+        SearchNode succ_node = search_space.get_node(succ_state);
         if (succ_node.is_new()) {
-            /*
-              We have not seen this state before.
-              Evaluate and create a new node.
-
-              Careful: succ_node.get_g() is not available here yet,
-              hence the stupid computation of succ_g.
-              TODO: Make this less fragile.
-            */
             int succ_g = node.get_g() + get_adjusted_cost(op);
-
-            EvaluationContext succ_eval_context(
+            succ_node.open_new_node(node, op, get_adjusted_cost(op));
+            batch_eval_context_ids.push_back(batch_eval_contexts.size());
+            batch_eval_contexts.emplace_back(
                 succ_state, succ_g, is_preferred, &statistics);
             statistics.inc_evaluated_states();
+        } else {
+            batch_eval_context_ids.push_back(-1);
+        }
+        batch_operators.push_back(op_id);
+        batch_states.push_back(move(succ_state));
+    }
 
-            if (open_list->is_dead_end(succ_eval_context)) {
-                succ_node.mark_as_dead_end();
-                statistics.inc_dead_ends();
-                continue;
-            }
-            succ_node.open_new_node(node, op, get_adjusted_cost(op));
+    if (batch_states.empty())
+        return;
+
+    vector<EvaluationContext *> eval_contexts;
+    eval_contexts.reserve(batch_eval_contexts.size());
+    for (EvaluationContext &eval_context : batch_eval_contexts)
+        eval_contexts.push_back(&eval_context);
+    if (dead_end_filter) {
+        // Only evaluate the open list evaluators on states that survive.
+        Evaluator *filter = dead_end_filter.get();
+        EvaluationContext::evaluate_batch(filter, eval_contexts);
+        erase_if(eval_contexts, [filter](EvaluationContext *eval_context) {
+            return eval_context->is_evaluator_value_infinite(filter);
+        });
+    }
+    for (Evaluator *evaluator : open_list_evaluators)
+        EvaluationContext::evaluate_batch(evaluator, eval_contexts);
+
+    for (size_t i = 0; i < batch_states.size(); ++i) {
+        OperatorID op_id = batch_operators[i];
+        int context_id = batch_eval_context_ids[i];
+        handle_successor(
+            node, task_proxy.get_operators()[op_id], batch_states[i],
+            preferred_operators.contains(op_id),
+            context_id == -1 ? nullptr : &batch_eval_contexts[context_id]);
+    }
+}
+
+void EagerSearch::insert_new_successor(
+    const SearchNode &succ_node, EvaluationContext &succ_eval_context) {
+    open_list->insert(succ_eval_context, succ_node.get_state().get_id());
+    if (search_progress.check_progress(succ_eval_context)) {
+        statistics.print_checkpoint_line(succ_node.get_g());
+        reward_progress();
+    }
+}
+
+void EagerSearch::handle_successor(
+    const SearchNode &node, const OperatorProxy &op, const State &succ_state,
+    bool is_preferred, EvaluationContext *batch_eval_context) {
+    SearchNode succ_node = search_space.get_node(succ_state);
+
+    if (batch_eval_context) {
+        // The node has been opened provisionally and evaluated in a batch.
+        assert(succ_node.is_open());
+        if (is_dead_end(*batch_eval_context)) {
+            succ_node.mark_as_dead_end();
+            statistics.inc_dead_ends();
+            return;
+        }
+        insert_new_successor(succ_node, *batch_eval_context);
+        return;
+    }
+
+    // Previously encountered dead end. Don't re-evaluate.
+    if (succ_node.is_dead_end())
+        return;
+
+    if (succ_node.is_new()) {
+        /*
+          We have not seen this state before.
+          Evaluate and create a new node.
+
+          Careful: succ_node.get_g() is not available here yet,
+          hence the stupid computation of succ_g.
+          TODO: Make this less fragile.
+        */
+        int succ_g = node.get_g() + get_adjusted_cost(op);
+
+        EvaluationContext succ_eval_context(
+            succ_state, succ_g, is_preferred, &statistics);
+        statistics.inc_evaluated_states();
+
+        if (is_dead_end(succ_eval_context)) {
+            succ_node.mark_as_dead_end();
+            statistics.inc_dead_ends();
+            return;
+        }
+        succ_node.open_new_node(node, op, get_adjusted_cost(op));
 
+        insert_new_successor(succ_node, succ_eval_context);
+    } else if (succ_node.get_g() > node.get_g() + get_adjusted_cost(op)) {
+        // We found a new cheapest path to an open or closed state.
+        if (succ_node.is_open()) {
+            succ_node.update_open_node_parent(node, op, get_adjusted_cost(op));
+            EvaluationContext succ_eval_context(
+                succ_state, succ_node.get_g(), is_preferred, &statistics);
+            open_list->insert(succ_eval_context, succ_state.get_id());
+        } else if (succ_node.is_closed() && reopen_closed_nodes) {
+            /*
+              TODO: It would be nice if we had a way to test
+              that reopening is expected behaviour, i.e., exit
+              with an error when this is something where
+              reopening should not occur (e.g. A* with a
+              consistent heuristic).
+            */
+            statistics.inc_reopened();
+            succ_node.reopen_closed_node(node, op, get_adjusted_cost(op));
+            EvaluationContext succ_eval_context(
+                succ_state, succ_node.get_g(), is_preferred, &statistics);
             open_list->insert(succ_eval_context, succ_state.get_id());
-            if (search_progress.check_progress(succ_eval_context)) {
-                statistics.print_checkpoint_line(succ_node.get_g());
-                reward_progress();
-            }
-        } else if (succ_node.get_g() > node.get_g() + get_adjusted_cost(op)) {
-            // We found a new cheapest path to an open or closed state.
-            if (succ_node.is_open()) {
-                succ_node.update_open_node_parent(
-                    node, op, get_adjusted_cost(op));
-                EvaluationContext succ_eval_context(
-                    succ_state, succ_node.get_g(), is_preferred, &statistics);
-                open_list->insert(succ_eval_context, succ_state.get_id());
-            } else if (succ_node.is_closed() && reopen_closed_nodes) {
-                /*
-                  TODO: It would be nice if we had a way to test
-                  that reopening is expected behaviour, i.e., exit
-                  with an error when this is something where
-                  reopening should not occur (e.g. A* with a
-                  consistent heuristic).
-                */
-                statistics.inc_reopened();
-                succ_node.reopen_closed_node(node, op, get_adjusted_cost(op));
-                EvaluationContext succ_eval_context(
-                    succ_state, succ_node.get_g(), is_preferred, &statistics);
-                open_list->insert(succ_eval_context, succ_state.get_id());
-            } else {
-                /*
-                  If we do not reopen closed nodes, we just update the parent
-                  pointers. Note that this could cause an incompatibility
-                  between the g-value and the actual path that is traced back.
-                */
-                assert(succ_node.is_closed() && !reopen_closed_nodes);
-                succ_node.update_closed_node_parent(
-                    node, op, get_adjusted_cost(op));
-            }
         } else {
             /*
-              We found an equally or more expensive path to an open or closed
-              state. There is nothing we need to do.
+              If we do not reopen closed nodes, we just update the parent
+              pointers. Note that this could cause an incompatibility
+              between the g-value and the actual path that is traced back.
             */
+            assert(succ_node.is_closed() && !reopen_closed_nodes);
+            succ_node.update_closed_node_parent(
+                node, op, get_adjusted_cost(op));
         }
+    } else {
+        /*
+          We found an equally or more expensive path to an open or closed
+          state. There is nothing we need to do.
+        */
     }
 }
 
+bool EagerSearch::is_dead_end(EvaluationContext &eval_context) {
+    if (dead_end_filter &&
+        eval_context.is_evaluator_value_infinite(dead_end_filter.get()))
+        return true;
+    return open_list->is_dead_end(eval_context);
+}
+
 void EagerSearch::reward_progress() {
     // Boost the "preferred operator" open lists somewhat whenever
     // one of the heuristics finds a state with a new best h value.
@@ -341,6 +461,26 @@ void EagerSearch::update_f_value_statistics(EvaluationContext &eval_context) {
 void add_eager_search_options_to_feature(
     plugins::Feature &feature, const string &description) {
     add_search_pruning_options_to_feature(feature);
+    feature.add_option<bool>(
+        "batch_evaluation",
+        "evaluate all new successors of an expanded state as one batch "
+        "instead of one at a time. This allows evaluators to share work "
+        "between the states of a batch. The search behaves the same, except "
+        "with path-dependent evaluators (e.g., lmcount): they are notified "
+        "of all transitions of the batch before any successor is evaluated, "
+        "so their values can differ. This also happens if the batch "
+        "reaches the same successor with several operators, because "
+        "the successor is only evaluated once, after all of these "
+        "transitions.",
+        "false");
+    feature.add_option<shared_ptr<TaskIndependentEvaluator>>(
+        "dead_end_filter",
+        "safe evaluator that is evaluated on new states before the "
+        "evaluators of the open list. States for which it is infinite are "
+        "pruned as dead ends without evaluating the open list. This pays "
+        "off for cheap filters such as relaxed_reachability() in front of "
+        "expensive heuristics, especially with batch_evaluation=true.",
+        plugins::ArgumentInfo::NO_DEFAULT);
     // We do not add a lazy_evaluator options here
     // because it is only used for astar but not the other plugins.
     add_search_algorithm_options_to_feature(feature, description);
@@ -348,13 +488,18 @@ void add_eager_search_options_to_feature(
 
 tuple<
     shared_ptr<TaskIndependentPruningMethod>,
-    shared_ptr<TaskIndependentEvaluator>, OperatorCost, int, double, string,
-    utils::Verbosity>
+    shared_ptr<TaskIndependentEvaluator>,
+    shared_ptr<TaskIndependentEvaluator>, bool, OperatorCost, int, double,
+    string, utils::Verbosity>
 get_eager_search_arguments_from_options(const plugins::Options &opts) {
     return tuple_cat(
         get_search_pruning_arguments_from_options(opts),
-        make_tuple(opts.get<shared_ptr<TaskIndependentEvaluator>>(
-            "lazy_evaluator", nullptr)),
+        make_tuple(
+            opts.get<shared_ptr<TaskIndependentEvaluator>>(
+                "lazy_evaluator", nullptr),
+            opts.get<shared_ptr<TaskIndependentEvaluator>>(
+                "dead_end_filter", nullptr),
+            opts.get<bool>("batch_evaluation")),
         get_search_algorithm_arguments_from_options(opts));
 }
 }
@@ -20,6 +20,7 @@ class Feature;
 namespace eager_search {
 class EagerSearch : public SearchAlgorithm {
     const bool reopen_closed_nodes;
+    const bool batch_evaluation;
 
     std::unique_ptr<StateOpenList> open_list;
     std::shared_ptr<Evaluator> f_evaluator;
@@ -27,12 +28,17 @@ class EagerSearch : public SearchAlgorithm {
     std::vector<Evaluator *> path_dependent_evaluators;
     std::vector<std::shared_ptr<Evaluator>> preferred_operator_evaluators;
     std::shared_ptr<Evaluator> lazy_evaluator;
+    // Safe evaluator that is checked before the open list evaluators.
+    std::shared_ptr<Evaluator> dead_end_filter;
+    // Evaluators used directly by the open list (only for batch evaluation).
+    std::vector<Evaluator *> open_list_evaluators;
 
     std::shared_ptr<PruningMethod> pruning_method;
 
     void start_f_value_statistics(EvaluationContext &eval_context);
     void update_f_value_statistics(EvaluationContext &eval_context);
     void reward_progress();
+    bool is_dead_end(EvaluationContext &eval_context);
 
     std::optional<SearchNode> get_next_node_to_expand();
     void collect_preferred_operators_for_node(
@@ -40,6 +46,12 @@ class EagerSearch : public SearchAlgorithm {
         ordered_set::OrderedSet<OperatorID> &preferred_operators);
     SearchStatus expand(const SearchNode &node);
     void generate_successors(const SearchNode &node);
+    void handle_successor(
+        const SearchNode &node, const OperatorProxy &op,
+        const State &succ_state, bool is_preferred,
+        EvaluationContext *batch_eval_context);
+    void insert_new_successor(
+        const SearchNode &succ_node, EvaluationContext &succ_eval_context);
 
 protected:
     virtual void initialize() override;
@@ -53,8 +65,10 @@ public:
         const std::vector<std::shared_ptr<Evaluator>> &preferred,
         const std::shared_ptr<PruningMethod> &pruning,
         const std::shared_ptr<Evaluator> &lazy_evaluator,
-        OperatorCost cost_type, int bound, double max_time,
-        const std::string &description, utils::Verbosity verbosity);
+        const std::shared_ptr<Evaluator> &dead_end_filter,
+        bool batch_evaluation, OperatorCost cost_type, int bound,
+        double max_time, const std::string &description,
+        utils::Verbosity verbosity);
 
     virtual void print_statistics() const override;
 
@@ -66,8 +80,9 @@ extern void add_eager_search_options_to_feature(
     plugins::Feature &feature, const std::string &description);
 extern std::tuple<
     std::shared_ptr<TaskIndependentPruningMethod>,
-    std::shared_ptr<TaskIndependentEvaluator>, OperatorCost, int, double,
-    std::string, utils::Verbosity>
+    std::shared_ptr<TaskIndependentEvaluator>,
+    std::shared_ptr<TaskIndependentEvaluator>, bool, OperatorCost, int,
+    double, std::string, utils::Verbosity>
 get_eager_search_arguments_from_options(const plugins::Options &opts);
 }
 
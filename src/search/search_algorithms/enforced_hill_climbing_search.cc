@@ -258,6 +258,12 @@ void EnforcedHillClimbingSearch::print_statistics() const {
             << " - Avg. Expansions: "
             << static_cast<double>(total_expansions) / phases << endl;
     }
+
+    set<Evaluator *> evals = {evaluator.get()};
+    for (const shared_ptr<Evaluator> &eval : preferred_operator_evaluators) {
+        evals.insert(eval.get());
+    }
+    print_evaluator_statistics(evals);
 }
 
 bool EnforcedHillClimbingSearch::is_complete_within_bound() const {
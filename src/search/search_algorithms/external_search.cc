@@ -0,0 +1,476 @@
+#include "external_search.h"
+
+#include "../plan_manager.h"
+
+#include "../plugins/plugin.h"
+#include "../task_utils/successor_generator.h"
+#include "../task_utils/task_properties.h"
+#include "../utils/logging.h"
+#include "../utils/system.h"
+
+#include <algorithm>
+#include <cassert>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <queue>
+#include <utility>
+
+using namespace std;
+
+namespace external_search {
+static bool is_less(const PackedStateBin *lhs, const PackedStateBin *rhs, int n) {
+    return lexicographical_compare(lhs, lhs + n, rhs, rhs + n);
+}
+
+static bool is_equal(
+    const PackedStateBin *lhs, const PackedStateBin *rhs, int n) {
+    return equal(lhs, lhs + n, rhs);
+}
+
+/*
+  Sequential writer and reader for files of fixed-size records of packed
+  state data. Records are stored in the native binary format because the
+  files never outlive the search.
+*/
+class RecordWriter {
+    string filename;
+    ofstream stream;
+    int record_size;
+    long long num_records;
+public:
+    RecordWriter(const string &filename, int bins_per_state)
+        : filename(filename),
+          stream(filename, ios::binary | ios::trunc),
+          record_size(bins_per_state * sizeof(PackedStateBin)),
+          num_records(0) {
+        if (!stream) {
+            cerr << "Could not create file " << filename << endl;
+            utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
+        }
+    }
+
+    void close() {
+        stream.close();
+        if (!stream) {
+            cerr << "Could not write file " << filename << endl;
+            utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
+        }
+    }
+
+    void write(const PackedStateBin *record) {
+        stream.write(reinterpret_cast<const char *>(record), record_size);
+        ++num_records;
+    }
+
+    long long get_num_records() const {
+        return num_records;
+    }
+};
+
+class RecordReader {
+    ifstream stream;
+    vector<PackedStateBin> record;
+    bool valid;
+public:
+    RecordReader(const string &filename, int bins_per_state)
+        : stream(filename, ios::binary), record(bins_per_state), valid(false) {
+        if (!stream) {
+            cerr << "Could not open file " << filename << endl;
+            utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
+        }
+        advance();
+    }
+
+    bool has_record() const {
+        return valid;
+    }
+
+    const PackedStateBin *get_record() const {
+        assert(valid);
+        return record.data();
+    }
+
+    void advance() {
+        valid = static_cast<bool>(stream.read(
+            reinterpret_cast<char *>(record.data()),
+            record.size() * sizeof(PackedStateBin)));
+    }
+};
+
+TemporaryFile::TemporaryFile(const string &filename) : filename(filename) {
+}
+
+TemporaryFile::~TemporaryFile() {
+    remove();
+}
+
+TemporaryFile::TemporaryFile(TemporaryFile &&other) noexcept
+    : filename(move(other.filename)) {
+    other.filename.clear();
+}
+
+TemporaryFile &TemporaryFile::operator=(TemporaryFile &&other) noexcept {
+    if (this != &other) {
+        remove();
+        filename = move(other.filename);
+        other.filename.clear();
+    }
+    return *this;
+}
+
+void TemporaryFile::remove() {
+    if (filename.empty())
+        return;
+    // Files that were never created (e.g., after an error) are ignored.
+    error_code error;
+    filesystem::remove(filename, error);
+    if (error) {
+        cerr << "Warning: could not remove file " << filename << endl;
+    }
+    filename.clear();
+}
+
+ExternalSearch::ExternalSearch(
+    const shared_ptr<AbstractTask> &task, const string &directory,
+    int max_buffered_states, OperatorCost cost_type, int bound,
+    double max_time, const string &description, utils::Verbosity verbosity)
+    : SearchAlgorithm(task, cost_type, bound, max_time, description, verbosity),
+      directory(directory),
+      max_buffered_states(max_buffered_states),
+      bins_per_state(state_registry.get_bins_per_state()),
+      file_prefix(
+          directory + "/downward-external-search-" +
+          to_string(utils::get_process_id()) + "-"),
+      num_files(0),
+      num_written_records(0),
+      num_runs(0),
+      max_layer_size(0) {
+}
+
+string ExternalSearch::get_new_filename() {
+    return file_prefix + to_string(num_files++) + ".bin";
+}
+
+State ExternalSearch::unpack_record(const PackedStateBin *record) const {
+    const int_packer::IntPacker &state_packer =
+        state_registry.get_state_packer();
+    int num_variables = task_proxy.get_variables().size();
+    vector<int> values(num_variables);
+    for (int var = 0; var < num_variables; ++var) {
+        values[var] = state_packer.get(record, var);
+    }
+    return task_proxy.create_state(move(values));
+}
+
+void ExternalSearch::pack_state(
+    const State &state, PackedStateBin *record) const {
+    const int_packer::IntPacker &state_packer =
+        state_registry.get_state_packer();
+    // Avoid garbage values in half-full bins, which would break comparisons.
+    fill_n(record, bins_per_state, 0);
+    const vector<int> &values = state.get_unpacked_values();
+    for (size_t var = 0; var < values.size(); ++var) {
+        state_packer.set(record, var, values[var]);
+    }
+}
+
+void ExternalSearch::write_run(
+    const vector<PackedStateBin> &buffer, vector<TemporaryFile> &run_files) {
+    assert(buffer.size() % bins_per_state == 0);
+    int num_records = buffer.size() / bins_per_state;
+    vector<int> order(num_records);
+    for (int i = 0; i < num_records; ++i) {
+        order[i] = i;
+    }
+    const PackedStateBin *data = buffer.data();
+    int n = bins_per_state;
+    sort(order.begin(), order.end(), [data, n](int lhs, int rhs) {
+             return is_less(data + lhs * n, data + rhs * n, n);
+         });
+
+    run_files.emplace_back(get_new_filename());
+    RecordWriter writer(run_files.back().get_filename(), bins_per_state);
+    const PackedStateBin *last_record = nullptr;
+    for (int index : order) {
+        const PackedStateBin *record = data + index * n;
+        if (!last_record || !is_equal(last_record, record, n)) {
+            writer.write(record);
+            last_record = record;
+        }
+    }
+    writer.close();
+    num_written_records += writer.get_num_records();
+    ++num_runs;
+}
+
+TemporaryFile ExternalSearch::merge_visited(const string &layer_file) {
+    // The layer contains no visited states, so we just interleave the files.
+    TemporaryFile result_file(get_new_filename());
+    {
+        RecordReader visited_reader(
+            visited_file.get_filename(), bins_per_state);
+        RecordReader layer_reader(layer_file, bins_per_state);
+        RecordWriter writer(result_file.get_filename(), bins_per_state);
+        while (visited_reader.has_record() || layer_reader.has_record()) {
+            RecordReader *next = &layer_reader;
+            if (!layer_reader.has_record() ||
+                (visited_reader.has_record() &&
+                 is_less(
+                     visited_reader.get_record(), layer_reader.get_record(),
+                     bins_per_state))) {
+                next = &visited_reader;
+            }
+            writer.write(next->get_record());
+            next->advance();
+        }
+        writer.close();
+        num_written_records += writer.get_num_records();
+    }
+    return result_file;
+}
+
+long long ExternalSearch::merge_runs(
+    const vector<TemporaryFile> &run_files, const string &result_file) {
+    vector<unique_ptr<RecordReader>> run_readers;
+    run_readers.reserve(run_files.size());
+    for (const TemporaryFile &run_file : run_files) {
+        run_readers.push_back(make_unique<RecordReader>(
+            run_file.get_filename(), bins_per_state));
+    }
+    int n = bins_per_state;
+    auto is_greater = [&run_readers, n](int lhs, int rhs) {
+            return is_less(
+                run_readers[rhs]->get_record(), run_readers[lhs]->get_record(),
+                n);
+        };
+    priority_queue<int, vector<int>, decltype(is_greater)> queue(is_greater);
+    for (size_t i = 0; i < run_readers.size(); ++i) {
+        if (run_readers[i]->has_record()) {
+            queue.push(i);
+        }
+    }
+
+    RecordReader visited_reader(visited_file.get_filename(), bins_per_state);
+    RecordWriter writer(result_file, bins_per_state);
+    vector<PackedStateBin> last_record;
+    while (!queue.empty()) {
+        int reader_id = queue.top();
+        queue.pop();
+        RecordReader &reader = *run_readers[reader_id];
+        const PackedStateBin *record = reader.get_record();
+        bool is_duplicate =
+            !last_record.empty() && is_equal(last_record.data(), record, n);
+        if (!is_duplicate) {
+            last_record.assign(record, record + n);
+            while (visited_reader.has_record() &&
+                   is_less(visited_reader.get_record(), record, n)) {
+                visited_reader.advance();
+            }
+            if (!visited_reader.has_record() ||
+                !is_equal(visited_reader.get_record(), record, n)) {
+                writer.write(record);
+            }
+        }
+        reader.advance();
+        if (reader.has_record()) {
+            queue.push(reader_id);
+        }
+    }
+    writer.close();
+    num_written_records += writer.get_num_records();
+    return writer.get_num_records();
+}
+
+Plan ExternalSearch::extract_plan(const vector<PackedStateBin> &goal_record) {
+    OperatorsProxy operators = task_proxy.get_operators();
+    Plan plan;
+    vector<PackedStateBin> target = goal_record;
+    vector<PackedStateBin> successor_record(bins_per_state);
+    vector<OperatorID> applicable_ops;
+    for (int depth = layer_files.size() - 2; depth >= 0; --depth) {
+        bool found_predecessor = false;
+        RecordReader reader(layer_files[depth].get_filename(), bins_per_state);
+        for (; reader.has_record() && !found_predecessor; reader.advance()) {
+            State state = unpack_record(reader.get_record());
+            applicable_ops.clear();
+            successor_generator.generate_applicable_ops(state, applicable_ops);
+            for (OperatorID op_id : applicable_ops) {
+                State succ_state =
+                    state.get_unregistered_successor(operators[op_id]);
+                pack_state(succ_state, successor_record.data());
+                if (successor_record == target) {
+                    plan.push_back(op_id);
+                    target.assign(
+                        reader.get_record(),
+                        reader.get_record() + bins_per_state);
+                    found_predecessor = true;
+                    break;
+                }
+            }
+        }
+        if (!found_predecessor) {
+            cerr << "Could not reconstruct plan from layer " << depth << endl;
+            utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
+        }
+    }
+    reverse(plan.begin(), plan.end());
+    return plan;
+}
+
+void ExternalSearch::initialize() {
+    log << "Conducting external breadth-first search, storing layers in "
+        << directory << endl;
+    State initial_state = task_proxy.get_initial_state();
+    vector<PackedStateBin> record(bins_per_state);
+    pack_state(initial_state, record.data());
+
+    layer_files.emplace_back(get_new_filename());
+    RecordWriter layer_writer(
+        layer_files.back().get_filename(), bins_per_state);
+    layer_writer.write(record.data());
+    layer_writer.close();
+    ++num_written_records;
+    max_layer_size = 1;
+
+    // Create an empty file for the visited states.
+    visited_file = TemporaryFile(get_new_filename());
+    RecordWriter(visited_file.get_filename(), bins_per_state).close();
+}
+
+SearchStatus ExternalSearch::step() {
+    int depth = layer_files.size() - 1;
+    /*
+      For unit-cost tasks, the cost of a plan is its length, so we do not
+      need to generate layers whose states can only be reached with cost
+      bound or more.
+    */
+    bool generate_successors = !is_unit_cost || depth + 1 < bound;
+    const string layer_file = layer_files.back().get_filename();
+    OperatorsProxy operators = task_proxy.get_operators();
+
+    // Removed when leaving this function, also if a plan is found.
+    vector<TemporaryFile> run_files;
+    vector<PackedStateBin> buffer;
+    size_t max_buffer_size =
+        static_cast<size_t>(max_buffered_states) * bins_per_state;
+    buffer.reserve(max_buffer_size);
+    vector<PackedStateBin> successor_record(bins_per_state);
+    vector<OperatorID> applicable_ops;
+    for (RecordReader reader(layer_file, bins_per_state); reader.has_record();
+         reader.advance()) {
+        State state = unpack_record(reader.get_record());
+        if (task_properties::is_goal_state(task_proxy, state)) {
+            vector<PackedStateBin> goal_record(
+                reader.get_record(), reader.get_record() + bins_per_state);
+            Plan plan = extract_plan(goal_record);
+            if (calculate_plan_cost(plan, task_proxy) < bound) {
+                log << "Solution found!" << endl;
+                set_plan(plan);
+                return SOLVED;
+            }
+            log << "Ignoring plan that exceeds the bound." << endl;
+        }
+        statistics.inc_expanded();
+        if (!generate_successors)
+            continue;
+
+        applicable_ops.clear();
+        successor_generator.generate_applicable_ops(state, applicable_ops);
+        for (OperatorID op_id : applicable_ops) {
+            State succ_state =
+                state.get_unregistered_successor(operators[op_id]);
+            statistics.inc_generated();
+            pack_state(succ_state, successor_record.data());
+            buffer.insert(
+                buffer.end(), successor_record.begin(), successor_record.end());
+            if (buffer.size() >= max_buffer_size) {
+                write_run(buffer, run_files);
+                buffer.clear();
+            }
+        }
+    }
+    if (!buffer.empty()) {
+        write_run(buffer, run_files);
+    }
+
+    visited_file = merge_visited(layer_file);
+    TemporaryFile next_layer_file(get_new_filename());
+    long long layer_size =
+        merge_runs(run_files, next_layer_file.get_filename());
+    int num_layer_runs = run_files.size();
+    run_files.clear();
+    if (layer_size == 0) {
+        return get_finished_search_status();
+    }
+    layer_files.push_back(move(next_layer_file));
+    max_layer_size = max(max_layer_size, layer_size);
+    log << "Layer " << depth + 1 << ": " << layer_size << " state(s) ["
+        << statistics.get_expanded() << " expanded, " << num_layer_runs
+        << " run(s)]" << endl;
+    return IN_PROGRESS;
+}
+
+void ExternalSearch::print_statistics() const {
+    statistics.print_detailed_statistics();
+    log << "Number of layers: " << layer_files.size() << endl;
+    log << "Maximal layer size: " << max_layer_size << " state(s)" << endl;
+    log << "Number of sorted runs: " << num_runs << endl;
+    log << "Bytes per state record: "
+        << bins_per_state * sizeof(PackedStateBin) << endl;
+    log << "Written records: " << num_written_records << " ("
+        << num_written_records * bins_per_state * sizeof(PackedStateBin)
+        << " bytes)" << endl;
+}
+
+bool ExternalSearch::is_complete_within_bound() const {
+    return is_unit_cost || is_unbounded();
+}
+
+class ExternalSearchFeature
+    : public plugins::TypedFeature<TaskIndependentSearchAlgorithm> {
+public:
+    ExternalSearchFeature() : TypedFeature("external_bfs") {
+        document_title("External-memory breadth-first search");
+        document_synopsis(
+            "Breadth-first search with delayed duplicate detection that "
+            "stores its layers on disk. Use this for tasks whose state spaces "
+            "do not fit into memory. Successors are collected in a buffer "
+            "and written to sorted files when the buffer is full. Duplicates "
+            "are removed once per layer by merging these files with the "
+            "sorted file of all visited states.");
+
+        add_option<string>(
+            "directory", "directory for the temporary files", "\".\"");
+        add_option<int>(
+            "max_buffered_states",
+            "maximal number of successor states that are kept in memory "
+            "before they are sorted and written to disk",
+            "1000000", plugins::Bounds("1", "infinity"));
+        add_search_algorithm_options_to_feature(*this, "external_bfs");
+
+        document_note(
+            "Plan quality",
+            "The search finds plans with a minimal number of operators. These "
+            "are only optimal for unit-cost tasks. For other tasks, plans "
+            "that exceed the bound are ignored, so the search is not complete "
+            "in the presence of a bound.");
+        document_note(
+            "Disk usage",
+            "All layers are kept on disk to reconstruct the plan, so the "
+            "search needs about twice as much disk space as the state space "
+            "(in the packed format of the state registry). The files are "
+            "removed at the end of the search.");
+    }
+
+    virtual shared_ptr<TaskIndependentSearchAlgorithm> create_component(
+        const plugins::Options &opts) const override {
+        return components::make_auto_task_independent_component<
+            ExternalSearch, SearchAlgorithm>(
+            opts.get<string>("directory"), opts.get<int>("max_buffered_states"),
+            get_search_algorithm_arguments_from_options(opts));
+    }
+};
+
+static plugins::FeaturePlugin<ExternalSearchFeature> _plugin;
+}
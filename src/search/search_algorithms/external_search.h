@@ -0,0 +1,103 @@
+#ifndef SEARCH_ALGORITHMS_EXTERNAL_SEARCH_H
+#define SEARCH_ALGORITHMS_EXTERNAL_SEARCH_H
+
+#include "../search_algorithm.h"
+
+#include <string>
+#include <vector>
+
+namespace plugins {
+class Feature;
+}
+
+namespace external_search {
+/*
+  Owns a temporary file and removes it when destroyed or assigned to, so
+  that the files of the search are removed on every exit path. This
+  includes errors, since utils::exit_with throws an exception. Files are
+  not removed if the planner is killed by a signal.
+*/
+class TemporaryFile {
+    std::string filename;
+
+    void remove();
+public:
+    TemporaryFile() = default;
+    explicit TemporaryFile(const std::string &filename);
+    ~TemporaryFile();
+    TemporaryFile(TemporaryFile &&other) noexcept;
+    TemporaryFile &operator=(TemporaryFile &&other) noexcept;
+    TemporaryFile(const TemporaryFile &) = delete;
+    TemporaryFile &operator=(const TemporaryFile &) = delete;
+
+    const std::string &get_filename() const {
+        return filename;
+    }
+};
+
+/*
+  Breadth-first search with delayed duplicate detection that keeps its
+  layers on disk instead of in a StateRegistry (see Korf, "Best-First Frontier
+  Search with Delayed Duplicate Detection", AAAI 2004).
+
+  States are stored as records in the packed format of the state registry.
+  Expanding a layer writes all successors to sorted runs whenever the
+  in-memory buffer is full. Afterwards, the runs are merged, and all states
+  that occur in earlier layers are removed by merging with a sorted file of
+  all previously visited states. The result is the next layer. Only the
+  buffer and one record per open file have to fit into memory.
+
+  Plans are reconstructed by scanning the layers backwards for a predecessor
+  of the current state. The search finds plans with a minimal number of
+  operators, which are only optimal for unit-cost tasks.
+*/
+class ExternalSearch : public SearchAlgorithm {
+    const std::string directory;
+    const int max_buffered_states;
+    const int bins_per_state;
+    const std::string file_prefix;
+
+    // layer_files[d] contains all states with distance d, sorted.
+    std::vector<TemporaryFile> layer_files;
+    // Sorted file containing the states of all expanded layers.
+    TemporaryFile visited_file;
+    int num_files;
+
+    // Statistics
+    long long num_written_records;
+    int num_runs;
+    long long max_layer_size;
+
+    std::string get_new_filename();
+    State unpack_record(const PackedStateBin *record) const;
+    void pack_state(const State &state, PackedStateBin *record) const;
+    void write_run(
+        const std::vector<PackedStateBin> &buffer,
+        std::vector<TemporaryFile> &run_files);
+    TemporaryFile merge_visited(const std::string &layer_file);
+    /*
+      Merge the sorted runs into result_file, dropping duplicates and all
+      states in visited_file. Return the number of written states.
+    */
+    long long merge_runs(
+        const std::vector<TemporaryFile> &run_files,
+        const std::string &result_file);
+    Plan extract_plan(const std::vector<PackedStateBin> &goal_record);
+
+protected:
+    virtual void initialize() override;
+    virtual SearchStatus step() override;
+
+public:
+    ExternalSearch(
+        const std::shared_ptr<AbstractTask> &task, const std::string &directory,
+        int max_buffered_states, OperatorCost cost_type, int bound,
+        double max_time, const std::string &description,
+        utils::Verbosity verbosity);
+
+    virtual void print_statistics() const override;
+    virtual bool is_complete_within_bound() const override;
+};
+}
+
+#endif
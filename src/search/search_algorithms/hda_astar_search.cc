@@ -0,0 +1,615 @@
+#include "hda_astar_search.h"
+
+#include "../evaluation_context.h"
+#include "../per_state_information.h"
+
+#include "../algorithms/mpsc_queue.h"
+#include "../plugins/plugin.h"
+#include "../task_utils/successor_generator.h"
+#include "../task_utils/task_properties.h"
+#include "../tasks/delegating_task.h"
+#include "../utils/countdown_timer.h"
+#include "../utils/logging.h"
+#include "../utils/markup.h"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <limits>
+#include <queue>
+#include <set>
+
+using namespace std;
+
+namespace hda_astar_search {
+static const int INF = numeric_limits<int>::max();
+
+/*
+  Number of generated states that a worker buffers for another worker before
+  it sends them. Buffers are also flushed whenever a worker runs out of work.
+*/
+static const int MAX_BATCH_SIZE = 64;
+
+/*
+  Information about a generated state that is sent to the owner of the state.
+  The packed state data is stored separately in the batch.
+*/
+struct StateMessage {
+    int g;
+    int real_g;
+    int parent_worker;
+    StateID parent_state_id;
+    OperatorID creating_operator;
+
+    StateMessage(
+        int g, int real_g, int parent_worker, StateID parent_state_id,
+        OperatorID creating_operator)
+        : g(g),
+          real_g(real_g),
+          parent_worker(parent_worker),
+          parent_state_id(parent_state_id),
+          creating_operator(creating_operator) {
+    }
+};
+
+struct MessageBatch {
+    vector<StateMessage> messages;
+    // Packed data of the i-th state starts at index i * bins_per_state.
+    vector<PackedStateBin> state_data;
+
+    bool empty() const {
+        return messages.empty();
+    }
+};
+
+/*
+  Like SearchNodeInfo, but the parent may live in the registry of another
+  worker.
+*/
+struct HDAStarNodeInfo {
+    enum NodeStatus {
+        NEW = 0,
+        OPEN = 1,
+        CLOSED = 2,
+        DEAD_END = 3
+    };
+
+    NodeStatus status;
+    int g;
+    int real_g;
+    int parent_worker;
+    StateID parent_state_id;
+    OperatorID creating_operator;
+
+    HDAStarNodeInfo()
+        : status(NEW),
+          g(-1),
+          real_g(-1),
+          parent_worker(-1),
+          parent_state_id(StateID::no_state),
+          creating_operator(-1) {
+    }
+};
+
+struct OpenListEntry {
+    int f;
+    int h;
+    int g;
+    StateID id;
+
+    OpenListEntry(int f, int h, int g, StateID id) : f(f), h(h), g(g), id(id) {
+    }
+
+    // Order by f, break ties by h, as in astar().
+    bool operator>(const OpenListEntry &other) const {
+        return make_pair(f, h) > make_pair(other.f, other.h);
+    }
+};
+
+class HDAStarWorker {
+    HDAStarSearch &search;
+    const int id;
+
+    /*
+      Each worker uses its own (trivial) task transformation. This ensures
+      that all per-task information (axiom evaluator, state packer,
+      successor generator) and the bound evaluators are private to the
+      worker and need no synchronization.
+    */
+    shared_ptr<AbstractTask> task;
+    TaskProxy task_proxy;
+    StateRegistry state_registry;
+    const successor_generator::SuccessorGenerator &successor_generator;
+    shared_ptr<Evaluator> evaluator;
+    PerStateInformation<HDAStarNodeInfo> node_infos;
+    priority_queue<
+        OpenListEntry, vector<OpenListEntry>, greater<OpenListEntry>>
+        open_list;
+    vector<OperatorID> applicable_ops;
+    vector<PackedStateBin> successor_data;
+
+    mpsc_queue::MPSCQueue<MessageBatch> inbox;
+    vector<MessageBatch> outboxes;
+    bool active;
+
+    void handle_generated_state(
+        const PackedStateBin *buffer, const StateMessage &message);
+    void process_inbox();
+    bool has_work();
+    void expand_next_node();
+    void send(int receiver, bool force);
+    void flush_outboxes();
+
+public:
+    SearchStatistics statistics;
+    int num_messages_sent;
+
+    HDAStarWorker(
+        HDAStarSearch &search, int id,
+        const shared_ptr<TaskIndependentEvaluator> &eval);
+
+    void insert_initial_state(const PackedStateBin *buffer);
+    void run();
+
+    const HDAStarNodeInfo &get_node_info(StateID state_id) const {
+        return node_infos[state_registry.lookup_state(state_id)];
+    }
+
+    const StateRegistry &get_state_registry() const {
+        return state_registry;
+    }
+};
+
+HDAStarWorker::HDAStarWorker(
+    HDAStarSearch &search, int id,
+    const shared_ptr<TaskIndependentEvaluator> &eval)
+    : search(search),
+      id(id),
+      task(make_shared<tasks::DelegatingTask>(search.task)),
+      task_proxy(*task),
+      state_registry(task_proxy),
+      successor_generator(
+          successor_generator::g_successor_generators[task_proxy]),
+      evaluator(eval->bind_task(task)),
+      successor_data(state_registry.get_bins_per_state()),
+      outboxes(search.num_threads),
+      active(true),
+      statistics(search.log),
+      num_messages_sent(0) {
+    set<Evaluator *> path_dependent_evaluators;
+    evaluator->get_path_dependent_evaluators(path_dependent_evaluators);
+    if (!path_dependent_evaluators.empty()) {
+        cerr << "hda_astar does not support path-dependent evaluators."
+             << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_UNSUPPORTED);
+    }
+}
+
+void HDAStarWorker::insert_initial_state(const PackedStateBin *buffer) {
+    State initial_state = state_registry.insert_packed_state(buffer);
+    EvaluationContext eval_context(initial_state, 0, true, &statistics);
+    statistics.inc_evaluated_states();
+    int h = eval_context.get_evaluator_value_or_infinity(evaluator.get());
+    HDAStarNodeInfo &info = node_infos[initial_state];
+    if (h == INF) {
+        search.log << "Initial state is a dead end." << endl;
+        info.status = HDAStarNodeInfo::DEAD_END;
+        statistics.inc_dead_ends();
+    } else {
+        info.status = HDAStarNodeInfo::OPEN;
+        info.g = 0;
+        info.real_g = 0;
+        open_list.emplace(h, h, 0, initial_state.get_id());
+    }
+    print_initial_evaluator_values(eval_context);
+}
+
+void HDAStarWorker::handle_generated_state(
+    const PackedStateBin *buffer, const StateMessage &message) {
+    State state = state_registry.insert_packed_state(buffer);
+    HDAStarNodeInfo &info = node_infos[state];
+    if (info.status == HDAStarNodeInfo::DEAD_END ||
+        (info.status != HDAStarNodeInfo::NEW && info.g <= message.g)) {
+        return;
+    }
+    if (info.status == HDAStarNodeInfo::CLOSED) {
+        statistics.inc_reopened();
+    }
+    bool is_new = info.status == HDAStarNodeInfo::NEW;
+
+    EvaluationContext eval_context(state, message.g, false, &statistics);
+    if (is_new) {
+        statistics.inc_evaluated_states();
+    }
+    int h = eval_context.get_evaluator_value_or_infinity(evaluator.get());
+    if (h == INF) {
+        info.status = HDAStarNodeInfo::DEAD_END;
+        statistics.inc_dead_ends();
+        return;
+    }
+    info.status = HDAStarNodeInfo::OPEN;
+    info.g = message.g;
+    info.real_g = message.real_g;
+    info.parent_worker = message.parent_worker;
+    info.parent_state_id = message.parent_state_id;
+    info.creating_operator = message.creating_operator;
+    open_list.emplace(message.g + h, h, message.g, state.get_id());
+}
+
+void HDAStarWorker::process_inbox() {
+    int bins_per_state = state_registry.get_bins_per_state();
+    MessageBatch batch;
+    while (inbox.pop(batch)) {
+        for (size_t i = 0; i < batch.messages.size(); ++i) {
+            handle_generated_state(
+                &batch.state_data[i * bins_per_state], batch.messages[i]);
+        }
+        /*
+          We only decrease the pending work after processing the batch, so
+          that the counter cannot drop to zero while we are still active.
+        */
+        search.pending_work.fetch_sub(1);
+    }
+}
+
+bool HDAStarWorker::has_work() {
+    int incumbent_cost = search.incumbent_cost.load();
+    while (!open_list.empty()) {
+        const OpenListEntry &top = open_list.top();
+        const HDAStarNodeInfo &info =
+            node_infos[state_registry.lookup_state(top.id)];
+        if (info.status != HDAStarNodeInfo::OPEN || info.g != top.g) {
+            // Outdated entry: the node was closed or reached more cheaply.
+            open_list.pop();
+            continue;
+        }
+        return top.f < incumbent_cost;
+    }
+    return false;
+}
+
+void HDAStarWorker::expand_next_node() {
+    OpenListEntry entry = open_list.top();
+    open_list.pop();
+    State state = state_registry.lookup_state(entry.id);
+    HDAStarNodeInfo &info = node_infos[state];
+    assert(info.status == HDAStarNodeInfo::OPEN && info.g == entry.g);
+    info.status = HDAStarNodeInfo::CLOSED;
+    int g = info.g;
+    int real_g = info.real_g;
+    statistics.inc_expanded();
+
+    if (task_properties::is_goal_state(task_proxy, state)) {
+        search.report_goal(id, state.get_id(), g);
+        return;
+    }
+
+    applicable_ops.clear();
+    successor_generator.generate_applicable_ops(state, applicable_ops);
+    statistics.inc_generated_ops(applicable_ops.size());
+    for (OperatorID op_id : applicable_ops) {
+        OperatorProxy op = task_proxy.get_operators()[op_id];
+        if (real_g + op.get_cost() >= search.bound)
+            continue;
+        statistics.inc_generated();
+        state_registry.compute_successor_data(state, op, successor_data.data());
+        StateMessage message(
+            g + search.get_adjusted_cost(op), real_g + op.get_cost(), id,
+            state.get_id(), op_id);
+        int owner = search.get_owner(successor_data.data());
+        if (owner == id) {
+            handle_generated_state(successor_data.data(), message);
+        } else {
+            MessageBatch &outbox = outboxes[owner];
+            outbox.messages.push_back(message);
+            outbox.state_data.insert(
+                outbox.state_data.end(), successor_data.begin(),
+                successor_data.end());
+            send(owner, false);
+        }
+    }
+}
+
+void HDAStarWorker::send(int receiver, bool force) {
+    MessageBatch &outbox = outboxes[receiver];
+    if (outbox.empty() ||
+        (!force && static_cast<int>(outbox.messages.size()) < MAX_BATCH_SIZE)) {
+        return;
+    }
+    // Count the batch as pending work *before* it becomes visible.
+    search.pending_work.fetch_add(1);
+    ++num_messages_sent;
+    search.workers[receiver]->inbox.push(move(outbox));
+    outbox = MessageBatch();
+}
+
+void HDAStarWorker::flush_outboxes() {
+    for (int receiver = 0; receiver < search.num_threads; ++receiver) {
+        send(receiver, true);
+    }
+}
+
+void HDAStarWorker::run() {
+    while (!search.terminated.load() && !search.stop_requested.load()) {
+        if (!active) {
+            if (inbox.empty()) {
+                if (search.pending_work.load() == 0) {
+                    search.notify_terminated();
+                } else {
+                    this_thread::yield();
+                }
+                continue;
+            }
+            /*
+              The unprocessed batch in our inbox keeps pending_work positive,
+              so the counter cannot transiently reach zero here.
+            */
+            search.pending_work.fetch_add(1);
+            active = true;
+        }
+        process_inbox();
+        if (has_work()) {
+            expand_next_node();
+        } else {
+            flush_outboxes();
+            if (inbox.empty()) {
+                active = false;
+                search.pending_work.fetch_sub(1);
+            }
+        }
+    }
+}
+
+HDAStarSearch::HDAStarSearch(
+    const shared_ptr<AbstractTask> &task,
+    const shared_ptr<TaskIndependentEvaluator> &eval, int threads,
+    OperatorCost cost_type, int bound, double max_time,
+    const string &description, utils::Verbosity verbosity)
+    : SearchAlgorithm(task, cost_type, bound, max_time, description, verbosity),
+      num_threads(threads),
+      incumbent_cost(INF),
+      incumbent_worker(-1),
+      incumbent_state_id(StateID::no_state),
+      pending_work(threads),
+      terminated(false),
+      stop_requested(false) {
+    /*
+      All workers are created in the main thread, so creating per-task
+      information and binding evaluators does not need to be thread-safe.
+    */
+    workers.reserve(num_threads);
+    for (int i = 0; i < num_threads; ++i) {
+        workers.push_back(make_unique<HDAStarWorker>(*this, i, eval));
+    }
+}
+
+HDAStarSearch::~HDAStarSearch() {
+    stop_workers();
+}
+
+int HDAStarSearch::get_owner(const PackedStateBin *buffer) const {
+    /*
+      We feed a constant before the state data so that the owner is
+      independent of the hash value that the worker's registry uses for the
+      same state. Otherwise, all states of a worker would end up in the same
+      residue class of its hash table.
+    */
+    utils::HashState hash_state;
+    hash_state.feed(0x9e3779b9U);
+    for (int i = 0; i < state_registry.get_bins_per_state(); ++i) {
+        hash_state.feed(buffer[i]);
+    }
+    return hash_state.get_hash32() % num_threads;
+}
+
+void HDAStarSearch::report_goal(int worker_id, StateID state_id, int g) {
+    lock_guard<mutex> lock(incumbent_mutex);
+    if (g < incumbent_cost.load()) {
+        incumbent_cost.store(g);
+        incumbent_worker = worker_id;
+        incumbent_state_id = state_id;
+    }
+}
+
+void HDAStarSearch::notify_terminated() {
+    {
+        lock_guard<mutex> lock(termination_mutex);
+        terminated.store(true);
+    }
+    termination_signal.notify_all();
+}
+
+void HDAStarSearch::stop_workers() {
+    stop_requested.store(true);
+    for (thread &worker_thread : threads) {
+        if (worker_thread.joinable()) {
+            worker_thread.join();
+        }
+    }
+    threads.clear();
+}
+
+void HDAStarSearch::initialize() {
+    log << "Conducting hash-distributed A* search with " << num_threads
+        << " threads, (real) bound = " << bound << endl;
+
+    const State &initial_state = state_registry.get_initial_state();
+    int owner = get_owner(initial_state.get_buffer());
+    workers[owner]->insert_initial_state(initial_state.get_buffer());
+
+    timer = make_unique<utils::CountdownTimer>(max_time);
+    threads.reserve(num_threads);
+    for (int i = 0; i < num_threads; ++i) {
+        threads.emplace_back(&HDAStarWorker::run, workers[i].get());
+    }
+}
+
+SearchStatus HDAStarSearch::step() {
+    {
+        unique_lock<mutex> lock(termination_mutex);
+        termination_signal.wait_for(lock, chrono::milliseconds(100), [this]() {
+            return terminated.load();
+        });
+    }
+    if (!terminated.load()) {
+        if (timer->is_expired()) {
+            /*
+              The generic time limit check in SearchAlgorithm::search() only
+              happens after this step. We stop the workers here already to
+              make sure their statistics are no longer modified.
+            */
+            log << "Time limit reached. Abort search." << endl;
+            stop_workers();
+            collect_statistics();
+            return TIMEOUT;
+        }
+        return IN_PROGRESS;
+    }
+    stop_workers();
+    collect_statistics();
+    if (incumbent_cost.load() != INF) {
+        log << "Solution found!" << endl;
+        trace_plan();
+    }
+    return get_finished_search_status();
+}
+
+void HDAStarSearch::collect_statistics() {
+    for (const unique_ptr<HDAStarWorker> &worker : workers) {
+        const SearchStatistics &worker_statistics = worker->statistics;
+        statistics.inc_expanded(worker_statistics.get_expanded());
+        statistics.inc_evaluated_states(
+            worker_statistics.get_evaluated_states());
+        statistics.inc_evaluations(worker_statistics.get_evaluations());
+        statistics.inc_generated(worker_statistics.get_generated());
+        statistics.inc_reopened(worker_statistics.get_reopened());
+        statistics.inc_dead_ends(worker_statistics.get_dead_ends());
+        statistics.inc_generated_ops(worker_statistics.get_generated_ops());
+    }
+}
+
+void HDAStarSearch::trace_plan() {
+    Plan plan;
+    int worker_id = incumbent_worker;
+    StateID state_id = incumbent_state_id;
+    while (true) {
+        const HDAStarNodeInfo &info =
+            workers[worker_id]->get_node_info(state_id);
+        if (info.creating_operator == OperatorID::no_operator) {
+            assert(info.parent_state_id == StateID::no_state);
+            break;
+        }
+        plan.push_back(info.creating_operator);
+        worker_id = info.parent_worker;
+        state_id = info.parent_state_id;
+    }
+    reverse(plan.begin(), plan.end());
+    set_plan(plan);
+}
+
+void HDAStarSearch::print_statistics() const {
+    statistics.print_detailed_statistics();
+    for (int i = 0; i < num_threads; ++i) {
+        const HDAStarWorker &worker = *workers[i];
+        log << "Worker " << i << ": "
+            << worker.statistics.get_expanded() << " expanded, "
+            << worker.get_state_registry().size() << " registered, "
+            << worker.num_messages_sent << " message batches sent" << endl;
+    }
+}
+
+bool HDAStarSearch::is_complete_within_bound() const {
+    return true;
+}
+
+class TaskIndependentHDAStarSearch
+    : public components::TaskIndependentComponent<SearchAlgorithm> {
+    shared_ptr<TaskIndependentEvaluator> eval;
+    int threads;
+    OperatorCost cost_type;
+    int bound;
+    double max_time;
+    string description;
+    utils::Verbosity verbosity;
+protected:
+    /*
+      In contrast to the automatically generated components, we do not bind
+      the evaluator to the task here. Every worker binds it to its own task
+      to get its own evaluator object.
+    */
+    virtual shared_ptr<SearchAlgorithm> create_task_specific_component(
+        const shared_ptr<AbstractTask> &task) const override {
+        return make_shared<HDAStarSearch>(
+            task, eval, threads, cost_type, bound, max_time, description,
+            verbosity);
+    }
+
+public:
+    TaskIndependentHDAStarSearch(
+        const shared_ptr<TaskIndependentEvaluator> &eval, int threads,
+        OperatorCost cost_type, int bound, double max_time,
+        const string &description, utils::Verbosity verbosity)
+        : eval(eval),
+          threads(threads),
+          cost_type(cost_type),
+          bound(bound),
+          max_time(max_time),
+          description(description),
+          verbosity(verbosity) {
+    }
+};
+
+class HDAStarSearchFeature
+    : public plugins::TypedFeature<TaskIndependentSearchAlgorithm> {
+public:
+    HDAStarSearchFeature() : TypedFeature("hda_astar") {
+        document_title("Hash-distributed A* search");
+        document_synopsis(
+            "Parallel A* search that distributes states among worker threads "
+            "based on a hash of the state. Each worker expands only the "
+            "states it owns and sends all other successors to their owners. "
+            "The search only terminates once no worker can expand a state "
+            "with an f-value below the cost of the best plan found, so with "
+            "an admissible heuristic the plan is optimal. For details, see" +
+            utils::format_conference_reference(
+                {"Akihiro Kishimoto", "Alex Fukunaga", "Adi Botea"},
+                "Scalable, Parallel Best-First Search for Optimal Sequential "
+                "Planning",
+                "https://ojs.aaai.org/index.php/ICAPS/article/view/13350",
+                "Proceedings of the Nineteenth International Conference on "
+                "Automated Planning and Scheduling (ICAPS 2009)",
+                "201-208", "AAAI Press", "2009"));
+
+        add_option<shared_ptr<TaskIndependentEvaluator>>(
+            "eval", "evaluator for h-value");
+        add_option<int>(
+            "threads", "number of worker threads", "4",
+            plugins::Bounds("1", "infinity"));
+        add_search_algorithm_options_to_feature(*this, "hda_astar");
+
+        document_note(
+            "Evaluators",
+            "Every worker thread binds its own copy of the evaluator, so the "
+            "preprocessing of the evaluator (e.g., computing pattern "
+            "databases) is performed once per thread. Path-dependent "
+            "evaluators are not supported.");
+        document_note(
+            "Tie-breaking",
+            "Each worker orders its open list by f = g + h and breaks ties "
+            "by h, like astar(). Since workers run concurrently, the order "
+            "of expansions (and hence the found plan among several optimal "
+            "ones) is not deterministic.");
+    }
+
+    virtual shared_ptr<TaskIndependentSearchAlgorithm> create_component(
+        const plugins::Options &opts) const override {
+        return components::make_shared_from_arg_tuples<
+            TaskIndependentHDAStarSearch>(
+            opts.get<shared_ptr<TaskIndependentEvaluator>>("eval"),
+            opts.get<int>("threads"),
+            get_search_algorithm_arguments_from_options(opts));
+    }
+};
+
+static plugins::FeaturePlugin<HDAStarSearchFeature> _plugin;
+}
@@ -0,0 +1,85 @@
+#ifndef SEARCH_ALGORITHMS_HDA_ASTAR_SEARCH_H
+#define SEARCH_ALGORITHMS_HDA_ASTAR_SEARCH_H
+
+#include "../evaluator.h"
+#include "../search_algorithm.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace utils {
+class CountdownTimer;
+}
+
+namespace hda_astar_search {
+class HDAStarWorker;
+
+/*
+  Hash-distributed A* (Kishimoto, Fukunaga and Botea, ICAPS 2009).
+
+  Every state is owned by exactly one worker thread, determined by a hash of
+  its packed data. Each worker has its own state registry, search node
+  information and open list and only expands states it owns. Generated
+  successors owned by other workers are sent to them in batches through
+  lock-free message queues.
+
+  A solution is only accepted once no worker has an open node with an f-value
+  below the cost of the best plan found so far and no messages are in flight.
+  Together with an admissible heuristic, this preserves optimality.
+
+  Termination is detected with a single counter of "pending work": it counts
+  active workers plus message batches that have been sent but not yet
+  processed. Workers only become active again by processing a message, and
+  they increase the counter before they decrease it for the message. Hence,
+  once the counter reaches zero, it stays there.
+*/
+class HDAStarSearch : public SearchAlgorithm {
+    friend class HDAStarWorker;
+
+    const int num_threads;
+
+    std::vector<std::unique_ptr<HDAStarWorker>> workers;
+    std::vector<std::thread> threads;
+
+    // Cost (w.r.t. adjusted costs) of the best plan found so far.
+    std::atomic<int> incumbent_cost;
+    std::mutex incumbent_mutex;
+    int incumbent_worker;
+    StateID incumbent_state_id;
+
+    std::atomic<int> pending_work;
+    std::atomic<bool> terminated;
+    std::atomic<bool> stop_requested;
+    std::mutex termination_mutex;
+    std::condition_variable termination_signal;
+    std::unique_ptr<utils::CountdownTimer> timer;
+
+    int get_owner(const PackedStateBin *buffer) const;
+    void report_goal(int worker_id, StateID state_id, int g);
+    void notify_terminated();
+    void stop_workers();
+    void collect_statistics();
+    void trace_plan();
+
+protected:
+    virtual void initialize() override;
+    virtual SearchStatus step() override;
+
+public:
+    HDAStarSearch(
+        const std::shared_ptr<AbstractTask> &task,
+        const std::shared_ptr<TaskIndependentEvaluator> &eval, int threads,
+        OperatorCost cost_type, int bound, double max_time,
+        const std::string &description, utils::Verbosity verbosity);
+    virtual ~HDAStarSearch() override;
+
+    virtual void print_statistics() const override;
+    virtual bool is_complete_within_bound() const override;
+};
+}
+
+#endif
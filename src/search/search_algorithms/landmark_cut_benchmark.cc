@@ -0,0 +1,162 @@
+#include "benchmark.h"
+
+#include "../evaluation_context.h"
+#include "../heuristics/lm_cut_heuristic.h"
+#include "../heuristics/lm_cut_landmarks.h"
+#include "../plugins/plugin.h"
+#include "../task_utils/sampling.h"
+#include "../utils/logging.h"
+#include "../utils/rng.h"
+#include "../utils/rng_options.h"
+#include "../utils/system.h"
+#include "../utils/timer.h"
+
+#include <iostream>
+#include <memory>
+#include <vector>
+
+using namespace std;
+
+namespace landmark_cut_benchmark {
+/*
+  Micro-benchmark for the LM-cut heuristic. It first samples states with
+  random walks and then measures the time for computing LM-cut on all
+  sampled states. Since the random seed determines the samples, running
+  the benchmark with the same seed on the same tasks evaluates the same
+  states, so that different implementations of LM-cut can be compared.
+  The sum of the heuristic values serves as a checksum for this. In
+  addition, the benchmark checks that the heuristic values match a
+  reference computation that uses a new landmark generator for each
+  state and aborts if they do not.
+*/
+class LandmarkCutBenchmark : public benchmark::Benchmark {
+    const int num_samples;
+    const int num_repetitions;
+    shared_ptr<utils::RandomNumberGenerator> rng;
+
+    vector<State> sample_states(Evaluator &heuristic);
+    int compute_reference_value(const State &state) const;
+
+protected:
+    virtual void run() override;
+
+public:
+    LandmarkCutBenchmark(
+        const shared_ptr<AbstractTask> &task, int num_samples,
+        int num_repetitions, int random_seed, OperatorCost cost_type,
+        int bound, double max_time, const string &description,
+        utils::Verbosity verbosity);
+};
+
+LandmarkCutBenchmark::LandmarkCutBenchmark(
+    const shared_ptr<AbstractTask> &task, int num_samples, int num_repetitions,
+    int random_seed, OperatorCost cost_type, int bound, double max_time,
+    const string &description, utils::Verbosity verbosity)
+    : Benchmark(task, cost_type, bound, max_time, description, verbosity),
+      num_samples(num_samples),
+      num_repetitions(num_repetitions),
+      rng(utils::get_rng(random_seed)) {
+}
+
+vector<State> LandmarkCutBenchmark::sample_states(Evaluator &heuristic) {
+    State initial_state = state_registry.get_initial_state();
+    EvaluationContext eval_context(initial_state);
+    int init_h = eval_context.get_evaluator_value_or_infinity(&heuristic);
+    if (init_h == EvaluationResult::INFTY) {
+        init_h = 0;
+    }
+
+    sampling::RandomWalkSampler sampler(task_proxy, *rng);
+    vector<State> samples;
+    samples.reserve(num_samples);
+    for (int i = 0; i < num_samples; ++i) {
+        State state = sampler.sample_state(init_h);
+        state.unpack();
+        samples.push_back(move(state));
+    }
+    return samples;
+}
+
+int LandmarkCutBenchmark::compute_reference_value(const State &state) const {
+    lm_cut_heuristic::LandmarkCutLandmarks landmark_generator(
+        task_proxy, true, true);
+    int total_cost = 0;
+    bool dead_end = landmark_generator.compute_landmarks(
+        state, [&total_cost](int cut_cost) { total_cost += cut_cost; },
+        nullptr);
+    return dead_end ? EvaluationResult::INFTY : total_cost;
+}
+
+void LandmarkCutBenchmark::run() {
+    lm_cut_heuristic::LandmarkCutHeuristic heuristic(
+        task, true, true, false, false, "lmcut", utils::Verbosity::SILENT);
+    vector<State> samples = sample_states(heuristic);
+    log << "Sampled " << samples.size() << " states." << endl;
+
+    vector<int> values;
+    values.reserve(samples.size());
+    utils::Timer timer;
+    for (int i = 0; i < num_repetitions; ++i) {
+        values.clear();
+        for (const State &state : samples) {
+            EvaluationContext eval_context(state);
+            values.push_back(
+                eval_context.get_evaluator_value_or_infinity(&heuristic));
+        }
+    }
+    timer.stop();
+    double num_evaluations =
+        static_cast<double>(num_repetitions) * samples.size();
+    log << "LM-cut: " << timer << " (" << timer() / num_evaluations * 1e6
+        << "us per evaluation)" << endl;
+
+    long long sum_h = 0;
+    for (size_t i = 0; i < samples.size(); ++i) {
+        if (values[i] != compute_reference_value(samples[i])) {
+            cerr << "LM-cut computed a different value than the reference "
+                 << "for sample " << i << "." << endl;
+            utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
+        }
+        if (values[i] != EvaluationResult::INFTY) {
+            sum_h += values[i];
+        }
+    }
+    log << "Sum of finite heuristic values: " << sum_h << endl;
+}
+
+class LandmarkCutBenchmarkFeature
+    : public plugins::TypedFeature<TaskIndependentSearchAlgorithm> {
+public:
+    LandmarkCutBenchmarkFeature() : TypedFeature("landmark_cut_benchmark") {
+        document_title("LM-cut benchmark");
+        document_synopsis(
+            "Measures the time per evaluation of the LM-cut heuristic on "
+            "states sampled with random walks. The samples only depend on "
+            "the task and the random seed. The values are compared to a "
+            "reference computation from scratch and the planner aborts if "
+            "they differ. This does not search for a plan.");
+
+        add_option<int>(
+            "num_samples", "number of sampled states", "1000",
+            plugins::Bounds("1", "infinity"));
+        add_option<int>(
+            "repetitions",
+            "number of times all sampled states are evaluated", "10",
+            plugins::Bounds("1", "infinity"));
+        utils::add_rng_options_to_feature(*this);
+        add_search_algorithm_options_to_feature(
+            *this, "landmark_cut_benchmark");
+    }
+
+    virtual shared_ptr<TaskIndependentSearchAlgorithm> create_component(
+        const plugins::Options &opts) const override {
+        return components::make_auto_task_independent_component<
+            LandmarkCutBenchmark, SearchAlgorithm>(
+            opts.get<int>("num_samples"), opts.get<int>("repetitions"),
+            utils::get_rng_arguments_from_options(opts),
+            get_search_algorithm_arguments_from_options(opts));
+    }
+};
+
+static plugins::FeaturePlugin<LandmarkCutBenchmarkFeature> _plugin;
+}
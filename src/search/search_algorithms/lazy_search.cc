@@ -233,6 +233,14 @@ void LazySearch::reward_progress() {
 void LazySearch::print_statistics() const {
     statistics.print_detailed_statistics();
     search_space.print_statistics();
+
+    set<Evaluator *> evals;
+    open_list->get_evaluators(evals);
+    for (const shared_ptr<Evaluator> &evaluator :
+         preferred_operator_evaluators) {
+        evals.insert(evaluator.get());
+    }
+    print_evaluator_statistics(evals);
 }
 
 bool LazySearch::is_complete_within_bound() const {
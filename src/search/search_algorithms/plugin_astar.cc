@@ -35,9 +35,12 @@ public:
             "\n```\n--search \"astar(evaluator)\"\n```\n"
             "is equivalent to\n"
             "```\n--search \"let(h, evaluator, \n"
-            "              eager(tiebreaking([sum([g(), h]), h], unsafe_pruning=false),\n"
+            "              eager(fh_buckets(sum([g(), h]), h),\n"
             "                    reopen_closed=true, f_eval=sum([g(), h])))\"\n"
-            "```\n",
+            "```\n"
+            "The open list orders its entries like "
+            "{{{tiebreaking([sum([g(), h]), h], unsafe_pruning=false)}}}, "
+            "but is faster if all operator costs are small.",
             true);
     }
 
@@ -0,0 +1,260 @@
+#include "benchmark.h"
+
+#include "../algorithms/priority_queues.h"
+#include "../plugins/plugin.h"
+#include "../utils/logging.h"
+#include "../utils/system.h"
+#include "../utils/timer.h"
+
+#include <cstdint>
+#include <functional>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <queue>
+#include <vector>
+
+using namespace std;
+using namespace priority_queues;
+
+namespace priority_queue_benchmark {
+/*
+  Applies the conversion protocol of AbstractQueue (see AdaptiveQueue) to a
+  queue of a fixed initial type, or uses the queue as is if convert is
+  false.
+*/
+class ConvertingQueue {
+    unique_ptr<AbstractQueue<int>> queue;
+    const bool convert;
+public:
+    ConvertingQueue(unique_ptr<AbstractQueue<int>> queue, bool convert)
+        : queue(move(queue)), convert(convert) {
+    }
+
+    void push(int key, int value) {
+        if (convert) {
+            AbstractQueue<int> *q = queue->convert_if_necessary(key);
+            if (q != queue.get())
+                queue.reset(q);
+        }
+        queue->push(key, value);
+    }
+
+    pair<int, int> pop() {
+        return queue->pop();
+    }
+
+    void clear() {
+        queue->clear();
+    }
+
+    void add_virtual_pushes(int num_extra_pushes) {
+        queue->add_virtual_pushes(num_extra_pushes);
+    }
+};
+
+/*
+  Replay the operations of a recorded queue trace and return a checksum of
+  the sequence of popped keys. The checksum is the same for all correct
+  priority queues, even if they break ties differently.
+*/
+template<typename Queue>
+static uint64_t replay_trace(Queue &queue, const vector<int> &operations) {
+    uint64_t checksum = 0;
+    int next_value = 0;
+    for (size_t i = 0; i < operations.size(); ++i) {
+        int operation = operations[i];
+        if (operation >= 0) {
+            queue.push(operation, next_value++);
+        } else if (operation == QueueTraceRecorder::POP) {
+            checksum = checksum * 31 + queue.pop().first;
+        } else if (operation == QueueTraceRecorder::CLEAR) {
+            queue.clear();
+        } else {
+            assert(operation == QueueTraceRecorder::ADD_VIRTUAL_PUSHES);
+            queue.add_virtual_pushes(operations[++i]);
+        }
+    }
+    return checksum;
+}
+
+/*
+  Micro-benchmark for the priority queue implementations. It replays queue
+  traces recorded with --record-queue-trace (e.g., from the Dijkstra
+  explorations of LM-cut, h^max or PDB construction) with each
+  implementation, measures the time for all traces and checks that all
+  implementations pop the same sequence of keys. The input task is not
+  used.
+*/
+class PriorityQueueBenchmark : public benchmark::Benchmark {
+    const string trace_filename;
+    const int num_repetitions;
+    // Queue IDs are mapped to the operations on the queue.
+    map<int, vector<int>> traces;
+    uint64_t expected_checksum;
+
+    void read_traces();
+    void print_trace_statistics() const;
+    template<typename CreateQueue>
+    void run_benchmark(const string &name, const CreateQueue &create_queue);
+
+protected:
+    virtual void run() override;
+
+public:
+    PriorityQueueBenchmark(
+        const shared_ptr<AbstractTask> &task, const string &trace_filename,
+        int num_repetitions, OperatorCost cost_type, int bound,
+        double max_time, const string &description,
+        utils::Verbosity verbosity);
+};
+
+PriorityQueueBenchmark::PriorityQueueBenchmark(
+    const shared_ptr<AbstractTask> &task, const string &trace_filename,
+    int num_repetitions, OperatorCost cost_type, int bound, double max_time,
+    const string &description, utils::Verbosity verbosity)
+    : Benchmark(task, cost_type, bound, max_time, description, verbosity),
+      trace_filename(trace_filename),
+      num_repetitions(num_repetitions),
+      expected_checksum(0) {
+}
+
+void PriorityQueueBenchmark::read_traces() {
+    ifstream file(trace_filename);
+    if (!file) {
+        cerr << "Could not open queue trace file " << trace_filename << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+    }
+    int queue_id;
+    size_t num_operations;
+    while (file >> queue_id >> num_operations) {
+        vector<int> &operations = traces[queue_id];
+        operations.reserve(operations.size() + num_operations);
+        for (size_t i = 0; i < num_operations; ++i) {
+            int operation;
+            if (!(file >> operation)) {
+                cerr << "Truncated queue trace file " << trace_filename
+                     << endl;
+                utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+            }
+            operations.push_back(operation);
+        }
+    }
+    if (!file.eof()) {
+        cerr << "Invalid queue trace file " << trace_filename << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+    }
+}
+
+void PriorityQueueBenchmark::print_trace_statistics() const {
+    long long num_pushes = 0;
+    long long num_pops = 0;
+    // Pushes with keys below the last popped key of a non-empty queue.
+    long long num_non_monotone_pushes = 0;
+    int max_key = 0;
+    for (const auto &[queue_id, operations] : traces) {
+        priority_queue<int, vector<int>, greater<int>> keys;
+        int last_popped_key = 0;
+        for (size_t i = 0; i < operations.size(); ++i) {
+            int operation = operations[i];
+            if (operation >= 0) {
+                ++num_pushes;
+                if (!keys.empty() && operation < last_popped_key)
+                    ++num_non_monotone_pushes;
+                keys.push(operation);
+                max_key = max(max_key, operation);
+            } else if (operation == QueueTraceRecorder::POP) {
+                ++num_pops;
+                last_popped_key = keys.top();
+                keys.pop();
+            } else if (operation == QueueTraceRecorder::CLEAR) {
+                keys = {};
+                last_popped_key = 0;
+            } else {
+                ++i;
+            }
+        }
+    }
+    log << "Queues: " << traces.size() << endl;
+    log << "Pushes: " << num_pushes << endl;
+    log << "Pops: " << num_pops << endl;
+    log << "Non-monotone pushes: " << num_non_monotone_pushes << endl;
+    log << "Maximal key: " << max_key << endl;
+}
+
+template<typename CreateQueue>
+void PriorityQueueBenchmark::run_benchmark(
+    const string &name, const CreateQueue &create_queue) {
+    uint64_t checksum = 0;
+    utils::Timer timer;
+    for (int i = 0; i < num_repetitions; ++i) {
+        checksum = 0;
+        for (const auto &[queue_id, operations] : traces) {
+            auto queue = create_queue();
+            checksum = checksum * 31 + replay_trace(*queue, operations);
+        }
+    }
+    timer.stop();
+    log << name << ": " << timer << endl;
+    if (name == "heap") {
+        expected_checksum = checksum;
+    } else if (checksum != expected_checksum) {
+        cerr << "Priority queue " << name
+             << " popped different keys than the heap." << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
+    }
+}
+
+void PriorityQueueBenchmark::run() {
+    read_traces();
+    print_trace_statistics();
+
+    run_benchmark("heap", []() {
+        return make_unique<ConvertingQueue>(
+            make_unique<HeapQueue<int>>(), false);
+    });
+    run_benchmark("radix heap", []() {
+        return make_unique<ConvertingQueue>(
+            make_unique<RadixHeapQueue<int>>(), true);
+    });
+    run_benchmark("adaptive (bucket, heap)", []() {
+        return make_unique<AdaptiveQueue<int>>(LargeKeyQueueType::HEAP);
+    });
+    run_benchmark("adaptive (bucket, radix heap)", []() {
+        return make_unique<AdaptiveQueue<int>>(LargeKeyQueueType::RADIX_HEAP);
+    });
+}
+
+class PriorityQueueBenchmarkFeature
+    : public plugins::TypedFeature<TaskIndependentSearchAlgorithm> {
+public:
+    PriorityQueueBenchmarkFeature() : TypedFeature("priority_queue_benchmark") {
+        document_title("Priority queue benchmark");
+        document_synopsis(
+            "Replays priority queue traces recorded with "
+            "--record-queue-trace (which requires a build with the CMake "
+            "option RECORD_QUEUE_TRACES) with the heap, the radix heap and the "
+            "adaptive queue converting to either of them, and compares "
+            "their running times. Pure bucket queues are not included "
+            "since their memory grows with the largest key. The input task "
+            "is ignored and no plan is searched for.");
+
+        add_option<string>("trace", "file containing the queue traces");
+        add_option<int>(
+            "repetitions", "number of times all traces are replayed", "1",
+            plugins::Bounds("1", "infinity"));
+        add_search_algorithm_options_to_feature(
+            *this, "priority_queue_benchmark");
+    }
+
+    virtual shared_ptr<TaskIndependentSearchAlgorithm> create_component(
+        const plugins::Options &opts) const override {
+        return components::make_auto_task_independent_component<
+            PriorityQueueBenchmark, SearchAlgorithm>(
+            opts.get<string>("trace"), opts.get<int>("repetitions"),
+            get_search_algorithm_arguments_from_options(opts));
+    }
+};
+
+static plugins::FeaturePlugin<PriorityQueueBenchmarkFeature> _plugin;
+}
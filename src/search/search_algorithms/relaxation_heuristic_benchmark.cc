@@ -0,0 +1,342 @@
+#include "benchmark.h"
+
+#include "../evaluation_context.h"
+#include "../heuristics/additive_heuristic.h"
+#include "../heuristics/ff_heuristic.h"
+#include "../heuristics/max_heuristic.h"
+#include "../heuristics/relaxed_reachability_heuristic.h"
+#include "../plugins/plugin.h"
+#include "../tasks/modified_operator_costs_task.h"
+#include "../task_utils/sampling.h"
+#include "../task_utils/successor_generator.h"
+#include "../utils/logging.h"
+#include "../utils/rng.h"
+#include "../utils/rng_options.h"
+#include "../utils/system.h"
+#include "../utils/timer.h"
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+using namespace std;
+
+namespace relaxation_heuristic_benchmark {
+/*
+  Micro-benchmark for the relaxation heuristics. It samples states with
+  random walks and adds the successors of each sampled state after it, so
+  that the states are evaluated in a similar order as in eager search
+  (siblings after each other). Then it measures the time per evaluation of
+  h^add, h^max and h^FF on these states, both with explorations from
+  scratch and with incremental explorations, and checks that the h^add
+  and h^max values do not depend on the exploration mode. It repeats this
+  check on random walks in a variant of the task where every other
+  operator costs 0. Finally, it measures evaluating both h^add and h^FF on
+  each state with and without sharing the exploration, and relaxed
+  reachability on single states and on batches of states, which must
+  detect the same dead ends as h^max.
+*/
+class RelaxationHeuristicBenchmark : public benchmark::Benchmark {
+    const int num_samples;
+    const int num_repetitions;
+    const tasks::AxiomHandlingType axioms;
+    shared_ptr<utils::RandomNumberGenerator> rng;
+
+    /*
+      Sample states with random walks. Each sampled state is followed by
+      its successors, or, if follow_paths is true, by the states of a
+      random walk from it.
+    */
+    vector<State> sample_states(bool follow_paths);
+    shared_ptr<AbstractTask> create_task_with_zero_cost_operators() const;
+    // Return the values of all heuristics for all states.
+    vector<int> run_benchmark(
+        const string &name, const vector<shared_ptr<Evaluator>> &heuristics,
+        const vector<State> &samples);
+    // Evaluate the heuristic on batches of batch_size consecutive states.
+    vector<int> run_batch_benchmark(
+        const string &name, Evaluator &heuristic, int batch_size,
+        const vector<State> &samples);
+    void compare_values(
+        const string &name, const vector<int> &values,
+        const vector<int> &expected_values) const;
+    /*
+      Run h^add, h^max and h^FF on the given task with and without
+      incremental explorations and return the h^max values.
+    */
+    vector<int> compare_exploration_modes(
+        const shared_ptr<AbstractTask> &heuristic_task,
+        const string &task_name, const vector<State> &samples);
+
+protected:
+    virtual void run() override;
+
+public:
+    RelaxationHeuristicBenchmark(
+        const shared_ptr<AbstractTask> &task, int num_samples,
+        int num_repetitions, tasks::AxiomHandlingType axioms, int random_seed,
+        OperatorCost cost_type, int bound, double max_time,
+        const string &description, utils::Verbosity verbosity);
+};
+
+RelaxationHeuristicBenchmark::RelaxationHeuristicBenchmark(
+    const shared_ptr<AbstractTask> &task, int num_samples, int num_repetitions,
+    tasks::AxiomHandlingType axioms, int random_seed, OperatorCost cost_type,
+    int bound, double max_time, const string &description,
+    utils::Verbosity verbosity)
+    : Benchmark(task, cost_type, bound, max_time, description, verbosity),
+      num_samples(num_samples),
+      num_repetitions(num_repetitions),
+      axioms(axioms),
+      rng(utils::get_rng(random_seed)) {
+}
+
+vector<State> RelaxationHeuristicBenchmark::sample_states(bool follow_paths) {
+    // Estimate the solution cost for the random walk lengths with h^FF.
+    ff_heuristic::FFHeuristic ff(
+        task, axioms, false, false, false, "ff", utils::Verbosity::SILENT);
+    State initial_state = state_registry.get_initial_state();
+    EvaluationContext eval_context(initial_state);
+    int init_h = eval_context.get_evaluator_value_or_infinity(&ff);
+    if (init_h == EvaluationResult::INFTY) {
+        init_h = 0;
+    }
+
+    sampling::RandomWalkSampler sampler(task_proxy, *rng);
+    vector<State> samples;
+    vector<OperatorID> applicable_ops;
+    while (static_cast<int>(samples.size()) < num_samples) {
+        State state = sampler.sample_state(init_h);
+        state.unpack();
+        samples.push_back(state);
+        applicable_ops.clear();
+        successor_generator.generate_applicable_ops(state, applicable_ops);
+        if (follow_paths) {
+            while (!applicable_ops.empty() &&
+                   static_cast<int>(samples.size()) < num_samples) {
+                OperatorID op_id = *rng->choose(applicable_ops);
+                state = state.get_unregistered_successor(
+                    task_proxy.get_operators()[op_id]);
+                samples.push_back(state);
+                applicable_ops.clear();
+                successor_generator.generate_applicable_ops(
+                    state, applicable_ops);
+            }
+            continue;
+        }
+        for (OperatorID op_id : applicable_ops) {
+            if (static_cast<int>(samples.size()) == num_samples)
+                break;
+            samples.push_back(
+                state.get_unregistered_successor(
+                    task_proxy.get_operators()[op_id]));
+        }
+    }
+    return samples;
+}
+
+shared_ptr<AbstractTask>
+RelaxationHeuristicBenchmark::create_task_with_zero_cost_operators() const {
+    vector<int> costs;
+    for (OperatorProxy op : task_proxy.get_operators()) {
+        costs.push_back(op.get_id() % 2 == 0 ? 0 : op.get_cost());
+    }
+    return make_shared<extra_tasks::ModifiedOperatorCostsTask>(
+        task, move(costs));
+}
+
+vector<int> RelaxationHeuristicBenchmark::run_benchmark(
+    const string &name, const vector<shared_ptr<Evaluator>> &heuristics,
+    const vector<State> &samples) {
+    vector<int> values;
+    values.reserve(samples.size() * heuristics.size());
+    utils::Timer timer;
+    for (int i = 0; i < num_repetitions; ++i) {
+        values.clear();
+        for (const State &state : samples) {
+            EvaluationContext eval_context(state);
+            for (const shared_ptr<Evaluator> &heuristic : heuristics) {
+                values.push_back(
+                    eval_context.get_evaluator_value_or_infinity(
+                        heuristic.get()));
+            }
+        }
+    }
+    timer.stop();
+    double num_evaluations =
+        static_cast<double>(num_repetitions) * samples.size();
+    log << name << ": " << timer << " (" << timer() / num_evaluations * 1e6
+        << "us per state)" << endl;
+    return values;
+}
+
+vector<int> RelaxationHeuristicBenchmark::run_batch_benchmark(
+    const string &name, Evaluator &heuristic, int batch_size,
+    const vector<State> &samples) {
+    vector<int> values;
+    values.reserve(samples.size());
+    vector<EvaluationContext> eval_contexts;
+    vector<EvaluationContext *> batch;
+    utils::Timer timer;
+    for (int i = 0; i < num_repetitions; ++i) {
+        values.clear();
+        eval_contexts.clear();
+        for (const State &state : samples)
+            eval_contexts.emplace_back(state);
+        for (size_t start = 0; start < samples.size(); start += batch_size) {
+            size_t end = min(start + batch_size, samples.size());
+            batch.clear();
+            for (size_t j = start; j < end; ++j)
+                batch.push_back(&eval_contexts[j]);
+            EvaluationContext::evaluate_batch(&heuristic, batch);
+            for (EvaluationContext *eval_context : batch) {
+                values.push_back(
+                    eval_context->get_evaluator_value_or_infinity(
+                        &heuristic));
+            }
+        }
+    }
+    timer.stop();
+    double num_evaluations =
+        static_cast<double>(num_repetitions) * samples.size();
+    log << name << ": " << timer << " (" << timer() / num_evaluations * 1e6
+        << "us per state)" << endl;
+    return values;
+}
+
+void RelaxationHeuristicBenchmark::compare_values(
+    const string &name, const vector<int> &values,
+    const vector<int> &expected_values) const {
+    if (values != expected_values) {
+        cerr << "Heuristic " << name
+             << " computed different values than the reference." << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
+    }
+}
+
+vector<int> RelaxationHeuristicBenchmark::compare_exploration_modes(
+    const shared_ptr<AbstractTask> &heuristic_task, const string &task_name,
+    const vector<State> &samples) {
+    utils::Verbosity silent = utils::Verbosity::SILENT;
+    vector<int> hadd_values, hmax_values;
+    for (bool incremental : {false, true}) {
+        string suffix = task_name + (incremental ? " (incremental)" : "");
+        vector<int> values = run_benchmark(
+            "hadd" + suffix,
+            {make_shared<additive_heuristic::AdditiveHeuristic>(
+                heuristic_task, axioms, incremental, false, false, "hadd",
+                silent)},
+            samples);
+        if (incremental)
+            compare_values("hadd" + task_name, values, hadd_values);
+        else
+            hadd_values = move(values);
+
+        values = run_benchmark(
+            "hmax" + suffix,
+            {make_shared<max_heuristic::HSPMaxHeuristic>(
+                heuristic_task, axioms, incremental, false, "hmax", silent)},
+            samples);
+        if (incremental)
+            compare_values("hmax" + task_name, values, hmax_values);
+        else
+            hmax_values = move(values);
+
+        // Relaxed plans depend on tie-breaking, so we do not compare h^FF.
+        run_benchmark(
+            "hff" + suffix,
+            {make_shared<ff_heuristic::FFHeuristic>(
+                heuristic_task, axioms, incremental, false, false, "hff",
+                silent)},
+            samples);
+    }
+    return hmax_values;
+}
+
+void RelaxationHeuristicBenchmark::run() {
+    vector<State> samples = sample_states(false);
+    log << "Sampled " << samples.size() << " states." << endl;
+
+    utils::Verbosity silent = utils::Verbosity::SILENT;
+    vector<int> hmax_values = compare_exploration_modes(task, "", samples);
+    /*
+      Propositions reached by zero-cost operators before they become true
+      are a special case for the incremental explorations. They only show
+      up on paths, not on siblings.
+    */
+    compare_exploration_modes(
+        create_task_with_zero_cost_operators(), " (zero-cost operators)",
+        sample_states(true));
+
+    vector<int> separate_values;
+    for (bool share : {false, true}) {
+        string name = share ? "hadd+hff (shared)" : "hadd+hff (separate)";
+        vector<int> values = run_benchmark(
+            name,
+            {make_shared<additive_heuristic::AdditiveHeuristic>(
+                 task, axioms, false, share, false, "hadd", silent),
+             make_shared<ff_heuristic::FFHeuristic>(
+                 task, axioms, false, share, false, "hff", silent)},
+            samples);
+        if (share)
+            compare_values("hadd+hff (shared)", values, separate_values);
+        else
+            separate_values = move(values);
+    }
+
+    vector<int> dead_end_values;
+    dead_end_values.reserve(hmax_values.size());
+    for (int h : hmax_values)
+        dead_end_values.push_back(h == EvaluationResult::INFTY ? h : 0);
+    relaxed_reachability_heuristic::RelaxedReachabilityHeuristic reachability(
+        task, axioms, false, "reachability", silent);
+    for (int batch_size : {1, 64}) {
+        string name =
+            "reachability (batch size " + to_string(batch_size) + ")";
+        vector<int> values =
+            run_batch_benchmark(name, reachability, batch_size, samples);
+        compare_values(name, values, dead_end_values);
+    }
+}
+
+class RelaxationHeuristicBenchmarkFeature
+    : public plugins::TypedFeature<TaskIndependentSearchAlgorithm> {
+public:
+    RelaxationHeuristicBenchmarkFeature()
+        : TypedFeature("relaxation_heuristic_benchmark") {
+        document_title("Relaxation heuristic benchmark");
+        document_synopsis(
+            "Measures the time per evaluation of h^add, h^max and h^FF with "
+            "and without incremental explorations and of h^add and h^FF "
+            "together with and without a shared exploration, and of relaxed "
+            "reachability on single states and batches of 64 states on states "
+            "sampled with random walks and their successors. This does not "
+            "search for a plan.");
+
+        add_option<int>(
+            "num_samples", "number of sampled states", "1000",
+            plugins::Bounds("1", "infinity"));
+        add_option<int>(
+            "repetitions",
+            "number of times all sampled states are evaluated by each "
+            "heuristic",
+            "10", plugins::Bounds("1", "infinity"));
+        tasks::add_axioms_option_to_feature(*this);
+        utils::add_rng_options_to_feature(*this);
+        add_search_algorithm_options_to_feature(
+            *this, "relaxation_heuristic_benchmark");
+    }
+
+    virtual shared_ptr<TaskIndependentSearchAlgorithm> create_component(
+        const plugins::Options &opts) const override {
+        return components::make_auto_task_independent_component<
+            RelaxationHeuristicBenchmark, SearchAlgorithm>(
+            opts.get<int>("num_samples"), opts.get<int>("repetitions"),
+            tasks::get_axioms_arguments_from_options(opts),
+            utils::get_rng_arguments_from_options(opts),
+            get_search_algorithm_arguments_from_options(opts));
+    }
+};
+
+static plugins::FeaturePlugin<RelaxationHeuristicBenchmarkFeature> _plugin;
+}
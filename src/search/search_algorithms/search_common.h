@@ -63,8 +63,10 @@ create_wastar_open_list_factory(
   Create open list factory and f_evaluator (used for displaying progress
   statistics) for A* search.
 
-  The resulting open list factory produces a tie-breaking open list
-  ordered primarily on g + h and secondarily on h.
+  The resulting open list factory produces an open list ordered primarily
+  on g + h and secondarily on h, with ties broken in FIFO order. It uses
+  buckets indexed by these values if all operator costs are small and a
+  tie-breaking open list otherwise.
 */
 extern std::pair<
     std::shared_ptr<TaskIndependentOpenListFactory>,
@@ -0,0 +1,191 @@
+#include "benchmark.h"
+
+#include "../plugins/plugin.h"
+#include "../task_utils/successor_generator.h"
+#include "../utils/logging.h"
+#include "../utils/rng.h"
+#include "../utils/rng_options.h"
+#include "../utils/system.h"
+#include "../utils/timer.h"
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+using namespace std;
+using successor_generator::SuccessorGenerator;
+using successor_generator::SuccessorGeneratorType;
+
+namespace successor_generator_benchmark {
+/*
+  Micro-benchmark for the different representations of successor
+  generators. It samples registered states with random walks from the
+  initial state and measures how long each representation takes to compute
+  the applicable operators of all sampled states. It also verifies that all
+  representations compute the same sets of operators.
+*/
+class SuccessorGeneratorBenchmark : public benchmark::Benchmark {
+    const int num_samples;
+    const int num_repetitions;
+    shared_ptr<utils::RandomNumberGenerator> rng;
+
+    vector<StateID> sample_states();
+    vector<vector<OperatorID>> compute_applicable_ops(
+        const SuccessorGenerator &generator, const vector<StateID> &samples);
+    void run_benchmark(
+        const string &name, SuccessorGeneratorType type,
+        const vector<StateID> &samples,
+        const vector<vector<OperatorID>> &expected_ops);
+
+protected:
+    virtual void run() override;
+
+public:
+    SuccessorGeneratorBenchmark(
+        const shared_ptr<AbstractTask> &task, int num_samples,
+        int num_repetitions, int random_seed, OperatorCost cost_type,
+        int bound, double max_time, const string &description,
+        utils::Verbosity verbosity);
+};
+
+SuccessorGeneratorBenchmark::SuccessorGeneratorBenchmark(
+    const shared_ptr<AbstractTask> &task, int num_samples, int num_repetitions,
+    int random_seed, OperatorCost cost_type, int bound, double max_time,
+    const string &description, utils::Verbosity verbosity)
+    : Benchmark(task, cost_type, bound, max_time, description, verbosity),
+      num_samples(num_samples),
+      num_repetitions(num_repetitions),
+      rng(utils::get_rng(random_seed)) {
+}
+
+vector<StateID> SuccessorGeneratorBenchmark::sample_states() {
+    /*
+      Random walks that restart from the initial state in states without
+      applicable operators and, with a small probability, in every step.
+    */
+    const double restart_probability = 0.01;
+    State initial_state = state_registry.get_initial_state();
+    State current_state = initial_state;
+    vector<StateID> samples;
+    samples.reserve(num_samples);
+    vector<OperatorID> applicable_ops;
+    while (static_cast<int>(samples.size()) < num_samples) {
+        samples.push_back(current_state.get_id());
+        applicable_ops.clear();
+        successor_generator.generate_applicable_ops(
+            current_state, applicable_ops);
+        if (applicable_ops.empty() || rng->random() < restart_probability) {
+            current_state = initial_state;
+        } else {
+            OperatorID op_id = *rng->choose(applicable_ops);
+            current_state = state_registry.get_successor_state(
+                current_state, task_proxy.get_operators()[op_id]);
+        }
+    }
+    return samples;
+}
+
+vector<vector<OperatorID>> SuccessorGeneratorBenchmark::compute_applicable_ops(
+    const SuccessorGenerator &generator, const vector<StateID> &samples) {
+    vector<vector<OperatorID>> result;
+    result.reserve(samples.size());
+    for (StateID id : samples) {
+        vector<OperatorID> applicable_ops;
+        generator.generate_applicable_ops(
+            state_registry.lookup_state(id), applicable_ops);
+        sort(applicable_ops.begin(), applicable_ops.end());
+        result.push_back(move(applicable_ops));
+    }
+    return result;
+}
+
+void SuccessorGeneratorBenchmark::run_benchmark(
+    const string &name, SuccessorGeneratorType type,
+    const vector<StateID> &samples,
+    const vector<vector<OperatorID>> &expected_ops) {
+    utils::Timer construction_timer;
+    SuccessorGenerator generator(task_proxy, type);
+    construction_timer.stop();
+
+    if (compute_applicable_ops(generator, samples) != expected_ops) {
+        cerr << "Successor generator " << name
+             << " computed different applicable operators." << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
+    }
+
+    vector<OperatorID> applicable_ops;
+    long long num_applicable_ops = 0;
+    utils::Timer timer;
+    for (int i = 0; i < num_repetitions; ++i) {
+        for (StateID id : samples) {
+            applicable_ops.clear();
+            /*
+              Looking up the state creates a new State object without
+              unpacked data, so all generators start from packed data.
+            */
+            generator.generate_applicable_ops(
+                state_registry.lookup_state(id), applicable_ops);
+            num_applicable_ops += applicable_ops.size();
+        }
+    }
+    timer.stop();
+
+    long long num_calls = static_cast<long long>(num_repetitions) * samples.size();
+    log << name << ": construction time " << construction_timer
+        << ", time for " << num_calls << " calls " << timer << " ("
+        << timer() / num_calls * 1e6 << "us per call, "
+        << static_cast<double>(num_applicable_ops) / num_calls
+        << " applicable operators per call)"
+        << endl;
+}
+
+void SuccessorGeneratorBenchmark::run() {
+    vector<StateID> samples = sample_states();
+    log << "Sampled " << samples.size() << " states ("
+        << state_registry.size() << " distinct)." << endl;
+
+    vector<vector<OperatorID>> expected_ops =
+        compute_applicable_ops(successor_generator, samples);
+    run_benchmark("tree", SuccessorGeneratorType::TREE, samples, expected_ops);
+    run_benchmark("flat", SuccessorGeneratorType::FLAT, samples, expected_ops);
+    run_benchmark(
+        "bitset", SuccessorGeneratorType::BITSET, samples, expected_ops);
+}
+
+class SuccessorGeneratorBenchmarkFeature
+    : public plugins::TypedFeature<TaskIndependentSearchAlgorithm> {
+public:
+    SuccessorGeneratorBenchmarkFeature()
+        : TypedFeature("successor_generator_benchmark") {
+        document_title("Successor generator benchmark");
+        document_synopsis(
+            "Compares the running times of the successor generator "
+            "representations (tree, flat, bitset) on states sampled with "
+            "random walks and checks that they compute the same applicable "
+            "operators. This does not search for a plan.");
+
+        add_option<int>(
+            "num_samples", "number of sampled states", "1000",
+            plugins::Bounds("1", "infinity"));
+        add_option<int>(
+            "repetitions",
+            "number of times the applicable operators of all sampled states "
+            "are computed for each representation",
+            "100", plugins::Bounds("1", "infinity"));
+        utils::add_rng_options_to_feature(*this);
+        add_search_algorithm_options_to_feature(
+            *this, "successor_generator_benchmark");
+    }
+
+    virtual shared_ptr<TaskIndependentSearchAlgorithm> create_component(
+        const plugins::Options &opts) const override {
+        return components::make_auto_task_independent_component<
+            SuccessorGeneratorBenchmark, SearchAlgorithm>(
+            opts.get<int>("num_samples"), opts.get<int>("repetitions"),
+            utils::get_rng_arguments_from_options(opts),
+            get_search_algorithm_arguments_from_options(opts));
+    }
+};
+
+static plugins::FeaturePlugin<SuccessorGeneratorBenchmarkFeature> _plugin;
+}
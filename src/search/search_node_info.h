@@ -15,18 +15,22 @@ struct SearchNodeInfo {
         DEAD_END = 3
     };
 
+    /*
+      We keep this struct as small as possible because there is one instance
+      per registered state. The g value with the original operator costs
+      ("real g") only differs from g if the search uses adjusted operator
+      costs. In this case, SearchSpace stores it separately.
+    */
     unsigned int status : 2;
     int g : 30;
     StateID parent_state_id;
     OperatorID creating_operator;
-    int real_g;
 
     SearchNodeInfo()
         : status(NEW),
           g(-1),
           parent_state_id(StateID::no_state),
-          creating_operator(-1),
-          real_g(-1) {
+          creating_operator(-1) {
     }
 };
 
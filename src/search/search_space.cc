@@ -10,8 +10,8 @@
 
 using namespace std;
 
-SearchNode::SearchNode(const State &state, SearchNodeInfo &info)
-    : state(state), info(info) {
+SearchNode::SearchNode(const State &state, SearchNodeInfo &info, int *real_g)
+    : state(state), info(info), real_g(real_g) {
     assert(state.get_id() != StateID::no_state);
 }
 
@@ -41,14 +41,19 @@ int SearchNode::get_g() const {
 }
 
 int SearchNode::get_real_g() const {
-    return info.real_g;
+    if (real_g) {
+        return *real_g;
+    }
+    return get_g();
 }
 
 void SearchNode::open_initial() {
     assert(info.status == SearchNodeInfo::NEW);
     info.status = SearchNodeInfo::OPEN;
     info.g = 0;
-    info.real_g = 0;
+    if (real_g) {
+        *real_g = 0;
+    }
     info.parent_state_id = StateID::no_state;
     info.creating_operator = OperatorID::no_operator;
 }
@@ -57,7 +62,11 @@ void SearchNode::update_parent(
     const SearchNode &parent_node, const OperatorProxy &parent_op,
     int adjusted_cost) {
     info.g = parent_node.info.g + adjusted_cost;
-    info.real_g = parent_node.info.real_g + parent_op.get_cost();
+    if (real_g) {
+        *real_g = parent_node.get_real_g() + parent_op.get_cost();
+    } else {
+        assert(adjusted_cost == parent_op.get_cost());
+    }
     info.parent_state_id = parent_node.get_state().get_id();
     info.creating_operator = OperatorID(parent_op.get_id());
 }
@@ -116,12 +125,18 @@ void SearchNode::dump(const TaskProxy &task_proxy, utils::LogProxy &log) const {
     }
 }
 
-SearchSpace::SearchSpace(StateRegistry &state_registry, utils::LogProxy &log)
-    : state_registry(state_registry), log(log) {
+SearchSpace::SearchSpace(
+    StateRegistry &state_registry, OperatorCost cost_type,
+    utils::LogProxy &log)
+    : store_real_g(cost_type != OperatorCost::NORMAL),
+      real_g_values(-1),
+      state_registry(state_registry),
+      log(log) {
 }
 
 SearchNode SearchSpace::get_node(const State &state) {
-    return SearchNode(state, search_node_infos[state]);
+    int *real_g = store_real_g ? &real_g_values[state] : nullptr;
+    return SearchNode(state, search_node_infos[state], real_g);
 }
 
 void SearchSpace::trace_path(
@@ -162,6 +177,19 @@ void SearchSpace::dump(const TaskProxy &task_proxy) const {
     }
 }
 
+int SearchSpace::get_node_size_in_bytes() const {
+    int num_bytes = sizeof(SearchNodeInfo);
+    if (store_real_g) {
+        num_bytes += sizeof(int);
+    }
+    return num_bytes;
+}
+
 void SearchSpace::print_statistics() const {
     state_registry.print_statistics(log);
+    int state_bytes = state_registry.get_state_size_in_bytes();
+    int node_bytes = get_node_size_in_bytes();
+    log << "Bytes per search node: " << node_bytes << endl;
+    log << "Bytes per state (packed state and search node): "
+        << state_bytes + node_bytes << endl;
 }
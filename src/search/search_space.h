@@ -18,12 +18,14 @@ class LogProxy;
 class SearchNode {
     State state;
     SearchNodeInfo &info;
+    // Only set if the real g value differs from the g value (see SearchSpace).
+    int *real_g;
 
     void update_parent(
         const SearchNode &parent_node, const OperatorProxy &parent_op,
         int adjusted_cost);
 public:
-    SearchNode(const State &state, SearchNodeInfo &info);
+    SearchNode(const State &state, SearchNodeInfo &info, int *real_g);
 
     const State &get_state() const;
 
@@ -56,17 +58,28 @@ public:
 
 class SearchSpace {
     PerStateInformation<SearchNodeInfo> search_node_infos;
+    /*
+      With adjusted operator costs, g values and real g values differ, so we
+      store the real g values separately. Otherwise, we save the memory and
+      use the g values.
+    */
+    const bool store_real_g;
+    PerStateInformation<int> real_g_values;
 
     StateRegistry &state_registry;
     utils::LogProxy &log;
 public:
-    SearchSpace(StateRegistry &state_registry, utils::LogProxy &log);
+    SearchSpace(
+        StateRegistry &state_registry, OperatorCost cost_type,
+        utils::LogProxy &log);
 
     SearchNode get_node(const State &state);
     void trace_path(
         const State &goal_state, std::vector<OperatorID> &path) const;
 
     void dump(const TaskProxy &task_proxy) const;
+    // Return the number of bytes used for the search node of each state.
+    int get_node_size_in_bytes() const;
     void print_statistics() const;
 };
 
@@ -83,6 +83,9 @@ public:
     int get_generated_ops() const {
         return generated_ops;
     }
+    int get_dead_ends() const {
+        return dead_end_states;
+    }
 
     /*
       Call the following method with the f value of every expanded
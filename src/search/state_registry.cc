@@ -6,6 +6,8 @@
 #include "task_utils/task_properties.h"
 #include "utils/logging.h"
 
+#include <algorithm>
+
 using namespace std;
 
 StateRegistry::StateRegistry(const TaskProxy &task_proxy)
@@ -66,6 +68,35 @@ const State &StateRegistry::get_initial_state() {
     return *cached_initial_state;
 }
 
+void StateRegistry::apply_effects(
+    const State &predecessor, const OperatorProxy &op,
+    PackedStateBin *buffer) const {
+    for (EffectProxy effect : op.get_effects()) {
+        if (does_fire(effect, predecessor)) {
+            FactPair effect_pair = effect.get_fact().get_pair();
+            state_packer.set(buffer, effect_pair.var, effect_pair.value);
+        }
+    }
+}
+
+vector<int> StateRegistry::compute_successor_values(
+    const State &predecessor, const OperatorProxy &op,
+    PackedStateBin *buffer) {
+    predecessor.unpack();
+    vector<int> new_values = predecessor.get_unpacked_values();
+    for (EffectProxy effect : op.get_effects()) {
+        if (does_fire(effect, predecessor)) {
+            FactPair effect_pair = effect.get_fact().get_pair();
+            new_values[effect_pair.var] = effect_pair.value;
+        }
+    }
+    axiom_evaluator.evaluate(new_values);
+    for (size_t i = 0; i < new_values.size(); ++i) {
+        state_packer.set(buffer, i, new_values[i]);
+    }
+    return new_values;
+}
+
 // TODO it would be nice to move the actual state creation (and operator
 // application)
 //      out of the StateRegistry. This could for example be done by global
@@ -84,18 +115,8 @@ State StateRegistry::get_successor_state(
     /* Experiments for issue348 showed that for tasks with axioms it's faster
        to compute successor states using unpacked data. */
     if (task_properties::has_axioms(task_proxy)) {
-        predecessor.unpack();
-        vector<int> new_values = predecessor.get_unpacked_values();
-        for (EffectProxy effect : op.get_effects()) {
-            if (does_fire(effect, predecessor)) {
-                FactPair effect_pair = effect.get_fact().get_pair();
-                new_values[effect_pair.var] = effect_pair.value;
-            }
-        }
-        axiom_evaluator.evaluate(new_values);
-        for (size_t i = 0; i < new_values.size(); ++i) {
-            state_packer.set(buffer, i, new_values[i]);
-        }
+        vector<int> new_values =
+            compute_successor_values(predecessor, op, buffer);
         /*
           NOTE: insert_id_or_pop_state possibly invalidates buffer, hence
           we use lookup_state to retrieve the state using the correct buffer.
@@ -103,12 +124,7 @@ State StateRegistry::get_successor_state(
         StateID id = insert_id_or_pop_state();
         return lookup_state(id, move(new_values));
     } else {
-        for (EffectProxy effect : op.get_effects()) {
-            if (does_fire(effect, predecessor)) {
-                FactPair effect_pair = effect.get_fact().get_pair();
-                state_packer.set(buffer, effect_pair.var, effect_pair.value);
-            }
-        }
+        apply_effects(predecessor, op, buffer);
         /*
           NOTE: insert_id_or_pop_state possibly invalidates buffer, hence
           we use lookup_state to retrieve the state using the correct buffer.
@@ -118,6 +134,26 @@ State StateRegistry::get_successor_state(
     }
 }
 
+void StateRegistry::compute_successor_data(
+    const State &predecessor, const OperatorProxy &op,
+    PackedStateBin *buffer) {
+    assert(!op.is_axiom());
+    const PackedStateBin *predecessor_buffer = predecessor.get_buffer();
+    copy(predecessor_buffer, predecessor_buffer + get_bins_per_state(), buffer);
+    // See get_successor_state.
+    if (task_properties::has_axioms(task_proxy)) {
+        compute_successor_values(predecessor, op, buffer);
+    } else {
+        apply_effects(predecessor, op, buffer);
+    }
+}
+
+State StateRegistry::insert_packed_state(const PackedStateBin *buffer) {
+    state_data_pool.push_back(buffer);
+    StateID id = insert_id_or_pop_state();
+    return lookup_state(id);
+}
+
 int StateRegistry::get_bins_per_state() const {
     return state_packer.get_num_bins();
 }
@@ -128,5 +164,8 @@ int StateRegistry::get_state_size_in_bytes() const {
 
 void StateRegistry::print_statistics(utils::LogProxy &log) const {
     log << "Number of registered states: " << size() << endl;
+    log << "Bytes per state: " << get_state_size_in_bytes() << endl;
+    log << "Number of unpacked states: " << State::get_num_unpacked_states()
+        << endl;
     registered_states.print_statistics(log);
 }
@@ -51,6 +51,9 @@
   StateRegistry
     The StateRegistry allows to create states giving them an ID. IDs from
     different state registries must not be mixed.
+    A StateRegistry and its PerStateInformation objects must only be used
+    by one thread at a time. Multi-threaded searches give each thread its
+    own registry (see hda_astar_search.h).
     The StateRegistry also stores the actual state data in a memory friendly
   way. It uses the following class:
 
@@ -170,7 +173,20 @@ class StateRegistry : public subscriber::SubscriberService<StateRegistry> {
     std::unique_ptr<State> cached_initial_state;
 
     StateID insert_id_or_pop_state();
-    int get_bins_per_state() const;
+    /*
+      Apply the effects of op to buffer, which must contain a copy of the
+      packed data of predecessor. This does not evaluate axioms.
+    */
+    void apply_effects(
+        const State &predecessor, const OperatorProxy &op,
+        PackedStateBin *buffer) const;
+    /*
+      Compute the unpacked values of the successor, including the derived
+      variables, and store them in buffer.
+    */
+    std::vector<int> compute_successor_values(
+        const State &predecessor, const OperatorProxy &op,
+        PackedStateBin *buffer);
 public:
     explicit StateRegistry(const TaskProxy &task_proxy);
 
@@ -215,6 +231,25 @@ public:
     State get_successor_state(
         const State &predecessor, const OperatorProxy &op);
 
+    /*
+      Writes the packed data of the state that results from applying op to
+      predecessor into buffer, which must have room for get_bins_per_state()
+      bins. In contrast to get_successor_state, the result is *not*
+      registered. This is useful if the caller first wants to decide whether
+      the state should be stored in this registry at all (e.g., when states
+      are distributed among several registries).
+    */
+    void compute_successor_data(
+        const State &predecessor, const OperatorProxy &op,
+        PackedStateBin *buffer);
+
+    /*
+      Returns the state with the given packed data and registers it if this
+      was not done before. The data must have been created with the state
+      packer of a task with the same variables as the task of this registry.
+    */
+    State insert_packed_state(const PackedStateBin *buffer);
+
     /*
       Returns the number of states registered so far.
     */
@@ -222,6 +257,7 @@ public:
         return registered_states.size();
     }
 
+    int get_bins_per_state() const;
     int get_state_size_in_bytes() const;
 
     void print_statistics(utils::LogProxy &log) const;
@@ -6,6 +6,7 @@
 #include "task_utils/causal_graph.h"
 #include "task_utils/task_properties.h"
 
+#include <atomic>
 #include <iostream>
 
 using namespace std;
@@ -44,6 +45,32 @@ State::State(const AbstractTask &task, vector<int> &&values)
     assert(num_variables == task.get_num_variables());
 }
 
+State::State(const AbstractTask &task, const State &ancestor_state)
+    : task(&task),
+      registry(nullptr),
+      id(StateID::no_state),
+      buffer(ancestor_state.buffer),
+      values(ancestor_state.values),
+      state_packer(ancestor_state.state_packer),
+      num_variables(ancestor_state.num_variables) {
+    assert(num_variables == task.get_num_variables());
+}
+
+/*
+  The counter is shared by all threads, e.g., in parallel search algorithms,
+  so we update it atomically. Relaxed ordering suffices because it is only
+  read for statistics.
+*/
+static atomic<long long> num_unpacked_states(0);
+
+void State::increase_num_unpacked_states() {
+    num_unpacked_states.fetch_add(1, memory_order_relaxed);
+}
+
+long long State::get_num_unpacked_states() {
+    return num_unpacked_states.load(memory_order_relaxed);
+}
+
 State State::get_unregistered_successor(const OperatorProxy &op) const {
     assert(!op.is_axiom());
     assert(task_properties::is_applicable(op, *this));
@@ -586,6 +586,8 @@ class State {
     mutable std::shared_ptr<std::vector<int>> values;
     const int_packer::IntPacker *state_packer;
     int num_variables;
+
+    static void increase_num_unpacked_states();
 public:
     using ItemType = FactProxy;
 
@@ -599,6 +601,13 @@ public:
         const PackedStateBin *buffer, std::vector<int> &&values);
     // Construct a state with only unpacked data.
     State(const AbstractTask &task, std::vector<int> &&values);
+    /*
+      Construct an unregistered state of the given task that shares the packed
+      and unpacked data of a state of an ancestor task. This is only valid if
+      the state values are the same in both tasks (see
+      AbstractTask::does_convert_ancestor_state_values).
+    */
+    State(const AbstractTask &task, const State &ancestor_state);
 
     bool operator==(const State &other) const;
     bool operator!=(const State &other) const;
@@ -629,6 +638,10 @@ public:
        not have them (unregistered states) is an error. */
     const PackedStateBin *get_buffer() const;
 
+    /* Return the packer that was used for the packed values of this state.
+       If the state has no packed values, return nullptr. */
+    const int_packer::IntPacker *get_state_packer() const;
+
     /*
       Create a successor state with the given operator. The operator is assumed
       to be applicable and the precondition is not checked. This will create an
@@ -638,6 +651,13 @@ public:
       unpack() to ensure the data exists.
     */
     State get_unregistered_successor(const OperatorProxy &op) const;
+
+    /*
+      Return how often the data of a state has been unpacked so far (summed
+      over all states and threads). Each call to unpack() on a state without
+      unpacked data counts once.
+    */
+    static long long get_num_unpacked_states();
 };
 
 namespace utils {
@@ -722,6 +742,11 @@ public:
     */
     State convert_ancestor_state(const State &ancestor_state) const {
         TaskProxy ancestor_task_proxy = ancestor_state.get_task();
+        if (!task->does_convert_ancestor_state_values(
+                ancestor_task_proxy.task)) {
+            // Share the data of the ancestor state instead of unpacking it.
+            return State(*task, ancestor_state);
+        }
         // Create a copy of the state values for the new state.
         ancestor_state.unpack();
         std::vector<int> state_values = ancestor_state.get_unpacked_values();
@@ -768,9 +793,12 @@ inline bool State::operator==(const State &other) const {
         // Both states are registered and from the same registry.
         return id == other.id;
     } else {
-        // Both states are unregistered.
-        assert(values);
-        assert(other.values);
+        /*
+          Both states are unregistered. States that share the data of
+          ancestor states may only have packed data.
+        */
+        unpack();
+        other.unpack();
         return *values == *other.values;
     }
 }
@@ -797,6 +825,7 @@ inline void State::unpack() const {
         for (int var = 0; var < num_variables; ++var) {
             (*values)[var] = state_packer->get(buffer, var);
         }
+        increase_num_unpacked_states();
     }
 }
 
@@ -845,6 +874,10 @@ inline const PackedStateBin *State::get_buffer() const {
     return buffer;
 }
 
+inline const int_packer::IntPacker *State::get_state_packer() const {
+    return state_packer;
+}
+
 inline const std::vector<int> &State::get_unpacked_values() const {
     if (!values) {
         std::cerr << "Accessing the unpacked values of a state without "
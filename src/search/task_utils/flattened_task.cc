@@ -0,0 +1,63 @@
+#include "flattened_task.h"
+
+#include "../task_proxy.h"
+
+using namespace std;
+
+namespace flattened_task {
+static void add_facts(
+    const ConditionsProxy &facts, vector<FactPair> &entries,
+    vector<int> &offsets) {
+    for (FactProxy fact : facts)
+        entries.push_back(fact.get_pair());
+    offsets.push_back(entries.size());
+}
+
+FlattenedTask::FlattenedTask(const TaskProxy &task_proxy)
+    : num_operators(task_proxy.get_operators().size()),
+      conditional_effects(false),
+      initial_state_values(
+          task_proxy.get_initial_state().get_unpacked_values()) {
+    VariablesProxy variables = task_proxy.get_variables();
+    domain_sizes.reserve(variables.size());
+    fact_offsets.reserve(variables.size() + 1);
+    fact_offsets.push_back(0);
+    for (VariableProxy var : variables) {
+        domain_sizes.push_back(var.get_domain_size());
+        fact_offsets.push_back(fact_offsets.back() + var.get_domain_size());
+    }
+
+    OperatorsProxy operators = task_proxy.get_operators();
+    AxiomsProxy axioms = task_proxy.get_axioms();
+    int num_ops_and_axioms = operators.size() + axioms.size();
+    costs.reserve(num_ops_and_axioms);
+    precondition_offsets.reserve(num_ops_and_axioms + 1);
+    precondition_offsets.push_back(0);
+    effect_offsets.reserve(num_ops_and_axioms + 1);
+    effect_offsets.push_back(0);
+    effect_condition_offsets.push_back(0);
+    auto add_operator = [&](const OperatorProxy &op) {
+        costs.push_back(op.get_cost());
+        add_facts(op.get_preconditions(), preconditions, precondition_offsets);
+        for (EffectProxy effect : op.get_effects()) {
+            effects.push_back(effect.get_fact().get_pair());
+            EffectConditionsProxy conditions = effect.get_conditions();
+            if (!conditions.empty())
+                conditional_effects = true;
+            add_facts(conditions, effect_conditions, effect_condition_offsets);
+        }
+        effect_offsets.push_back(effects.size());
+    };
+    for (OperatorProxy op : operators)
+        add_operator(op);
+    for (OperatorProxy axiom : axioms)
+        add_operator(axiom);
+
+    GoalsProxy goal_facts = task_proxy.get_goals();
+    goals.reserve(goal_facts.size());
+    for (FactProxy goal : goal_facts)
+        goals.push_back(goal.get_pair());
+}
+
+PerTaskInformation<FlattenedTask> g_flattened_tasks;
+}
@@ -0,0 +1,119 @@
+#ifndef TASK_UTILS_FLATTENED_TASK_H
+#define TASK_UTILS_FLATTENED_TASK_H
+
+#include "../abstract_task.h"
+#include "../per_task_information.h"
+
+#include <span>
+#include <vector>
+
+class TaskProxy;
+
+namespace flattened_task {
+/*
+  Immutable copy of the variables, operators, axioms, goals and initial
+  state of a task in contiguous arrays. Accessing the task through
+  TaskProxy costs a virtual call into AbstractTask for every fact (and
+  more for tasks that delegate to other tasks, e.g., CostAdaptedTask).
+  Components that iterate over all operators, possibly many times, can
+  instead get the flattened task once (see g_flattened_tasks) and read
+  it without virtual calls.
+
+  Operators and axioms are numbered consecutively: operator i has index
+  i and axiom i has index get_num_operators() + i. The preconditions,
+  effects and effect conditions are stored in compressed sparse row
+  format, in the same order as in the task. Facts are numbered
+  consecutively, ordered by variable and value.
+*/
+class FlattenedTask {
+    std::vector<int> domain_sizes;
+    // fact_offsets[var] is the number of the first fact of var.
+    std::vector<int> fact_offsets;
+
+    int num_operators;
+    std::vector<int> costs;
+    std::vector<int> precondition_offsets;
+    std::vector<FactPair> preconditions;
+    std::vector<int> effect_offsets;
+    std::vector<FactPair> effects;
+    // Indexed by the position of the effect in effects.
+    std::vector<int> effect_condition_offsets;
+    std::vector<FactPair> effect_conditions;
+    bool conditional_effects;
+
+    std::vector<FactPair> goals;
+    std::vector<int> initial_state_values;
+
+    template<typename T>
+    static std::span<const T> get_range(
+        const std::vector<int> &offsets, const std::vector<T> &entries,
+        int index) {
+        return std::span<const T>(
+            entries.data() + offsets[index],
+            entries.data() + offsets[index + 1]);
+    }
+public:
+    explicit FlattenedTask(const TaskProxy &task_proxy);
+
+    int get_num_variables() const {
+        return domain_sizes.size();
+    }
+    int get_domain_size(int var) const {
+        return domain_sizes[var];
+    }
+    const std::vector<int> &get_domain_sizes() const {
+        return domain_sizes;
+    }
+
+    int get_num_facts() const {
+        return fact_offsets.back();
+    }
+    int get_fact_index(const FactPair &fact) const {
+        return fact_offsets[fact.var] + fact.value;
+    }
+
+    int get_num_operators() const {
+        return num_operators;
+    }
+    int get_num_axioms() const {
+        return costs.size() - num_operators;
+    }
+    int get_axiom_index(int axiom_no) const {
+        return num_operators + axiom_no;
+    }
+    bool is_axiom(int index) const {
+        return index >= num_operators;
+    }
+
+    int get_cost(int index) const {
+        return costs[index];
+    }
+    std::span<const FactPair> get_preconditions(int index) const {
+        return get_range(precondition_offsets, preconditions, index);
+    }
+    std::span<const FactPair> get_effects(int index) const {
+        return get_range(effect_offsets, effects, index);
+    }
+    // Return the conditions of the effect with the given number.
+    std::span<const FactPair> get_effect_conditions(
+        int index, int eff_no) const {
+        return get_range(
+            effect_condition_offsets, effect_conditions,
+            effect_offsets[index] + eff_no);
+    }
+    bool has_conditional_effects() const {
+        return conditional_effects;
+    }
+
+    const std::vector<FactPair> &get_goals() const {
+        return goals;
+    }
+    const std::vector<int> &get_initial_state_values() const {
+        return initial_state_values;
+    }
+};
+
+extern PerTaskInformation<FlattenedTask> g_flattened_tasks;
+}
+
+#endif
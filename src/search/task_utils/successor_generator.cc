@@ -1,23 +1,63 @@
 #include "successor_generator.h"
 
+#include "successor_generator_bitset.h"
 #include "successor_generator_factory.h"
+#include "successor_generator_flat.h"
 #include "successor_generator_internals.h"
+#include "task_properties.h"
 
 #include "../abstract_task.h"
 
 using namespace std;
 
 namespace successor_generator {
+SuccessorGeneratorType g_successor_generator_type =
+    SuccessorGeneratorType::FLAT;
+
 SuccessorGenerator::SuccessorGenerator(const TaskProxy &task_proxy)
-    : root(SuccessorGeneratorFactory(task_proxy).create()) {
+    : SuccessorGenerator(task_proxy, g_successor_generator_type) {
+}
+
+SuccessorGenerator::SuccessorGenerator(
+    const TaskProxy &task_proxy, SuccessorGeneratorType type) {
+    if (type == SuccessorGeneratorType::FLAT) {
+        flat_generator = SuccessorGeneratorFactory(task_proxy).create_flat();
+    } else if (type == SuccessorGeneratorType::BITSET) {
+        bitset_generator = make_unique<BitsetGenerator>(
+            task_proxy, task_properties::g_state_packers[task_proxy]);
+    } else {
+        root = SuccessorGeneratorFactory(task_proxy).create();
+    }
 }
 
 SuccessorGenerator::~SuccessorGenerator() = default;
 
 void SuccessorGenerator::generate_applicable_ops(
     const State &state, vector<OperatorID> &applicable_ops) const {
-    state.unpack();
-    root->generate_applicable_ops(state.get_unpacked_values(), applicable_ops);
+    if (flat_generator) {
+        if (state.get_state_packer() == &flat_generator->get_state_packer()) {
+            flat_generator->generate_applicable_ops(
+                state.get_buffer(), applicable_ops);
+        } else {
+            state.unpack();
+            flat_generator->generate_applicable_ops(
+                state.get_unpacked_values(), applicable_ops);
+        }
+    } else if (bitset_generator) {
+        if (state.get_state_packer() ==
+            &bitset_generator->get_state_packer()) {
+            bitset_generator->generate_applicable_ops(
+                state.get_buffer(), applicable_ops);
+        } else {
+            state.unpack();
+            bitset_generator->generate_applicable_ops(
+                state.get_unpacked_values(), applicable_ops);
+        }
+    } else {
+        state.unpack();
+        root->generate_applicable_ops(
+            state.get_unpacked_values(), applicable_ops);
+    }
 }
 
 PerTaskInformation<SuccessorGenerator> g_successor_generators;
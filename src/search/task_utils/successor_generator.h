@@ -11,17 +11,40 @@ class State;
 class TaskProxy;
 
 namespace successor_generator {
+class BitsetGenerator;
+class FlatGenerator;
 class GeneratorBase;
 
+enum class SuccessorGeneratorType {
+    // Decision tree of polymorphic nodes (see successor_generator_internals).
+    TREE,
+    // The decision tree compiled into byte code (see FlatGenerator).
+    FLAT,
+    // Bit-parallel precondition matching (see BitsetGenerator).
+    BITSET
+};
+
+/*
+  Type of the successor generators created for new tasks. This is set from
+  the command line (option --successor-generator).
+*/
+extern SuccessorGeneratorType g_successor_generator_type;
+
 class SuccessorGenerator {
+    // Exactly one of the representations is used.
     std::unique_ptr<GeneratorBase> root;
+    std::unique_ptr<FlatGenerator> flat_generator;
+    std::unique_ptr<BitsetGenerator> bitset_generator;
 
 public:
+    // Use the type set with g_successor_generator_type.
     explicit SuccessorGenerator(const TaskProxy &task_proxy);
+    SuccessorGenerator(
+        const TaskProxy &task_proxy, SuccessorGeneratorType type);
     /*
       We cannot use the default destructor (implicitly or explicitly)
-      here because GeneratorBase is a forward declaration and the
-      incomplete type cannot be destroyed.
+      here because the generator classes are forward declarations and
+      the incomplete types cannot be destroyed.
     */
     ~SuccessorGenerator();
 
@@ -0,0 +1,203 @@
+#include "successor_generator_bitset.h"
+
+#include "../task_proxy.h"
+
+#include <algorithm>
+#include <cassert>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#define BITSET_GENERATOR_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+namespace successor_generator {
+using Word = BitsetGenerator::Word;
+static const int BLOCK_SIZE = BitsetGenerator::BLOCK_SIZE;
+static const int BITS_PER_WORD = 64;
+
+/*
+  The kernels compute violated[j] |= masks[i][j] & ~state[words[i]] for all
+  words i of a block and all operators j of the block. Operator j is
+  applicable iff violated[j] == 0 afterwards.
+*/
+static void match_block_scalar(
+    const Word *state_words, const int *block_words, int num_block_words,
+    const Word *masks, Word *violated) {
+    for (int i = 0; i < num_block_words; ++i) {
+        Word not_state = ~state_words[block_words[i]];
+        const Word *word_masks = masks + i * BLOCK_SIZE;
+        for (int j = 0; j < BLOCK_SIZE; ++j) {
+            violated[j] |= word_masks[j] & not_state;
+        }
+    }
+}
+
+#ifdef BITSET_GENERATOR_X86_KERNELS
+__attribute__((target("avx2"))) static void match_block_avx2(
+    const Word *state_words, const int *block_words, int num_block_words,
+    const Word *masks, Word *violated) {
+    const int num_lanes = 4;
+    const int num_vectors = BLOCK_SIZE / num_lanes;
+    __m256i acc[num_vectors];
+    for (int k = 0; k < num_vectors; ++k) {
+        acc[k] = _mm256_setzero_si256();
+    }
+    for (int i = 0; i < num_block_words; ++i) {
+        __m256i not_state = _mm256_set1_epi64x(
+            static_cast<long long>(~state_words[block_words[i]]));
+        const Word *word_masks = masks + i * BLOCK_SIZE;
+        for (int k = 0; k < num_vectors; ++k) {
+            __m256i mask = _mm256_loadu_si256(
+                reinterpret_cast<const __m256i *>(word_masks + k * num_lanes));
+            acc[k] = _mm256_or_si256(acc[k], _mm256_and_si256(mask, not_state));
+        }
+    }
+    for (int k = 0; k < num_vectors; ++k) {
+        _mm256_storeu_si256(
+            reinterpret_cast<__m256i *>(violated + k * num_lanes), acc[k]);
+    }
+}
+
+__attribute__((target("avx512f"))) static void match_block_avx512(
+    const Word *state_words, const int *block_words, int num_block_words,
+    const Word *masks, Word *violated) {
+    const int num_lanes = 8;
+    const int num_vectors = BLOCK_SIZE / num_lanes;
+    __m512i acc[num_vectors];
+    for (int k = 0; k < num_vectors; ++k) {
+        acc[k] = _mm512_setzero_si512();
+    }
+    for (int i = 0; i < num_block_words; ++i) {
+        __m512i not_state = _mm512_set1_epi64(
+            static_cast<long long>(~state_words[block_words[i]]));
+        const Word *word_masks = masks + i * BLOCK_SIZE;
+        for (int k = 0; k < num_vectors; ++k) {
+            __m512i mask = _mm512_loadu_si512(word_masks + k * num_lanes);
+            acc[k] = _mm512_or_si512(acc[k], _mm512_and_si512(mask, not_state));
+        }
+    }
+    for (int k = 0; k < num_vectors; ++k) {
+        _mm512_storeu_si512(violated + k * num_lanes, acc[k]);
+    }
+}
+#endif
+
+static BitsetGenerator::BlockKernel select_kernel() {
+#ifdef BITSET_GENERATOR_X86_KERNELS
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f"))
+        return match_block_avx512;
+    if (__builtin_cpu_supports("avx2"))
+        return match_block_avx2;
+#endif
+    return match_block_scalar;
+}
+
+BitsetGenerator::BitsetGenerator(
+    const TaskProxy &task_proxy, const int_packer::IntPacker &state_packer)
+    : num_operators(task_proxy.get_operators().size()),
+      kernel(select_kernel()),
+      state_packer(state_packer) {
+    VariablesProxy variables = task_proxy.get_variables();
+    int num_facts = 0;
+    fact_offsets.reserve(variables.size());
+    for (VariableProxy var : variables) {
+        fact_offsets.push_back(num_facts);
+        num_facts += var.get_domain_size();
+        variable_locations.push_back(state_packer.get_location(var.get_id()));
+    }
+    num_words = (num_facts + BITS_PER_WORD - 1) / BITS_PER_WORD;
+    state_words.resize(num_words);
+
+    OperatorsProxy operators = task_proxy.get_operators();
+    int num_blocks = (num_operators + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    blocks.resize(num_blocks);
+    for (int block_id = 0; block_id < num_blocks; ++block_id) {
+        Block &block = blocks[block_id];
+        int begin = block_id * BLOCK_SIZE;
+        int end = min(begin + BLOCK_SIZE, num_operators);
+
+        vector<vector<int>> fact_ids(end - begin);
+        for (int op_id = begin; op_id < end; ++op_id) {
+            for (FactProxy pre : operators[op_id].get_preconditions()) {
+                FactPair fact = pre.get_pair();
+                int fact_id = fact_offsets[fact.var] + fact.value;
+                fact_ids[op_id - begin].push_back(fact_id);
+                block.words.push_back(fact_id / BITS_PER_WORD);
+            }
+        }
+        sort(block.words.begin(), block.words.end());
+        block.words.erase(
+            unique(block.words.begin(), block.words.end()), block.words.end());
+
+        block.masks.assign(block.words.size() * BLOCK_SIZE, 0);
+        for (int j = 0; j < end - begin; ++j) {
+            for (int fact_id : fact_ids[j]) {
+                int word = fact_id / BITS_PER_WORD;
+                int pos = lower_bound(
+                              block.words.begin(), block.words.end(), word) -
+                          block.words.begin();
+                block.masks[pos * BLOCK_SIZE + j] |=
+                    Word(1) << (fact_id % BITS_PER_WORD);
+            }
+        }
+    }
+}
+
+void BitsetGenerator::generate_applicable_ops_for_state_words(
+    vector<OperatorID> &applicable_ops) const {
+    Word violated[BLOCK_SIZE];
+    for (size_t block_id = 0; block_id < blocks.size(); ++block_id) {
+        const Block &block = blocks[block_id];
+        fill(violated, violated + BLOCK_SIZE, 0);
+        kernel(
+            state_words.data(), block.words.data(), block.words.size(),
+            block.masks.data(), violated);
+        int begin = block_id * BLOCK_SIZE;
+        int end = min(begin + BLOCK_SIZE, num_operators);
+        for (int op_id = begin; op_id < end; ++op_id) {
+            if (!violated[op_id - begin])
+                applicable_ops.emplace_back(op_id);
+        }
+    }
+}
+
+void BitsetGenerator::generate_applicable_ops(
+    const vector<int> &state, vector<OperatorID> &applicable_ops) const {
+    fill(state_words.begin(), state_words.end(), 0);
+    for (size_t var = 0; var < fact_offsets.size(); ++var) {
+        int fact_id = fact_offsets[var] + state[var];
+        state_words[fact_id / BITS_PER_WORD] |= Word(1)
+                                                << (fact_id % BITS_PER_WORD);
+    }
+    generate_applicable_ops_for_state_words(applicable_ops);
+}
+
+void BitsetGenerator::generate_applicable_ops(
+    const int_packer::IntPacker::Bin *buffer,
+    vector<OperatorID> &applicable_ops) const {
+    fill(state_words.begin(), state_words.end(), 0);
+    for (size_t var = 0; var < fact_offsets.size(); ++var) {
+        const int_packer::IntPacker::VariableLocation &location =
+            variable_locations[var];
+        int value = (buffer[location.bin_index] & location.read_mask) >>
+                    location.shift;
+        int fact_id = fact_offsets[var] + value;
+        state_words[fact_id / BITS_PER_WORD] |= Word(1)
+                                                << (fact_id % BITS_PER_WORD);
+    }
+    generate_applicable_ops_for_state_words(applicable_ops);
+}
+
+const char *BitsetGenerator::get_kernel_name() const {
+#ifdef BITSET_GENERATOR_X86_KERNELS
+    if (kernel == match_block_avx512)
+        return "AVX-512";
+    if (kernel == match_block_avx2)
+        return "AVX2";
+#endif
+    return "scalar";
+}
+}
@@ -0,0 +1,99 @@
+#ifndef TASK_UTILS_SUCCESSOR_GENERATOR_BITSET_H
+#define TASK_UTILS_SUCCESSOR_GENERATOR_BITSET_H
+
+#include "../operator_id.h"
+
+#include "../algorithms/int_packer.h"
+
+#include <cstdint>
+#include <vector>
+
+class TaskProxy;
+
+namespace successor_generator {
+/*
+  BitsetGenerator tests the applicability of all operators with bit-parallel
+  precondition matching instead of walking a decision tree.
+
+  States are encoded as bitsets with one bit per fact, and every operator has
+  a precondition mask with one bit per precondition fact. An operator is
+  applicable iff its mask has no bit that is not set in the state, i.e.,
+  (mask & ~state) == 0 for all words of the bitsets.
+
+  Operators are grouped into blocks of BLOCK_SIZE operators. For each block,
+  we only store the masks of the words in which at least one of its
+  operators has a precondition, stored word by word so that the masks of all
+  operators of the block are contiguous for each word. Checking a block is
+  then a sequence of wide AND-NOT/OR operations over the operators of the
+  block. If the CPU supports AVX-512 or AVX2, these are computed with the
+  respective instructions, and otherwise with a scalar loop.
+
+  This representation works well for tasks with many operators that share
+  few preconditions, where the decision tree degenerates into large forks.
+
+  Note that applicable operators are reported in the order of their IDs,
+  which differs from the order of the decision tree. Search algorithms that
+  break ties by generation order can therefore behave differently with this
+  representation.
+*/
+class BitsetGenerator {
+public:
+    static constexpr int BLOCK_SIZE = 64;
+
+    using Word = std::uint64_t;
+    using BlockKernel = void (*)(
+        const Word *state_words, const int *block_words, int num_block_words,
+        const Word *masks, Word *violated);
+private:
+    struct Block {
+        // Words in which at least one operator of the block has a
+        // precondition.
+        std::vector<int> words;
+        // masks[i * BLOCK_SIZE + j] is the mask of operator j of the block
+        // for the word words[i].
+        std::vector<Word> masks;
+    };
+
+    int num_operators;
+    int num_words;
+    std::vector<int> fact_offsets;
+    std::vector<Block> blocks;
+    BlockKernel kernel;
+
+    const int_packer::IntPacker &state_packer;
+    std::vector<int_packer::IntPacker::VariableLocation> variable_locations;
+
+    /*
+      Bitset of the current state, reused between calls to avoid
+      allocations. Hence, a generator must not be used by several threads
+      at the same time.
+    */
+    mutable std::vector<Word> state_words;
+
+    void generate_applicable_ops_for_state_words(
+        std::vector<OperatorID> &applicable_ops) const;
+public:
+    BitsetGenerator(
+        const TaskProxy &task_proxy, const int_packer::IntPacker &state_packer);
+
+    void generate_applicable_ops(
+        const std::vector<int> &state,
+        std::vector<OperatorID> &applicable_ops) const;
+    /*
+      The buffer must contain the packed data of a state packed with the
+      state packer that was passed to the constructor.
+    */
+    void generate_applicable_ops(
+        const int_packer::IntPacker::Bin *buffer,
+        std::vector<OperatorID> &applicable_ops) const;
+
+    const int_packer::IntPacker &get_state_packer() const {
+        return state_packer;
+    }
+
+    // Return the name of the instruction set used for matching.
+    const char *get_kernel_name() const;
+};
+}
+
+#endif
@@ -1,6 +1,8 @@
 #include "successor_generator_factory.h"
 
+#include "successor_generator_flat.h"
 #include "successor_generator_internals.h"
+#include "task_properties.h"
 
 #include "../task_proxy.h"
 
@@ -288,4 +290,11 @@ GeneratorPtr SuccessorGeneratorFactory::create() {
     operator_infos.clear();
     return root;
 }
+
+unique_ptr<FlatGenerator> SuccessorGeneratorFactory::create_flat() {
+    GeneratorPtr tree = create();
+    return make_unique<FlatGenerator>(
+        *tree, task_properties::g_state_packers[task_proxy],
+        task_proxy.get_variables().size());
+}
 }
@@ -7,6 +7,7 @@
 class TaskProxy;
 
 namespace successor_generator {
+class FlatGenerator;
 class GeneratorBase;
 
 using GeneratorPtr = std::unique_ptr<GeneratorBase>;
@@ -30,6 +31,8 @@ public:
     // Destructor cannot be implicit because OperatorInfo is forward-declared.
     ~SuccessorGeneratorFactory();
     GeneratorPtr create();
+    // Build the tree and compile it into a FlatGenerator.
+    std::unique_ptr<FlatGenerator> create_flat();
 };
 }
 
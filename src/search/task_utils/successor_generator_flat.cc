@@ -0,0 +1,101 @@
+#include "successor_generator_flat.h"
+
+#include "successor_generator_internals.h"
+
+#include <algorithm>
+#include <cassert>
+
+using namespace std;
+
+namespace successor_generator {
+FlatGenerator::FlatGenerator(
+    const GeneratorBase &tree, const int_packer::IntPacker &state_packer,
+    int num_variables)
+    : state_packer(state_packer) {
+    root = tree.compile(code);
+    code.shrink_to_fit();
+    variable_locations.reserve(num_variables);
+    for (int var = 0; var < num_variables; ++var) {
+        variable_locations.push_back(state_packer.get_location(var));
+    }
+}
+
+template<typename ValueReader>
+void FlatGenerator::generate_applicable_ops(
+    int node, const ValueReader &read_value,
+    vector<OperatorID> &applicable_ops) const {
+    /*
+      Switches only have a single child to visit, so we follow them
+      iteratively. Only forks need recursion.
+    */
+    while (true) {
+        const int *data = &code[node];
+        switch (data[0]) {
+        case FORK: {
+            int num_children = data[1];
+            for (int i = 0; i < num_children; ++i) {
+                generate_applicable_ops(
+                    data[2 + i], read_value, applicable_ops);
+            }
+            return;
+        }
+        case SWITCH_VECTOR: {
+            int value = read_value(data[1]);
+            assert(value < data[2]);
+            node = data[3 + value];
+            if (node == NO_CHILD)
+                return;
+            break;
+        }
+        case SWITCH_SORTED: {
+            int value = read_value(data[1]);
+            int num_values = data[2];
+            const int *values_begin = data + 3;
+            const int *values_end = values_begin + num_values;
+            const int *pos = lower_bound(values_begin, values_end, value);
+            if (pos == values_end || *pos != value)
+                return;
+            node = values_end[pos - values_begin];
+            break;
+        }
+        case SWITCH_SINGLE: {
+            if (read_value(data[1]) != data[2])
+                return;
+            node = data[3];
+            break;
+        }
+        case LEAF: {
+            int num_operators = data[1];
+            for (int i = 0; i < num_operators; ++i) {
+                applicable_ops.emplace_back(data[2 + i]);
+            }
+            return;
+        }
+        default:
+            assert(false);
+            return;
+        }
+    }
+}
+
+void FlatGenerator::generate_applicable_ops(
+    const vector<int> &state, vector<OperatorID> &applicable_ops) const {
+    generate_applicable_ops(
+        root, [&state](int var) { return state[var]; }, applicable_ops);
+}
+
+void FlatGenerator::generate_applicable_ops(
+    const int_packer::IntPacker::Bin *buffer,
+    vector<OperatorID> &applicable_ops) const {
+    generate_applicable_ops(
+        root,
+        [this, buffer](int var) {
+            const int_packer::IntPacker::VariableLocation &location =
+                variable_locations[var];
+            return static_cast<int>(
+                (buffer[location.bin_index] & location.read_mask) >>
+                location.shift);
+        },
+        applicable_ops);
+}
+}
@@ -0,0 +1,86 @@
+#ifndef TASK_UTILS_SUCCESSOR_GENERATOR_FLAT_H
+#define TASK_UTILS_SUCCESSOR_GENERATOR_FLAT_H
+
+#include "../operator_id.h"
+
+#include "../algorithms/int_packer.h"
+
+#include <vector>
+
+namespace successor_generator {
+class GeneratorBase;
+
+/*
+  Opcodes of the nodes of a FlatGenerator. Every node starts with its opcode
+  and refers to its children by their positions in the code vector:
+
+  - fork:          [FORK, n, child_1, ..., child_n]
+  - vector switch: [SWITCH_VECTOR, var, k, child_0, ..., child_{k-1}]
+                   where k is the domain size of var and child_i is NO_CHILD
+                   if no operator requires var = i
+  - sorted switch: [SWITCH_SORTED, var, k, value_1, ..., value_k,
+                    child_1, ..., child_k] with value_1 < ... < value_k
+  - single switch: [SWITCH_SINGLE, var, value, child]
+  - leaf:          [LEAF, n, op_1, ..., op_n]
+*/
+enum FlatOpcode {
+    FORK,
+    SWITCH_VECTOR,
+    SWITCH_SORTED,
+    SWITCH_SINGLE,
+    LEAF
+};
+
+static const int NO_CHILD = -1;
+
+/*
+  FlatGenerator is a compiled form of the decision tree built by
+  SuccessorGeneratorFactory. All nodes are stored in a single vector of ints
+  ("byte code", see FlatOpcode for the layout), so walking the tree needs
+  neither virtual calls nor pointer chasing through separately allocated
+  nodes. Hash switches of the tree become sorted switches that are searched
+  with binary search.
+
+  The generator can read the values of variables directly from the packed
+  data of states stored with the state packer of the task. For this, it
+  stores the location of each variable in the packed data and inlines the
+  accesses that IntPacker::get would otherwise perform.
+*/
+class FlatGenerator {
+    std::vector<int> code;
+    int root;
+
+    const int_packer::IntPacker &state_packer;
+    std::vector<int_packer::IntPacker::VariableLocation> variable_locations;
+
+    template<typename ValueReader>
+    void generate_applicable_ops(
+        int node, const ValueReader &read_value,
+        std::vector<OperatorID> &applicable_ops) const;
+public:
+    FlatGenerator(
+        const GeneratorBase &tree, const int_packer::IntPacker &state_packer,
+        int num_variables);
+
+    void generate_applicable_ops(
+        const std::vector<int> &state,
+        std::vector<OperatorID> &applicable_ops) const;
+    /*
+      The buffer must contain the packed data of a state packed with the
+      state packer that was passed to the constructor.
+    */
+    void generate_applicable_ops(
+        const int_packer::IntPacker::Bin *buffer,
+        std::vector<OperatorID> &applicable_ops) const;
+
+    const int_packer::IntPacker &get_state_packer() const {
+        return state_packer;
+    }
+
+    int get_code_size() const {
+        return code.size();
+    }
+};
+}
+
+#endif
@@ -1,7 +1,10 @@
 #include "successor_generator_internals.h"
 
+#include "successor_generator_flat.h"
+
 #include "../task_proxy.h"
 
+#include <algorithm>
 #include <cassert>
 
 using namespace std;
@@ -57,6 +60,9 @@ using namespace std;
     nodes, which could be used in the case where k equals the domain
     size of the variable in question.)
 
+    FlatGenerator (see successor_generator_flat.h) implements a variant
+    of this representation that is compiled from the tree built here.
+
   - More modestly, we could stick with the current polymorphic code,
     but just use more types of nodes, such as switch nodes that stores
     a vector of (value, child) pairs to be scanned linearly or with
@@ -84,6 +90,14 @@ void GeneratorForkBinary::generate_applicable_ops(
     generator2->generate_applicable_ops(state, applicable_ops);
 }
 
+int GeneratorForkBinary::compile(vector<int> &code) const {
+    int child1 = generator1->compile(code);
+    int child2 = generator2->compile(code);
+    int node = code.size();
+    code.insert(code.end(), {FORK, 2, child1, child2});
+    return node;
+}
+
 GeneratorForkMulti::GeneratorForkMulti(
     vector<unique_ptr<GeneratorBase>> children)
     : children(move(children)) {
@@ -100,6 +114,18 @@ void GeneratorForkMulti::generate_applicable_ops(
         generator->generate_applicable_ops(state, applicable_ops);
 }
 
+int GeneratorForkMulti::compile(vector<int> &code) const {
+    vector<int> child_nodes;
+    child_nodes.reserve(children.size());
+    for (const auto &generator : children)
+        child_nodes.push_back(generator->compile(code));
+    int node = code.size();
+    code.push_back(FORK);
+    code.push_back(child_nodes.size());
+    code.insert(code.end(), child_nodes.begin(), child_nodes.end());
+    return node;
+}
+
 GeneratorSwitchVector::GeneratorSwitchVector(
     int switch_var_id, vector<unique_ptr<GeneratorBase>> &&generator_for_value)
     : switch_var_id(switch_var_id),
@@ -116,6 +142,19 @@ void GeneratorSwitchVector::generate_applicable_ops(
     }
 }
 
+int GeneratorSwitchVector::compile(vector<int> &code) const {
+    vector<int> child_nodes;
+    child_nodes.reserve(generator_for_value.size());
+    for (const auto &generator : generator_for_value)
+        child_nodes.push_back(generator ? generator->compile(code) : NO_CHILD);
+    int node = code.size();
+    code.insert(
+        code.end(), {SWITCH_VECTOR, switch_var_id,
+                     static_cast<int>(child_nodes.size())});
+    code.insert(code.end(), child_nodes.begin(), child_nodes.end());
+    return node;
+}
+
 GeneratorSwitchHash::GeneratorSwitchHash(
     int switch_var_id,
     unordered_map<int, unique_ptr<GeneratorBase>> &&generator_for_value)
@@ -133,6 +172,27 @@ void GeneratorSwitchHash::generate_applicable_ops(
     }
 }
 
+int GeneratorSwitchHash::compile(vector<int> &code) const {
+    vector<pair<int, const GeneratorBase *>> children;
+    children.reserve(generator_for_value.size());
+    for (const auto &item : generator_for_value)
+        children.emplace_back(item.first, item.second.get());
+    sort(children.begin(), children.end());
+
+    vector<int> child_nodes;
+    child_nodes.reserve(children.size());
+    for (const auto &child : children)
+        child_nodes.push_back(child.second->compile(code));
+    int node = code.size();
+    code.insert(
+        code.end(),
+        {SWITCH_SORTED, switch_var_id, static_cast<int>(children.size())});
+    for (const auto &child : children)
+        code.push_back(child.first);
+    code.insert(code.end(), child_nodes.begin(), child_nodes.end());
+    return node;
+}
+
 GeneratorSwitchSingle::GeneratorSwitchSingle(
     int switch_var_id, int value, unique_ptr<GeneratorBase> generator_for_value)
     : switch_var_id(switch_var_id),
@@ -147,6 +207,13 @@ void GeneratorSwitchSingle::generate_applicable_ops(
     }
 }
 
+int GeneratorSwitchSingle::compile(vector<int> &code) const {
+    int child = generator_for_value->compile(code);
+    int node = code.size();
+    code.insert(code.end(), {SWITCH_SINGLE, switch_var_id, value, child});
+    return node;
+}
+
 GeneratorLeafVector::GeneratorLeafVector(
     vector<OperatorID> &&applicable_operators)
     : applicable_operators(move(applicable_operators)) {
@@ -166,6 +233,15 @@ void GeneratorLeafVector::generate_applicable_ops(
     }
 }
 
+int GeneratorLeafVector::compile(vector<int> &code) const {
+    int node = code.size();
+    code.push_back(LEAF);
+    code.push_back(applicable_operators.size());
+    for (OperatorID id : applicable_operators)
+        code.push_back(id.get_index());
+    return node;
+}
+
 GeneratorLeafSingle::GeneratorLeafSingle(OperatorID applicable_operator)
     : applicable_operator(applicable_operator) {
 }
@@ -174,4 +250,10 @@ void GeneratorLeafSingle::generate_applicable_ops(
     const vector<int> &, vector<OperatorID> &applicable_ops) const {
     applicable_ops.push_back(applicable_operator);
 }
+
+int GeneratorLeafSingle::compile(vector<int> &code) const {
+    int node = code.size();
+    code.insert(code.end(), {LEAF, 1, applicable_operator.get_index()});
+    return node;
+}
 }
@@ -18,6 +18,13 @@ public:
     virtual void generate_applicable_ops(
         const std::vector<int> &state,
         std::vector<OperatorID> &applicable_ops) const = 0;
+
+    /*
+      Append the flat representation of the subtree rooted at this node to
+      code (see FlatGenerator) and return the position of this node.
+      Children are appended before their parents.
+    */
+    virtual int compile(std::vector<int> &code) const = 0;
 };
 
 class GeneratorForkBinary : public GeneratorBase {
@@ -30,6 +37,7 @@ public:
     virtual void generate_applicable_ops(
         const std::vector<int> &state,
         std::vector<OperatorID> &applicable_ops) const override;
+    virtual int compile(std::vector<int> &code) const override;
 };
 
 class GeneratorForkMulti : public GeneratorBase {
@@ -39,6 +47,7 @@ public:
     virtual void generate_applicable_ops(
         const std::vector<int> &state,
         std::vector<OperatorID> &applicable_ops) const override;
+    virtual int compile(std::vector<int> &code) const override;
 };
 
 class GeneratorSwitchVector : public GeneratorBase {
@@ -51,6 +60,7 @@ public:
     virtual void generate_applicable_ops(
         const std::vector<int> &state,
         std::vector<OperatorID> &applicable_ops) const override;
+    virtual int compile(std::vector<int> &code) const override;
 };
 
 class GeneratorSwitchHash : public GeneratorBase {
@@ -64,6 +74,7 @@ public:
     virtual void generate_applicable_ops(
         const std::vector<int> &state,
         std::vector<OperatorID> &applicable_ops) const override;
+    virtual int compile(std::vector<int> &code) const override;
 };
 
 class GeneratorSwitchSingle : public GeneratorBase {
@@ -77,6 +88,7 @@ public:
     virtual void generate_applicable_ops(
         const std::vector<int> &state,
         std::vector<OperatorID> &applicable_ops) const override;
+    virtual int compile(std::vector<int> &code) const override;
 };
 
 class GeneratorLeafVector : public GeneratorBase {
@@ -86,6 +98,7 @@ public:
     virtual void generate_applicable_ops(
         const std::vector<int> &state,
         std::vector<OperatorID> &applicable_ops) const override;
+    virtual int compile(std::vector<int> &code) const override;
 };
 
 class GeneratorLeafSingle : public GeneratorBase {
@@ -95,6 +108,7 @@ public:
     virtual void generate_applicable_ops(
         const std::vector<int> &state,
         std::vector<OperatorID> &applicable_ops) const override;
+    virtual int compile(std::vector<int> &code) const override;
 };
 }
 
@@ -64,6 +64,15 @@ public:
         const AbstractTask *ancestor_task) const final override;
     virtual void convert_state_values_from_parent(std::vector<int> &) const {
     }
+    virtual bool does_convert_ancestor_state_values(
+        const AbstractTask *ancestor_task) const final override;
+    /*
+      Subclasses that override convert_state_values_from_parent must also
+      override this method to return true.
+    */
+    virtual bool does_convert_state_values_from_parent() const {
+        return false;
+    }
 };
 }
 
@@ -57,6 +57,9 @@ public:
     virtual std::vector<int> get_initial_state_values() const override;
     virtual void convert_state_values_from_parent(
         std::vector<int> &values) const override;
+    virtual bool does_convert_state_values_from_parent() const override {
+        return true;
+    }
 };
 }
 
@@ -101,6 +101,8 @@ public:
     virtual vector<int> get_initial_state_values() const override;
     virtual void convert_ancestor_state_values(
         vector<int> &values, const AbstractTask *ancestor_task) const override;
+    virtual bool does_convert_ancestor_state_values(
+        const AbstractTask *ancestor_task) const override;
 };
 
 class TaskParser {
@@ -877,6 +879,14 @@ void RootTask::convert_ancestor_state_values(
     }
 }
 
+bool RootTask::does_convert_ancestor_state_values(
+    const AbstractTask *ancestor_task) const {
+    if (this != ancestor_task) {
+        ABORT("Invalid state conversion");
+    }
+    return false;
+}
+
 void read_root_task(istream &in) {
     assert(!g_root_task);
     utils::TaskLexer lexer(in);
@@ -89,6 +89,24 @@ std::vector<T> sorted(Collection &&collection) {
     return vec;
 }
 
+/*
+  Concatenate the given vectors into a single vector (compressed sparse
+  row format). The entries of vectors[i] are stored in
+  entries[offsets[i]] to entries[offsets[i + 1] - 1].
+*/
+template<typename T>
+void flatten_vectors(
+    const std::vector<std::vector<T>> &vectors, std::vector<int> &offsets,
+    std::vector<T> &entries) {
+    assert(offsets.empty() && entries.empty());
+    offsets.reserve(vectors.size() + 1);
+    offsets.push_back(0);
+    for (const std::vector<T> &vec : vectors) {
+        entries.insert(entries.end(), vec.begin(), vec.end());
+        offsets.push_back(entries.size());
+    }
+}
+
 template<typename T>
 int estimate_vector_bytes(int num_elements) {
     /*
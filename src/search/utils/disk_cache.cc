@@ -0,0 +1,136 @@
+#include "disk_cache.h"
+
+#include "system.h"
+
+#include <atomic>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+
+#if OPERATING_SYSTEM == LINUX || OPERATING_SYSTEM == OSX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace utils {
+string g_cache_directory;
+int64_t g_cache_size_limit = int64_t(1) << 32;
+
+bool fits_into_cache(int64_t num_bytes) {
+    error_code error;
+    int64_t total_size = num_bytes;
+    for (const filesystem::directory_entry &entry :
+         filesystem::directory_iterator(g_cache_directory, error)) {
+        if (entry.is_regular_file(error)) {
+            uintmax_t size = entry.file_size(error);
+            if (!error) {
+                total_size += size;
+            }
+        }
+    }
+    return !error && total_size <= g_cache_size_limit;
+}
+
+MappedFile::MappedFile(
+    const uint64_t *words, size_t num_words, bool is_mapped)
+    : words(words), num_words(num_words), is_mapped(is_mapped) {
+}
+
+static unique_ptr<vector<uint64_t>> read_file(const string &path) {
+    ifstream file(path, ios::binary | ios::ate);
+    if (!file) {
+        return nullptr;
+    }
+    streamoff size = file.tellg();
+    if (size <= 0 || size % sizeof(uint64_t) != 0) {
+        return nullptr;
+    }
+    auto words = make_unique<vector<uint64_t>>(size / sizeof(uint64_t));
+    file.seekg(0);
+    if (!file.read(reinterpret_cast<char *>(words->data()), size)) {
+        return nullptr;
+    }
+    return words;
+}
+
+unique_ptr<MappedFile> MappedFile::read(const string &path) {
+    unique_ptr<vector<uint64_t>> buffer = read_file(path);
+    if (!buffer) {
+        return nullptr;
+    }
+    unique_ptr<MappedFile> file(
+        new MappedFile(buffer->data(), buffer->size(), false));
+    // Moving the vector keeps its storage, so words stays valid.
+    file->buffer = move(*buffer);
+    return file;
+}
+
+#if OPERATING_SYSTEM == LINUX || OPERATING_SYSTEM == OSX
+/*
+  Mappings take whole pages, so we read smaller files into memory instead.
+*/
+static const off_t MIN_MAPPED_FILE_SIZE = 1 << 16;
+
+MappedFile::~MappedFile() {
+    if (is_mapped) {
+        munmap(const_cast<uint64_t *>(words), num_words * sizeof(uint64_t));
+    }
+}
+
+unique_ptr<MappedFile> MappedFile::open(const string &path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd == -1) {
+        return nullptr;
+    }
+    struct stat file_status;
+    if (fstat(fd, &file_status) == -1 ||
+        file_status.st_size < MIN_MAPPED_FILE_SIZE ||
+        file_status.st_size % sizeof(uint64_t) != 0) {
+        close(fd);
+        return read(path);
+    }
+    size_t size = file_status.st_size;
+    void *data = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    // The mapping stays valid after closing the file.
+    close(fd);
+    if (data == MAP_FAILED) {
+        return nullptr;
+    }
+    return unique_ptr<MappedFile>(new MappedFile(
+        static_cast<const uint64_t *>(data), size / sizeof(uint64_t), true));
+}
+#else
+MappedFile::~MappedFile() {
+}
+
+unique_ptr<MappedFile> MappedFile::open(const string &path) {
+    return read(path);
+}
+#endif
+
+bool write_file_atomically(const string &path, const vector<uint64_t> &words) {
+    static atomic<int> num_temporary_files(0);
+    string temporary_path = path + ".tmp." + to_string(get_process_id()) +
+                            "." + to_string(num_temporary_files++);
+    {
+        ofstream file(temporary_path, ios::binary);
+        file.write(
+            reinterpret_cast<const char *>(words.data()),
+            words.size() * sizeof(uint64_t));
+        if (!file.flush()) {
+            file.close();
+            remove(temporary_path.c_str());
+            return false;
+        }
+    }
+    if (rename(temporary_path.c_str(), path.c_str()) != 0) {
+        remove(temporary_path.c_str());
+        return false;
+    }
+    return true;
+}
+}
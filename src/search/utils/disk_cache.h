@@ -0,0 +1,72 @@
+#ifndef UTILS_DISK_CACHE_H
+#define UTILS_DISK_CACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace utils {
+/*
+  Directory in which components may cache precomputed data, e.g., pattern
+  databases, between planner runs. This is set from the command line
+  (option --cache-directory). An empty string disables caching.
+*/
+extern std::string g_cache_directory;
+
+/*
+  Maximum total size of the files in g_cache_directory in bytes (option
+  --cache-size-limit). Components do not add files once the limit is
+  reached. Since concurrent runs check the limit independently, it can be
+  exceeded by the files they write at the same time.
+*/
+extern int64_t g_cache_size_limit;
+
+/*
+  Return true if a file of the given size can be added to the cache
+  directory without exceeding g_cache_size_limit.
+*/
+extern bool fits_into_cache(int64_t num_bytes);
+
+/*
+  Read-only view of a file of 64-bit words. On Unix systems, large files
+  are mapped into memory, so processes that open the same file share its
+  pages. Other files are read into memory.
+*/
+class MappedFile {
+    const uint64_t *words;
+    std::size_t num_words;
+    bool is_mapped;
+    // Only used if the file is not mapped.
+    std::vector<uint64_t> buffer;
+
+    MappedFile(const uint64_t *words, std::size_t num_words, bool is_mapped);
+    static std::unique_ptr<MappedFile> read(const std::string &path);
+public:
+    ~MappedFile();
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    // Return nullptr if the file cannot be opened.
+    static std::unique_ptr<MappedFile> open(const std::string &path);
+
+    const uint64_t *get_words() const {
+        return words;
+    }
+
+    std::size_t get_num_words() const {
+        return num_words;
+    }
+};
+
+/*
+  Write the words to a temporary file and rename it to path afterwards, so
+  that concurrent readers never see partially written files. Return false
+  if writing fails.
+*/
+extern bool write_file_atomically(
+    const std::string &path, const std::vector<uint64_t> &words);
+}
+
+#endif
@@ -0,0 +1,21 @@
+#include "parallel.h"
+
+namespace utils {
+int g_num_preprocessing_threads = 1;
+bool g_parallel_pdb_distances = false;
+
+static thread_local bool in_parallel_region = false;
+
+bool is_in_parallel_region() {
+    return in_parallel_region;
+}
+
+ParallelRegion::ParallelRegion()
+    : was_in_parallel_region(in_parallel_region) {
+    in_parallel_region = true;
+}
+
+ParallelRegion::~ParallelRegion() {
+    in_parallel_region = was_in_parallel_region;
+}
+}
@@ -0,0 +1,111 @@
+#ifndef UTILS_PARALLEL_H
+#define UTILS_PARALLEL_H
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <thread>
+#include <vector>
+
+namespace utils {
+/*
+  Number of threads that components may use for precomputations, e.g.,
+  for computing the distances of large PDBs. This is set from the command
+  line (option --preprocessing-threads). Components must produce the same
+  results for every number of threads.
+*/
+extern int g_num_preprocessing_threads;
+
+/*
+  If true, the distances of a single large PDB are computed with
+  g_num_preprocessing_threads threads (option --parallel-pdb-distances).
+  This is off by default because no speed-up over the sequential
+  computation has been measured yet. Without it, the threads are only
+  used for independent computations, e.g., for different PDBs.
+*/
+extern bool g_parallel_pdb_distances;
+
+/*
+  Return true if the calling thread runs inside run_in_parallel. Code
+  that may be called from such a thread uses this to avoid starting
+  nested threads.
+*/
+extern bool is_in_parallel_region();
+
+// Marks the calling thread as being in a parallel region while it exists.
+class ParallelRegion {
+    bool was_in_parallel_region;
+public:
+    ParallelRegion();
+    ~ParallelRegion();
+};
+
+/*
+  Run work(thread_id) for thread_id = 0, ..., num_threads - 1 on
+  num_threads threads, including the calling thread (thread_id = 0), and
+  wait until all of them are done. If work throws an exception (e.g., in
+  utils::exit_with), the exception of the thread with the lowest ID is
+  rethrown on the calling thread once all threads are done. Work that
+  synchronizes the threads must let the other threads finish if one of
+  them throws.
+*/
+template<typename Work>
+void run_in_parallel(int num_threads, const Work &work) {
+    std::vector<std::exception_ptr> exceptions(num_threads);
+    auto run_work = [&work, &exceptions](int thread_id) {
+        ParallelRegion region;
+        try {
+            work(thread_id);
+        } catch (...) {
+            exceptions[thread_id] = std::current_exception();
+        }
+    };
+    std::vector<std::thread> threads;
+    threads.reserve(num_threads - 1);
+    for (int i = 1; i < num_threads; ++i) {
+        threads.emplace_back(run_work, i);
+    }
+    run_work(0);
+    for (std::thread &worker_thread : threads) {
+        worker_thread.join();
+    }
+    for (const std::exception_ptr &exception : exceptions) {
+        if (exception) {
+            std::rethrow_exception(exception);
+        }
+    }
+}
+
+/*
+  Call func(i) for i = 0, ..., num_items - 1. The calls are distributed
+  over g_num_preprocessing_threads threads, so func must be safe to call
+  concurrently, and the order of the calls is unspecified. Inside a
+  parallel region, the calls happen sequentially on the calling thread.
+  If a call throws an exception, no further calls are started, and the
+  exception is rethrown as in run_in_parallel.
+*/
+template<typename Func>
+void parallel_for(int num_items, const Func &func) {
+    int num_threads = std::min(g_num_preprocessing_threads, num_items);
+    if (num_threads <= 1 || is_in_parallel_region()) {
+        for (int i = 0; i < num_items; ++i) {
+            func(i);
+        }
+        return;
+    }
+    std::atomic<int> next_item(0);
+    run_in_parallel(num_threads, [&](int) {
+        for (int i = next_item++; i < num_items; i = next_item++) {
+            try {
+                func(i);
+            } catch (...) {
+                // Let the other threads stop after their current item.
+                next_item = num_items;
+                throw;
+            }
+        }
+    });
+}
+}
+
+#endif